@@ -0,0 +1,554 @@
+/**
+ * @file   ai.c
+ * @brief  Implementation of the computer opponent for the Battleship game.
+ *
+ * This file contains the computer's side of a single player game. It keeps
+ * its own record of the shots it fired at our board and which of them hit,
+ * it never reads where our ships are except through our answer to a shot,
+ * just as a second player over IR would. It answers our shots from its own
+ * board, which it commits to and reveals like a second player.
+ *
+ * The density map is built in the packed row layout of board.h. For a ship
+ * of length n, the cells a placement across a row can start on are the open
+ * cells of the row and'ed with the row shifted 1 to n - 1 columns, and the
+ * cells a placement down can start on are the open cells of n rows and'ed
+ * together, so every placement of a ship is found with a few operations per
+ * row instead of a loop over every cell.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "ai.h"
+#include "board.h"
+#include "predefined_boards.h"
+#include "screen.h"
+#include "scheduler.h"
+#include "game.h"
+#include "timer.h"
+#include "input_trace.h"
+#include "commit.h"
+
+/** @brief Lengths of the ships the computer searches for. */
+static const uint8_t AI_FLEET_LENGTHS[AI_FLEET_NUM] = AI_FLEET;
+
+/** @brief State of the search building the density map, holding the shots the computer fired at our board. */
+static AiSearch_t ai_search;
+
+/** @brief Ticks left to wait before firing once the map is built. */
+static uint16_t ai_wait;
+
+/** @brief The predefined board ID the computer chose. */
+static uint8_t ai_board_id;
+
+/** @brief The computer's board, which answers our shots. */
+static Board_t ai_board;
+
+/** @brief The salt of the tag committing to the computer's board. */
+static CommitSalt_t ai_salt;
+
+/** @brief The tag committing to the computer's board. */
+static CommitTag_t ai_tag;
+
+/** @brief Whether the computer's tag is waiting to be read. */
+static bool ai_tag_ready;
+
+/** @brief Whether the computer's board ID is waiting to be read, once it has been revealed. */
+static bool ai_board_ready;
+
+/** @brief Whether the computer's salt is waiting to be read, once it has been revealed. */
+static bool ai_salt_ready;
+
+/** @brief The computer's answer to our last shot. */
+static BoardResponse_t ai_response;
+
+/** @brief Whether the computer's answer to our last shot is waiting to be read. */
+static bool ai_response_ready;
+
+/** @brief Row of the computer's last shot. */
+static uint8_t ai_shot_row;
+
+/** @brief Column of the computer's last shot. */
+static uint8_t ai_shot_col;
+
+/** @brief Whether the computer's last shot is waiting to be read. */
+static bool ai_shot_ready;
+
+/** @brief State of the generator choosing the computer's board and breaking ties. */
+static uint16_t ai_random_state = 1;
+
+/**
+ * @brief Generates the next pseudo random number with xorshift.
+ *
+ * @return The next number.
+ */
+static uint16_t ai_random(void)
+{
+    ai_random_state ^= ai_random_state << 7;
+    ai_random_state ^= ai_random_state >> 9;
+    ai_random_state ^= ai_random_state << 8;
+    return ai_random_state;
+}
+
+/**
+ * @brief Gets the cells of a row a ship could still be on, those which are not a miss.
+ *
+ * @param search The search.
+ * @param row The row index.
+ * @return The open cells as a packed row.
+ */
+static uint8_t ai_open_cells(const AiSearch_t* search, uint8_t row)
+{
+    return BOARD_ROW_MASK & ~(search->shots[row] & ~search->hits[row]);
+}
+
+/**
+ * @brief Gets the cells a ship placed across a row can start on.
+ *
+ * A placement starting on a cell covers it and the length - 1 cells to its
+ * right, so bit b of the row shifted left by k holds the cell k to the right
+ * of cell b. Placements which would run off the row shift in zeros.
+ *
+ * @param search The search.
+ * @param row The row index.
+ * @param length The length of the ship.
+ * @param through_hit true to only keep the placements which cover a hit.
+ * @return The start cells as a packed row.
+ */
+static uint8_t ai_across_starts(const AiSearch_t* search, uint8_t row, uint8_t length, bool through_hit)
+{
+    uint8_t open = ai_open_cells(search, row);
+    uint8_t starts = open;
+    uint8_t hit = search->hits[row];
+
+    for (uint8_t k = 1; k < length; k++)
+    {
+        starts &= open << k;
+        hit |= search->hits[row] << k;
+    }
+    return (through_hit ? starts & hit : starts) & BOARD_ROW_MASK;
+}
+
+/**
+ * @brief Gets the cells of a row a ship placed down the board can start on.
+ *
+ * @param search The search.
+ * @param row The row index, the ship covers it and the length - 1 rows below.
+ * @param length The length of the ship.
+ * @param through_hit true to only keep the placements which cover a hit.
+ * @return The start cells as a packed row.
+ */
+static uint8_t ai_down_starts(const AiSearch_t* search, uint8_t row, uint8_t length, bool through_hit)
+{
+    uint8_t starts = BOARD_ROW_MASK;
+    uint8_t hit = 0;
+
+    for (uint8_t k = 0; k < length; k++)
+    {
+        starts &= ai_open_cells(search, row + k);
+        hit |= search->hits[row + k];
+    }
+    return through_hit ? starts & hit : starts;
+}
+
+/**
+ * @brief Checks if any placement of the fleet through a hit covers a cell which has not been shot.
+ *
+ * @param search The search.
+ * @return true if the search should be targeting.
+ */
+static bool ai_can_target(const AiSearch_t* search)
+{
+    for (uint8_t ship = 0; ship < AI_FLEET_NUM; ship++)
+    {
+        uint8_t length = AI_FLEET_LENGTHS[ship];
+        for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+        {
+            uint8_t starts = ai_across_starts(search, row, length, true);
+            for (uint8_t k = 0; k < length; k++)
+            {
+                if ((starts >> k) & ~search->shots[row])
+                {
+                    return true;
+                }
+            }
+        }
+        for (uint8_t row = 0; row + length <= BOARD_ROWS_NUM; row++)
+        {
+            uint8_t starts = ai_down_starts(search, row, length, true);
+            for (uint8_t k = 0; k < length; k++)
+            {
+                if (starts & ~search->shots[row + k])
+                {
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Adds one to the count of every cell in a packed row.
+ *
+ * The planes are added to like a ripple carry adder, every cell of the row
+ * at once.
+ *
+ * @param search The search holding the density map.
+ * @param row The row index.
+ * @param cells The cells to add one to.
+ */
+static void ai_count_add(AiSearch_t* search, uint8_t row, uint8_t cells)
+{
+    for (uint8_t bit = 0; bit < AI_COUNT_BITS && cells; bit++)
+    {
+        uint8_t carry = search->counts[bit][row] & cells;
+        search->counts[bit][row] ^= cells;
+        cells = carry;
+    }
+}
+
+/**
+ * @brief Adds every placement of a ship to the density map.
+ *
+ * @param search The search holding the density map.
+ * @param length The length of the ship.
+ */
+static void ai_count_ship(AiSearch_t* search, uint8_t length)
+{
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        uint8_t starts = ai_across_starts(search, row, length, search->targeting);
+        for (uint8_t k = 0; k < length; k++)
+        {
+            ai_count_add(search, row, starts >> k);
+        }
+    }
+    for (uint8_t row = 0; row + length <= BOARD_ROWS_NUM; row++)
+    {
+        uint8_t starts = ai_down_starts(search, row, length, search->targeting);
+        for (uint8_t k = 0; k < length; k++)
+        {
+            ai_count_add(search, row + k, starts);
+        }
+    }
+}
+
+/**
+ * @brief Forgets every shot of a search, ready for a new game.
+ *
+ * @param search The search.
+ */
+void ai_search_reset(AiSearch_t* search)
+{
+    memset(search, 0, sizeof(*search));
+}
+
+/**
+ * @brief Runs one step of a search, it is the step function of the computer's scheduler job.
+ *
+ * The first step clears the map and chooses between targeting and hunting,
+ * each step after it counts one ship of AI_FLEET.
+ *
+ * @param state The AiSearch_t being built.
+ * @return true once every ship has been counted.
+ */
+bool ai_search_step(void* state)
+{
+    AiSearch_t* search = state;
+
+    if (search->step == 0)
+    {
+        memset(search->counts, 0, sizeof(search->counts));
+        search->targeting = ai_can_target(search);
+    }
+    else
+    {
+        ai_count_ship(search, AI_FLEET_LENGTHS[search->step - 1]);
+    }
+    return ++search->step == AI_SEARCH_STEPS;
+}
+
+/** @brief The job running the search a slice at a time. */
+static SchedulerJob_t ai_job = {ai_search_step, &ai_search, AI_SEARCH_BUDGET, AI_SEARCH_STEPS, 0, SCHEDULER_JOB_IDLE};
+
+/**
+ * @brief Chooses the cell with the highest count which has not been shot.
+ *
+ * Starting from every cell not yet shot, each plane from the most significant
+ * down keeps only the cells with its bit set, unless none of them have it.
+ * The cells left all have the highest count, one of them is chosen by the
+ * random number.
+ *
+ * @param search The finished search.
+ * @param random A random number breaking ties.
+ * @param shot_row Pointer to store the row index of the chosen cell.
+ * @param shot_col Pointer to store the column index of the chosen cell.
+ */
+void ai_search_choose(const AiSearch_t* search, uint16_t random, uint8_t* shot_row, uint8_t* shot_col)
+{
+    PredefinedBoard_t busiest;
+    PredefinedBoard_t higher;
+    uint8_t cells = 0;
+
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        busiest[row] = BOARD_ROW_MASK & ~search->shots[row];
+    }
+    for (uint8_t bit = AI_COUNT_BITS; bit-- > 0;)
+    {
+        uint8_t any = 0;
+        for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+        {
+            higher[row] = busiest[row] & search->counts[bit][row];
+            any |= higher[row];
+        }
+        if (any)
+        {
+            memcpy(busiest, higher, sizeof(busiest));
+        }
+    }
+
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        {
+            cells += (busiest[row] & BOARD_COL_MASK(col)) != 0;
+        }
+    }
+    uint8_t pick = cells ? random % cells : 0;
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        {
+            if ((busiest[row] & BOARD_COL_MASK(col)) && pick-- == 0)
+            {
+                *shot_row = row;
+                *shot_col = col;
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Records the result of a shot, the search then starts again from its first step.
+ *
+ * @param search The search.
+ * @param row The row index of the cell shot.
+ * @param col The column index of the cell shot.
+ * @param response The result of the shot.
+ */
+void ai_search_record(AiSearch_t* search, uint8_t row, uint8_t col, BoardResponse_t response)
+{
+    search->shots[row] |= BOARD_COL_MASK(col);
+    if (response == HIT || response == WINNER)
+    {
+        search->hits[row] |= BOARD_COL_MASK(col);
+    }
+    search->step = 0;
+}
+
+/**
+ * @brief Forgets the last game and stops the computer.
+ *
+ * The random generator is kept, so the next game plays differently.
+ */
+void ai_init(void)
+{
+    ai_search_reset(&ai_search);
+    ai_tag_ready = false;
+    ai_board_ready = false;
+    ai_salt_ready = false;
+    ai_response_ready = false;
+    ai_shot_ready = false;
+    if (ai_job.status == SCHEDULER_JOB_RUNNING)
+    {
+        scheduler_job_cancel();
+    }
+    scheduler_task_enable(GAME_TASK_AI, false);
+}
+
+/**
+ * @brief Fires the computer's shot once its search has finished.
+ *
+ * This is run every tick by the scheduler while it is the computer's turn.
+ * Once the search job has finished, our result has scrolled past and
+ * AI_REPLY_TICKS more have passed, the shot is chosen and the task disables
+ * itself. We answer the shot from our board, see ai_send_our_turn_state().
+ */
+void ai_update(void)
+{
+    if (ai_job.status != SCHEDULER_JOB_FINISHED || screen_scrolling_message_active())
+    {
+        return;
+    }
+    if (ai_wait > 0)
+    {
+        ai_wait--;
+        return;
+    }
+
+    scheduler_task_enable(GAME_TASK_AI, false);
+    ai_search_choose(&ai_search, ai_random(), &ai_shot_row, &ai_shot_col);
+    ai_shot_ready = true;
+}
+
+/**
+ * @brief Retrieves the tag committing to the computer's board.
+ *
+ * @param tag Pointer to store the tag.
+ * @return true if the computer has chosen since the last call, false otherwise.
+ */
+bool ai_get_their_commitment(CommitTag_t* tag)
+{
+    if (!ai_tag_ready)
+    {
+        return false;
+    }
+    memcpy(*tag, ai_tag, COMMIT_TAG_BYTES);
+    ai_tag_ready = false;
+    return true;
+}
+
+/**
+ * @brief Tells the computer our board has been chosen, it then chooses and commits to its own.
+ *
+ * The board is chosen at random, leaving out the test board. The timer read
+ * depends on how long the player took to choose, so it seeds the generator.
+ *
+ * @param tag The tag committing to our board, which the computer ignores.
+ */
+void ai_send_our_commitment(const CommitTag_t* tag)
+{
+    (void) tag;
+    uint8_t boards = predefined_board_count();
+    PredefinedBoard_t layout;
+
+    // replay needs the same timer read to choose the same board
+    ai_random_state ^= input_trace_timer(timer_get());
+    if (ai_random_state == 0)
+    {
+        ai_random_state = 1;
+    }
+    ai_board_id = boards > 1 ? 1 + ai_random() % (boards - 1) : 0;
+    predefined_board_read(ai_board_id, &layout);
+    board_init(&ai_board, &layout);
+    commit_salt_choose(&ai_salt);
+    commit_hash(&layout, &ai_salt, &ai_tag);
+    ai_tag_ready = true;
+}
+
+/**
+ * @brief Retrieves the salt of the computer's board, once it has been revealed.
+ *
+ * @param salt Pointer to store the salt.
+ * @return true if the computer has revealed its board since the last call, false otherwise.
+ */
+bool ai_get_their_salt(CommitSalt_t* salt)
+{
+    if (!ai_salt_ready)
+    {
+        return false;
+    }
+    memcpy(*salt, ai_salt, COMMIT_SALT_BYTES);
+    ai_salt_ready = false;
+    return true;
+}
+
+/**
+ * @brief Tells the computer our salt, it then reveals its own board.
+ *
+ * @param salt The salt of our board, which the computer ignores.
+ */
+void ai_send_our_salt(const CommitSalt_t* salt)
+{
+    (void) salt;
+    ai_board_ready = true;
+    ai_salt_ready = true;
+}
+
+/**
+ * @brief Retrieves the predefined board ID the computer chose, once it has been revealed.
+ *
+ * @param id Pointer to store the board ID.
+ * @return true if the computer has revealed its board since the last call, false otherwise.
+ */
+bool ai_get_their_predefined_board_id(uint8_t* id)
+{
+    if (!ai_board_ready)
+    {
+        return false;
+    }
+    *id = ai_board_id;
+    ai_board_ready = false;
+    return true;
+}
+
+/**
+ * @brief Retrieves the cell of the computer's shot at our board.
+ *
+ * @param row Pointer to store the row index of the cell.
+ * @param col Pointer to store the column index of the cell.
+ * @return true if the computer has fired since the last call, false otherwise.
+ */
+bool ai_get_their_shot(uint8_t* row, uint8_t* col)
+{
+    if (!ai_shot_ready)
+    {
+        return false;
+    }
+    *row = ai_shot_row;
+    *col = ai_shot_col;
+    ai_shot_ready = false;
+    return true;
+}
+
+/**
+ * @brief Fires our shot at the computer's board, it then takes its turn unless we won.
+ *
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ */
+void ai_send_our_shot(uint8_t row, uint8_t col)
+{
+    ai_response = board_answer_shot(&ai_board, row, col);
+    ai_response_ready = true;
+    if (ai_response == WINNER)
+    {
+        return;
+    }
+    scheduler_job_start(&ai_job);
+    ai_wait = AI_REPLY_TICKS;
+    scheduler_task_enable(GAME_TASK_AI, true);
+}
+
+/**
+ * @brief Retrieves the computer's answer to our shot.
+ *
+ * @param response Pointer to store the answer.
+ * @return true if the computer has answered since the last call, false otherwise.
+ */
+bool ai_get_their_turn_state(BoardResponse_t* response)
+{
+    if (!ai_response_ready)
+    {
+        return false;
+    }
+    *response = ai_response;
+    ai_response_ready = false;
+    return true;
+}
+
+/**
+ * @brief Tells the computer our answer to its shot, which its search records.
+ *
+ * @param response Our answer to the computer's shot.
+ */
+void ai_send_our_turn_state(BoardResponse_t response)
+{
+    ai_search_record(&ai_search, ai_shot_row, ai_shot_col, response);
+}
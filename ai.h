@@ -0,0 +1,185 @@
+/**
+ * @file   ai.h
+ * @brief  Header of the computer opponent for the Battleship game.
+ *
+ * The computer plays the other side of a single player game behind the same
+ * interface as the IR link, see opponent.h. It picks one of the predefined
+ * boards, answers our shots from it and fires back at our board.
+ *
+ * The search choosing its shots keeps all of its state in an AiSearch_t, so
+ * host tools can run many searches at once with the ai_search_* functions.
+ *
+ * Each shot is chosen from a density map: for every ship in AI_FLEET, the
+ * number of its placements covering each cell which do not cross a miss.
+ * While a placement through one of its hits still covers a cell it has not
+ * shot, the computer is targeting and only counts those placements, otherwise
+ * it is hunting and counts all of them. The busiest cell not yet shot is fired
+ * at, ties are broken at random.
+ *
+ * The counts are kept as AI_COUNT_BITS bit planes in the PredefinedBoard_t
+ * packed row layout, so the placements of a ship are added to every cell of a
+ * row at once. The map is built by a scheduler job, see scheduler.h, which
+ * counts one ship per step.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef AI_H
+#define AI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+#include "fleet_layout.h"
+#include "commit.h"
+
+/**
+ * @brief Lengths of the ships the computer searches for, those on predefined boards 1 to 5.
+ */
+#define AI_FLEET FLEET_LENGTHS
+
+/**
+ * @brief Number of ships in AI_FLEET.
+ */
+#define AI_FLEET_NUM FLEET_SHIPS_NUM
+
+/**
+ * @brief Bit planes of each density count, enough for every placement of AI_FLEET through one cell.
+ *
+ * A ship of length n has at most n placements across and n down through a
+ * cell, so AI_FLEET counts at most 2 * (3 + 3 + 2 + 2 + 2) = 24.
+ */
+#define AI_COUNT_BITS 5
+
+/**
+ * @brief Steps of the search building the density map, choosing the mode then counting each ship.
+ */
+#define AI_SEARCH_STEPS (1 + AI_FLEET_NUM)
+
+/**
+ * @brief Timer counts the search may run for each tick, about 0.5 ms.
+ */
+#define AI_SEARCH_BUDGET 4
+
+/**
+ * @brief Ticks the computer waits before firing once our result has scrolled past.
+ */
+#define AI_REPLY_TICKS 250
+
+/**
+ * @struct AiSearch_t
+ * @brief  State of the search building the density map, kept between its steps.
+ */
+typedef struct
+{
+    PredefinedBoard_t shots;                 /**< Cells which have been fired at. */
+    PredefinedBoard_t hits;                  /**< Cells which have been hit. */
+    PredefinedBoard_t counts[AI_COUNT_BITS]; /**< The density map, bit n of each cell's count is in plane n. */
+    bool targeting;                          /**< Whether only the placements through a hit are counted. */
+    uint8_t step;                            /**< The next step to run. */
+} AiSearch_t;
+
+/**
+ * @brief Forgets every shot of a search, ready for a new game.
+ * @param search The search.
+ */
+void ai_search_reset(AiSearch_t* search);
+
+/**
+ * @brief Runs one step of a search, AI_SEARCH_STEPS steps build the density map.
+ * @param state The AiSearch_t being built.
+ * @return true once the map is built.
+ */
+bool ai_search_step(void* state);
+
+/**
+ * @brief Chooses the cell with the highest count in a built map which has not been shot.
+ * @param search The search, every step of which has run.
+ * @param random A random number breaking ties.
+ * @param shot_row Pointer to store the row index of the chosen cell.
+ * @param shot_col Pointer to store the column index of the chosen cell.
+ */
+void ai_search_choose(const AiSearch_t* search, uint16_t random, uint8_t* shot_row, uint8_t* shot_col);
+
+/**
+ * @brief Records the result of a shot, the search then starts again from its first step.
+ * @param search The search.
+ * @param row The row index of the cell shot.
+ * @param col The column index of the cell shot.
+ * @param response The result of the shot.
+ */
+void ai_search_record(AiSearch_t* search, uint8_t row, uint8_t col, BoardResponse_t response);
+
+/**
+ * @brief Forgets the last game and stops the computer, called when an opponent is selected.
+ */
+void ai_init(void);
+
+/**
+ * @brief Chooses the computer's shot once its search has finished, run every tick by the scheduler while it is its turn.
+ */
+void ai_update(void);
+
+/**
+ * @brief Retrieves the tag committing to the computer's board.
+ * @param tag Pointer to store the tag.
+ * @return true once the computer has chosen, after it received our tag.
+ */
+bool ai_get_their_commitment(CommitTag_t* tag);
+
+/**
+ * @brief Tells the computer our board has been chosen, it then chooses and commits to its own.
+ * @param tag The tag committing to our board, the computer does not look at our board.
+ */
+void ai_send_our_commitment(const CommitTag_t* tag);
+
+/**
+ * @brief Retrieves the salt of the computer's board.
+ * @param salt Pointer to store the salt.
+ * @return true once the computer has revealed its board, after it received our salt.
+ */
+bool ai_get_their_salt(CommitSalt_t* salt);
+
+/**
+ * @brief Tells the computer the game has ended and our salt, it then reveals its board.
+ * @param salt The salt of our board, which the computer does not check.
+ */
+void ai_send_our_salt(const CommitSalt_t* salt);
+
+/**
+ * @brief Retrieves the predefined board ID the computer chose.
+ * @param id Pointer to store the board ID.
+ * @return true once the computer has revealed its board, after it received our salt.
+ */
+bool ai_get_their_predefined_board_id(uint8_t* id);
+
+/**
+ * @brief Retrieves the cell of the computer's shot at our board.
+ * @param row Pointer to store the row index of the cell.
+ * @param col Pointer to store the column index of the cell.
+ * @return true if the computer has fired since the last call, false otherwise.
+ */
+bool ai_get_their_shot(uint8_t* row, uint8_t* col);
+
+/**
+ * @brief Fires our shot at the computer's board, it then takes its turn unless we won.
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ */
+void ai_send_our_shot(uint8_t row, uint8_t col);
+
+/**
+ * @brief Retrieves the computer's answer to our shot.
+ * @param response Pointer to store the answer, WINNER when we sank its last ship.
+ * @return true if the computer has answered since the last call, false otherwise.
+ */
+bool ai_get_their_turn_state(BoardResponse_t* response);
+
+/**
+ * @brief Tells the computer our answer to its shot.
+ * @param response Our answer, WINNER when it sank our last ship.
+ */
+void ai_send_our_turn_state(BoardResponse_t response);
+
+#endif /* AI_H */
@@ -0,0 +1,84 @@
+/** 
+ * @file   bench.h
+ * @brief  Markers used to measure the game under the simavr benchmark.
+ *
+ * When the game is built with BENCH defined (make bench) the markers write
+ * to the general purpose I/O registers, which the benchmark harness in bench/
+ * watches to timestamp each marker in CPU cycles:
+ *
+ * - GPIOR0 receives a BenchPoint_t when a point begins, or'ed with
+ *   BENCH_END_FLAG when it ends.
+ * - GPIOR1 receives the GameState_t whenever the game state changes.
+ * - GPIOR2 is written by the harness with BENCH_INPUT_* bits to inject
+ *   button and navigation switch pushes, which the game takes and clears.
+ *
+ * In every other build the markers compile to nothing.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @enum  BenchPoint_t
+ * @brief The code paths measured by the benchmark.
+ */
+typedef enum
+{
+    BENCH_TICK,              /**< All the work done in one pacer tick. */
+    BENCH_SCREEN_UPDATE,     /**< screen_update(), refreshing the LED matrix through tinygl. */
+    BENCH_SHOW_CURSOR,       /**< update_showing_cursor(). */
+    BENCH_NAVIGATION_SWITCH, /**< navigation_switch_get(). */
+    BENCH_CHECK_SHOT,        /**< board_answer_shot(), answering their shot from our board. */
+    BENCH_IR_UPDATE,         /**< ir_update(), running the IR link. */
+    BENCH_SCROLLING_MESSAGE, /**< screen_scrolling_message_update(). */
+    BENCH_GAME_STATE,        /**< The handler of the current game state. */
+    BENCH_DEBUG_DISPLAY,     /**< update_debug_display(). */
+    BENCH_INPUT_TRACE,       /**< input_trace_update(). */
+    BENCH_AI,                /**< ai_update(), the computer's turn. */
+    BENCH_JOB,               /**< A slice of the scheduler's running job. */
+    BENCH_COMMIT,            /**< commit_hash(), hashing a board into its commitment tag. */
+    BENCH_POINTS_NUM,        /**< Number of benchmark points, not a point itself. */
+} BenchPoint_t;
+
+#define BENCH_END_FLAG 0x80 // Set in a marker written when a point ends
+
+#define BENCH_INPUT_NORTH  (1 << 0) // Inject a push of the navigation switch north
+#define BENCH_INPUT_EAST   (1 << 1) // Inject a push of the navigation switch east
+#define BENCH_INPUT_SOUTH  (1 << 2) // Inject a push of the navigation switch south
+#define BENCH_INPUT_WEST   (1 << 3) // Inject a push of the navigation switch west
+#define BENCH_INPUT_PUSH   (1 << 4) // Inject a push down of the navigation switch
+#define BENCH_INPUT_BUTTON (1 << 7) // Inject a push of the button
+
+#ifdef BENCH
+#include <avr/io.h>
+
+/**
+ * @brief  Takes injected input, clearing it so it is only seen once.
+ * @param  mask: The BENCH_INPUT_* bits to take.
+ * @return true if any of the bits were injected.
+ */
+static inline bool bench_input_take(uint8_t mask)
+{
+    uint8_t pending = GPIOR2 & mask;
+    GPIOR2 &= ~mask;
+    return pending;
+}
+
+#define BENCH_BEGIN(point) (GPIOR0 = (point))
+#define BENCH_END(point) (GPIOR0 = (point) | BENCH_END_FLAG)
+#define BENCH_STATE(state) (GPIOR1 = (state))
+#define BENCH_INPUT_TAKE(mask) bench_input_take(mask)
+#else
+#define BENCH_BEGIN(point)
+#define BENCH_END(point)
+#define BENCH_STATE(state)
+#define BENCH_INPUT_TAKE(mask) false
+#endif /* BENCH */
+
+#endif /* BENCH_H */
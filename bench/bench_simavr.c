@@ -0,0 +1,737 @@
+/**
+ * @file   bench_simavr.c
+ * @brief  Cycle benchmark of the game's per tick code paths under simavr.
+ *
+ * This program runs the real game ELF built with BENCH defined (see bench.h)
+ * under the simavr AVR simulator. It watches the benchmark markers the game
+ * writes to GPIOR0/GPIOR1 and records the number of calls, mean and worst case
+ * cycles of every BenchPoint_t in every GameState_t.
+ *
+ * To move the game through all of its states the harness plays the part of
+ * both the player and the opponent: it injects button and navigation switch
+ * pushes through GPIOR2 and answers the game's IR frames over USART1. The
+ * run ends once the game has checked the board the opponent revealed, so
+ * commit_hash() is measured both committing to our board and checking theirs.
+ *
+ * With -r, an input trace (see input_trace.h) is loaded into the simulated
+ * EEPROM. A game built with make bench INPUT_TRACE=replay then replays it in
+ * place of the harness's input, so builds can be compared on the same game.
+ *
+ * With -c, the computer opponent is chosen instead of answering over IR, so
+ * the cycles it takes to choose each shot are measured too.
+ *
+ * With -g, the random board is chosen instead of board 0, so the cycles it
+ * takes to generate a board are measured too.
+ *
+ * The program exits with a non zero status when any measured call takes
+ * longer than the cycle budget of one pacer tick.
+ *
+ * Usage: bench_simavr [-m mcu] [-f frequency] [-b budget] [-s seconds] [-r trace] [-c] [-g] game_bench.out
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <simavr/sim_avr.h>
+#include <simavr/sim_elf.h>
+#include <simavr/avr_uart.h>
+#include <simavr/avr_eeprom.h>
+#include "bench.h"
+#include "game_state.h"
+#include "game.h"
+
+#define BENCH_GPIOR0 0x3E // Data space address of GPIOR0, the point markers
+#define BENCH_GPIOR1 0x4A // Data space address of GPIOR1, the game state
+#define BENCH_GPIOR2 0x4B // Data space address of GPIOR2, injected input
+
+#define BENCH_DEFAULT_MCU "atmega32u4"  // simavr has no ATmega32U2 core, the 32U4 shares its CPU, USART1 and GPIORs
+#define BENCH_DEFAULT_FREQUENCY 8000000 // Clock frequency of the UCFK4
+#define BENCH_DEFAULT_SECONDS 120       // Simulated seconds to run for if the game does not end
+#define BENCH_EEPROM_SIZE 1024          // Bytes of EEPROM on the ATmega32U2, the most of a trace loaded
+
+#define BENCH_STATES_NUM (GAME_STATE_END + 1) // Number of game states
+
+#define BENCH_COLS_NUM 5 // Number of columns on the board, the cursor moves in row major order
+
+#define BENCH_INPUT_GAP_TICKS 5     // Ticks between injected inputs, so each is seen on its own tick
+#define BENCH_REPLY_DELAY_TICKS 300 // Ticks the opponent takes to answer, so the game spends time waiting for it
+#define BENCH_ACK_DELAY_TICKS 1     // Ticks the opponent takes to acknowledge
+
+#define BENCH_FRAME_SYNC 0x7E       // Byte starting every frame sent over IR, see ir.h
+#define BENCH_FRAME_PAYLOAD_MAX 8   // Largest payload a frame carries, see ir.h
+#define BENCH_FRAME_OVERHEAD 6      // Bytes a frame adds around its payload, see ir.h
+#define BENCH_CRC_INIT 0xFFFF       // Value the CRC of every frame starts from, see ir.h
+#define BENCH_NONCE_FLIP 0x80       // Flipped in the game's session nonce to give the opponent a different one
+#define BENCH_FRAME_ACK 0           // IR_FRAME_ACK in IrFrameType_t
+#define BENCH_FRAME_BOARD_ID 1      // IR_FRAME_BOARD_ID in IrFrameType_t
+#define BENCH_FRAME_TURN_STATE 2    // IR_FRAME_TURN_STATE in IrFrameType_t
+#define BENCH_FRAME_BOARD_SEED 3    // IR_FRAME_BOARD_SEED in IrFrameType_t
+#define BENCH_FRAME_BOARD_CODE 4    // IR_FRAME_BOARD_CODE in IrFrameType_t
+#define BENCH_FRAME_COMMIT 5        // IR_FRAME_COMMIT in IrFrameType_t
+#define BENCH_FRAME_SHOT 6          // IR_FRAME_SHOT in IrFrameType_t
+#define BENCH_FRAME_SALT 7          // IR_FRAME_SALT in IrFrameType_t
+#define BENCH_COMMIT_BYTES 8        // Bytes of a tag or salt, see commit.h
+#define BENCH_RESPONSE_MISS 1       // MISS in BoardResponse_t
+#define BENCH_RESPONSE_HIT 2        // HIT in BoardResponse_t
+#define BENCH_RESPONSE_WINNER 3     // WINNER in BoardResponse_t
+#define BENCH_BOARD_ID 1            // The predefined board the opponent reveals
+#define BENCH_SHOT_CELL 0           // The cell the opponent always shoots, so it never wins
+
+#define BENCH_FRAME_SIZE (BENCH_FRAME_OVERHEAD + BENCH_FRAME_PAYLOAD_MAX) // Largest frame in bytes
+
+/**
+ * @struct BenchReply_t
+ * @brief  A frame the opponent sends once its tick is reached.
+ */
+typedef struct
+{
+    uint64_t tick;                   /**< Tick the frame is sent on, 0 when no frame is due. */
+    uint8_t bytes[BENCH_FRAME_SIZE]; /**< The encoded frame. */
+    uint8_t length;                  /**< Number of bytes in the frame. */
+} BenchReply_t;
+
+/**
+ * @enum  BenchReplySlot_t
+ * @brief The frames the opponent can have waiting to be sent.
+ */
+typedef enum {
+    BENCH_REPLY_ACK,   /**< Acknowledgement of the game's last frame. */
+    BENCH_REPLY_DATA,  /**< The opponent's answer to the game's last frame. */
+    BENCH_REPLY_SHOT,  /**< The opponent's shot, fired once it has answered the game's. */
+    BENCH_REPLIES_NUM, /**< Number of reply slots. */
+} BenchReplySlot_t;
+
+/**
+ * @struct BenchStats_t
+ * @brief  Cycle statistics of one benchmark point in one game state.
+ */
+typedef struct
+{
+    uint64_t calls;  /**< Number of measured calls. */
+    uint64_t total;  /**< Sum of the cycles of every call. */
+    uint64_t worst;  /**< Cycles of the longest call. */
+} BenchStats_t;
+
+/** @brief Names of the benchmark points, indexed by BenchPoint_t. */
+static const char* const POINT_NAMES[BENCH_POINTS_NUM] = {
+    "tick",
+    "screen_update",
+    "update_showing_cursor",
+    "navigation_switch_get",
+    "board_answer_shot",
+    "ir_update",
+    "screen_scrolling_message_update",
+    "game_state",
+    "update_debug_display",
+    "input_trace_update",
+    "ai_update",
+    "scheduler_job",
+    "commit_hash",
+};
+
+/** @brief Names of the game states, indexed by GameState_t. */
+static const char* const STATE_NAMES[BENCH_STATES_NUM] = {
+    "TITLE_SCREEN",
+    "SELECT_PLAYER",
+    "CHOOSE_BOARD",
+    "EDIT_BOARD",
+    "AWAIT_BOARD_EXCHANGE",
+    "SELECT_SHOOT_POSITION",
+    "AWAIT_SHOT_RESULT",
+    "THEIR_TURN",
+    "END",
+};
+
+/** @brief Statistics of every benchmark point in every game state. */
+static BenchStats_t stats[BENCH_STATES_NUM][BENCH_POINTS_NUM];
+
+/** @brief Cycle count when each benchmark point last began. */
+static avr_cycle_count_t point_begin[BENCH_POINTS_NUM];
+
+/** @brief The game state last written by the game. */
+static uint8_t game_state = GAME_STATE_TITLE_SCREEN;
+
+/** @brief Number of ticks the game has finished. */
+static uint64_t ticks = 0;
+
+/** @brief Tick at which the next input may be injected. */
+static uint64_t next_input_tick = 0;
+
+/** @brief The frames the opponent has waiting to be sent. */
+static BenchReply_t replies[BENCH_REPLIES_NUM];
+
+/** @brief Sequence number of the opponent's next frame. */
+static uint8_t reply_seq = 0;
+
+/** @brief The opponent's session nonce, chosen to differ from the game's. */
+static uint8_t reply_nonce = 0;
+
+/** @brief The bytes of the frame the game is sending. */
+static uint8_t frame[BENCH_FRAME_SIZE];
+
+/** @brief Number of bytes of the frame the game is sending received so far. */
+static uint8_t frame_length = 0;
+
+/** @brief Row of the game's shooting cursor, tracked from our own inputs. */
+static int8_t cursor_row = 3;
+
+/** @brief Column of the game's shooting cursor, tracked from our own inputs. */
+static int8_t cursor_col = 2;
+
+/** @brief Index of the next cell to shoot at, in row major order. */
+static uint8_t next_target = 0;
+
+/**
+ * @brief The opponent's board, predefined board BENCH_BOARD_ID, which it
+ * answers the game's shots from, see predefined_boards.c.
+ */
+static const uint8_t BENCH_BOARD[] = {0x06, 0x18, 0x01, 0x01, 0x1D, 0x00, 0x0C};
+
+/** @brief Ship cells of the opponent's board which the game has not hit. */
+static uint8_t bench_ships_remaining = 12;
+
+/** @brief Whether the game plays the computer opponent rather than the harness over IR. */
+static bool computer = false;
+
+/** @brief Whether the computer opponent has been chosen on the player select screen. */
+static bool computer_chosen = false;
+
+/** @brief Whether the game chooses the random board rather than board 0. */
+static bool random_board = false;
+
+/** @brief Whether the random board has been moved to on the board choice screen. */
+static bool random_board_shown = false;
+
+/** @brief The interrupt used to send bytes to the game's USART1. */
+static avr_irq_t* uart_input;
+
+/**
+ * @brief Records a benchmark marker written to GPIOR0.
+ *
+ * @param avr The simulated AVR.
+ * @param addr The address written.
+ * @param value The marker written.
+ * @param param Unused.
+ */
+static void bench_point_write(avr_t* avr, avr_io_addr_t addr, uint8_t value, void* param)
+{
+    (void) param;
+    avr->data[addr] = value;
+
+    uint8_t point = value & ~BENCH_END_FLAG;
+    if (point >= BENCH_POINTS_NUM || game_state >= BENCH_STATES_NUM)
+    {
+        return;
+    }
+
+    if (!(value & BENCH_END_FLAG))
+    {
+        point_begin[point] = avr->cycle;
+        return;
+    }
+
+    uint64_t cycles = avr->cycle - point_begin[point];
+    BenchStats_t* point_stats = &stats[game_state][point];
+    point_stats->calls++;
+    point_stats->total += cycles;
+    if (cycles > point_stats->worst)
+    {
+        point_stats->worst = cycles;
+    }
+
+    if (point == BENCH_TICK)
+    {
+        ticks++;
+    }
+}
+
+/**
+ * @brief Records a game state written to GPIOR1.
+ *
+ * @param avr The simulated AVR.
+ * @param addr The address written.
+ * @param value The game state written.
+ * @param param Unused.
+ */
+static void bench_state_write(avr_t* avr, avr_io_addr_t addr, uint8_t value, void* param)
+{
+    (void) param;
+    avr->data[addr] = value;
+    game_state = value;
+}
+
+/**
+ * @brief Adds a byte to a CRC-16/CCITT (polynomial 0x1021), the same as ir.c.
+ *
+ * @param crc The CRC of the bytes so far.
+ * @param data The byte to add.
+ * @return The CRC including the byte.
+ */
+static uint16_t bench_crc16_update(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t) data << 8;
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+        crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief Schedules a frame for the opponent to send.
+ *
+ * @param slot The reply slot to use, replacing any frame waiting in it.
+ * @param tick The tick to send the frame on.
+ * @param type The frame type.
+ * @param seq The frame's sequence number.
+ * @param payload The payload.
+ * @param length The number of payload bytes, 0 for acknowledgements.
+ */
+static void bench_reply(BenchReplySlot_t slot, uint64_t tick, uint8_t type, uint8_t seq,
+                        const uint8_t* payload, uint8_t length)
+{
+    BenchReply_t* reply = &replies[slot];
+
+    reply->bytes[0] = BENCH_FRAME_SYNC;
+    reply->bytes[1] = reply_nonce;
+    reply->bytes[2] = (uint8_t) ((type << 4) | (seq & 0x0F));
+    reply->bytes[3] = length;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        reply->bytes[4 + i] = payload[i];
+    }
+    uint16_t crc = BENCH_CRC_INIT;
+    for (uint8_t i = 1; i < 4 + length; i++)
+    {
+        crc = bench_crc16_update(crc, reply->bytes[i]);
+    }
+    reply->bytes[4 + length] = (uint8_t) (crc >> 8);
+    reply->bytes[5 + length] = (uint8_t) crc;
+    reply->length = BENCH_FRAME_OVERHEAD + length;
+    reply->tick = tick;
+}
+
+/**
+ * @brief Answers the game's shot from the opponent's board.
+ *
+ * @param cell The cell shot, its row times BENCH_COLS_NUM plus its column.
+ * @return The BoardResponse_t the opponent answers with.
+ */
+static uint8_t bench_answer_shot(uint8_t cell)
+{
+    static uint64_t shot = 0;
+    uint8_t row = cell / BENCH_COLS_NUM;
+    uint8_t mask = (uint8_t) (1 << (BENCH_COLS_NUM - 1 - cell % BENCH_COLS_NUM));
+
+    if (row >= sizeof(BENCH_BOARD) || !(BENCH_BOARD[row] & mask))
+    {
+        return BENCH_RESPONSE_MISS;
+    }
+    if (!(shot & (1ULL << cell)))
+    {
+        shot |= 1ULL << cell;
+        bench_ships_remaining--;
+    }
+    return bench_ships_remaining == 0 ? BENCH_RESPONSE_WINNER : BENCH_RESPONSE_HIT;
+}
+
+/**
+ * @brief Answers a frame sent by the game as the opponent would.
+ *
+ * Every frame is acknowledged on the next tick. A tag is answered with the
+ * opponent's tag straight after. A shot is answered from the opponent's board
+ * straight after, then unless the game won the opponent fires its own shot
+ * after its thinking time, always at BENCH_SHOT_CELL. Once the game ends, its
+ * salt is answered with the opponent's salt and its board with board
+ * BENCH_BOARD_ID. The opponent's tag is not the hash of its board, so the
+ * game shows a mismatch, but it hashes the board to find that out. A frame
+ * sent again because the acknowledgement was missed is only acknowledged. The
+ * opponent's frames carry the game's session nonce with one bit flipped, so
+ * the game never takes them for echoes.
+ *
+ * @param nonce The game's session nonce.
+ * @param type The frame type.
+ * @param seq The frame's sequence number.
+ * @param payload The frame's payload.
+ */
+static void bench_answer(uint8_t nonce, uint8_t type, uint8_t seq, const uint8_t* payload)
+{
+    static uint8_t last_seq = 0xFF;
+    static const uint8_t commitment[BENCH_COMMIT_BYTES] = {0};
+    uint8_t data;
+
+    reply_nonce = nonce ^ BENCH_NONCE_FLIP;
+    if (type == BENCH_FRAME_ACK)
+    {
+        return;
+    }
+    bench_reply(BENCH_REPLY_ACK, ticks + BENCH_ACK_DELAY_TICKS, BENCH_FRAME_ACK, seq, NULL, 0);
+    if (seq == last_seq)
+    {
+        return;
+    }
+    last_seq = seq;
+
+    switch (type)
+    {
+        case BENCH_FRAME_COMMIT:
+        case BENCH_FRAME_SALT:
+            bench_reply(BENCH_REPLY_DATA, ticks + 2 * BENCH_ACK_DELAY_TICKS, type, reply_seq++,
+                        commitment, BENCH_COMMIT_BYTES);
+            break;
+        case BENCH_FRAME_BOARD_ID:
+        case BENCH_FRAME_BOARD_SEED:
+        case BENCH_FRAME_BOARD_CODE:
+            data = BENCH_BOARD_ID;
+            bench_reply(BENCH_REPLY_DATA, ticks + 2 * BENCH_ACK_DELAY_TICKS, BENCH_FRAME_BOARD_ID, reply_seq++,
+                        &data, 1);
+            break;
+        case BENCH_FRAME_SHOT:
+            data = bench_answer_shot(payload[0]);
+            bench_reply(BENCH_REPLY_DATA, ticks + 2 * BENCH_ACK_DELAY_TICKS, BENCH_FRAME_TURN_STATE, reply_seq++,
+                        &data, 1);
+            if (data != BENCH_RESPONSE_WINNER)
+            {
+                data = BENCH_SHOT_CELL;
+                bench_reply(BENCH_REPLY_SHOT, ticks + BENCH_REPLY_DELAY_TICKS, BENCH_FRAME_SHOT, reply_seq++,
+                            &data, 1);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Collects the bytes the game sends over IR into frames.
+ *
+ * @param irq The USART1 output interrupt.
+ * @param value The byte sent by the game.
+ * @param param Unused.
+ */
+static void bench_uart_output(avr_irq_t* irq, uint32_t value, void* param)
+{
+    (void) irq;
+    (void) param;
+
+    if (frame_length == 0 && value != BENCH_FRAME_SYNC)
+    {
+        return;
+    }
+    frame[frame_length++] = (uint8_t) value;
+    if (frame_length < 4)
+    {
+        return;
+    }
+
+    uint8_t length = frame[3];
+    if (length > BENCH_FRAME_PAYLOAD_MAX)
+    {
+        frame_length = 0;
+        return;
+    }
+    if (frame_length < BENCH_FRAME_OVERHEAD + length)
+    {
+        return;
+    }
+
+    uint16_t crc = BENCH_CRC_INIT;
+    for (uint8_t i = 1; i < 4 + length; i++)
+    {
+        crc = bench_crc16_update(crc, frame[i]);
+    }
+    if (frame[4 + length] == (uint8_t) (crc >> 8) && frame[5 + length] == (uint8_t) crc)
+    {
+        bench_answer(frame[1], frame[2] >> 4, frame[2] & 0x0F, &frame[4]);
+    }
+    frame_length = 0;
+}
+
+/**
+ * @brief Injects input through GPIOR2 once the game has taken the last input.
+ *
+ * @param avr The simulated AVR.
+ * @param input The BENCH_INPUT_* bits to inject.
+ */
+static void bench_inject(avr_t* avr, uint8_t input)
+{
+    avr->data[BENCH_GPIOR2] = input;
+    next_input_tick = ticks + BENCH_INPUT_GAP_TICKS;
+}
+
+/**
+ * @brief Plays the player's part, choosing the input for the current game state.
+ *
+ * Player 1, or the computer opponent with -c, and board 0, or the random
+ * board with -g, are chosen, then
+ * every cell is shot in row major order by walking the cursor to it one push
+ * at a time.
+ *
+ * @param avr The simulated AVR.
+ */
+static void bench_play(avr_t* avr)
+{
+    for (uint8_t slot = 0; slot < BENCH_REPLIES_NUM; slot++)
+    {
+        BenchReply_t* reply = &replies[slot];
+        if (reply->tick != 0 && ticks >= reply->tick)
+        {
+            for (uint8_t i = 0; i < reply->length; i++)
+            {
+                avr_raise_irq(uart_input, reply->bytes[i]);
+            }
+            reply->tick = 0;
+        }
+    }
+
+    if (avr->data[BENCH_GPIOR2] != 0 || ticks < next_input_tick)
+    {
+        return;
+    }
+
+    switch (game_state)
+    {
+        case GAME_STATE_SELECT_PLAYER:
+            if (computer && !computer_chosen)
+            {
+                // the computer is the choice before player 1
+                computer_chosen = true;
+                bench_inject(avr, BENCH_INPUT_WEST);
+                break;
+            }
+            bench_inject(avr, BENCH_INPUT_BUTTON);
+            break;
+        case GAME_STATE_CHOOSE_BOARD:
+            if (random_board && !random_board_shown)
+            {
+                // the random board is the choice before board 0
+                random_board_shown = true;
+                bench_inject(avr, BENCH_INPUT_EAST);
+                break;
+            }
+            bench_inject(avr, BENCH_INPUT_BUTTON);
+            break;
+        case GAME_STATE_SELECT_SHOOT_POSITION: {
+            int8_t target_row = next_target / BENCH_COLS_NUM;
+            int8_t target_col = next_target % BENCH_COLS_NUM;
+            if (cursor_row < target_row)
+            {
+                cursor_row++;
+                bench_inject(avr, BENCH_INPUT_SOUTH);
+            }
+            else if (cursor_row > target_row)
+            {
+                cursor_row--;
+                bench_inject(avr, BENCH_INPUT_NORTH);
+            }
+            else if (cursor_col < target_col)
+            {
+                cursor_col++;
+                bench_inject(avr, BENCH_INPUT_EAST);
+            }
+            else if (cursor_col > target_col)
+            {
+                cursor_col--;
+                bench_inject(avr, BENCH_INPUT_WEST);
+            }
+            else
+            {
+                next_target++;
+                bench_inject(avr, BENCH_INPUT_PUSH);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Prints the statistics of every benchmark point which was measured.
+ *
+ * @param frequency The simulated clock frequency.
+ * @param budget The cycle budget of one tick.
+ * @return The number of benchmark points whose worst case is over budget.
+ */
+static int bench_report(uint32_t frequency, uint64_t budget)
+{
+    int over_budget = 0;
+
+    printf("%u Hz, %u ticks per second, budget %llu cycles per tick\n\n",
+           frequency, PACER_RATE, (unsigned long long) budget);
+    printf("%-22s %-33s %10s %10s %10s %7s\n", "state", "point", "calls", "mean", "worst", "budget");
+
+    for (uint8_t state = 0; state < BENCH_STATES_NUM; state++)
+    {
+        for (uint8_t point = 0; point < BENCH_POINTS_NUM; point++)
+        {
+            BenchStats_t* point_stats = &stats[state][point];
+            if (point_stats->calls == 0)
+            {
+                continue;
+            }
+            bool over = point_stats->worst > budget;
+            over_budget += over;
+            printf("%-22s %-33s %10llu %10.1f %10llu %6.1f%%%s\n",
+                   STATE_NAMES[state], POINT_NAMES[point],
+                   (unsigned long long) point_stats->calls,
+                   (double) point_stats->total / point_stats->calls,
+                   (unsigned long long) point_stats->worst,
+                   100.0 * point_stats->worst / budget,
+                   over ? " OVER" : "");
+        }
+    }
+    return over_budget;
+}
+
+/**
+ * @brief Loads an input trace into the simulated EEPROM, erasing the rest of it.
+ *
+ * @param avr The simulated AVR.
+ * @param path The trace.
+ * @return true if the trace was read.
+ */
+static bool bench_load_trace(avr_t* avr, const char* path)
+{
+    static uint8_t eeprom[BENCH_EEPROM_SIZE];
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    memset(eeprom, 0xFF, sizeof(eeprom));
+    size_t size = fread(eeprom, 1, sizeof(eeprom), file);
+    fclose(file);
+
+    avr_eeprom_desc_t desc = {.ee = eeprom, .offset = 0, .size = sizeof(eeprom)};
+    return size > 0 && avr_ioctl(avr, AVR_IOCTL_EEPROM_SET, &desc) == 0;
+}
+
+/**
+ * @brief Runs the benchmark.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv The command line arguments.
+ * @return 0 if every point stayed within budget, 1 if any went over, 2 on error.
+ */
+int main(int argc, char** argv)
+{
+    const char* mcu = BENCH_DEFAULT_MCU;
+    uint32_t frequency = 0;
+    uint64_t budget = 0;
+    uint32_t seconds = BENCH_DEFAULT_SECONDS;
+    const char* trace = NULL;
+    int option;
+
+    while ((option = getopt(argc, argv, "m:f:b:s:r:cg")) != -1)
+    {
+        switch (option)
+        {
+            case 'm':
+                mcu = optarg;
+                break;
+            case 'f':
+                frequency = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                budget = strtoull(optarg, NULL, 0);
+                break;
+            case 's':
+                seconds = strtoul(optarg, NULL, 0);
+                break;
+            case 'r':
+                trace = optarg;
+                break;
+            case 'c':
+                computer = true;
+                break;
+            case 'g':
+                random_board = true;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-m mcu] [-f frequency] [-b budget] [-s seconds] [-r trace] [-c] [-g] game_bench.out\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-m mcu] [-f frequency] [-b budget] [-s seconds] [-r trace] [-c] [-g] game_bench.out\n", argv[0]);
+        return 2;
+    }
+
+    elf_firmware_t firmware = {0};
+    if (elf_read_firmware(argv[optind], &firmware) != 0)
+    {
+        fprintf(stderr, "%s: cannot read firmware %s\n", argv[0], argv[optind]);
+        return 2;
+    }
+
+    avr_t* avr = avr_make_mcu_by_name(firmware.mmcu[0] ? firmware.mmcu : mcu);
+    if (avr == NULL)
+    {
+        fprintf(stderr, "%s: simavr has no core for %s\n", argv[0], firmware.mmcu[0] ? firmware.mmcu : mcu);
+        return 2;
+    }
+    avr_init(avr);
+    avr_load_firmware(avr, &firmware);
+
+    // the command line overrides the ELF, which overrides the UCFK4 default
+    if (frequency == 0)
+    {
+        frequency = firmware.frequency ? firmware.frequency : BENCH_DEFAULT_FREQUENCY;
+    }
+    avr->frequency = frequency;
+    if (budget == 0)
+    {
+        budget = frequency / PACER_RATE;
+    }
+
+    if (trace != NULL && !bench_load_trace(avr, trace))
+    {
+        fprintf(stderr, "%s: cannot read trace %s\n", argv[0], trace);
+        return 2;
+    }
+
+    avr_register_io_write(avr, BENCH_GPIOR0, bench_point_write, NULL);
+    avr_register_io_write(avr, BENCH_GPIOR1, bench_state_write, NULL);
+    avr_irq_register_notify(avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('1'), UART_IRQ_OUTPUT),
+                            bench_uart_output, NULL);
+    uart_input = avr_io_getirq(avr, AVR_IOCTL_UART_GETIRQ('1'), UART_IRQ_INPUT);
+
+    avr_cycle_count_t limit = (avr_cycle_count_t) seconds * frequency;
+    int cpu_state = cpu_Running;
+    uint64_t last_tick = 0;
+    while (cpu_state != cpu_Done && cpu_state != cpu_Crashed && avr->cycle < limit)
+    {
+        cpu_state = avr_run(avr);
+        if (ticks != last_tick)
+        {
+            last_tick = ticks;
+            bench_play(avr);
+        }
+        // the board the opponent revealed has been checked
+        if (game_state == GAME_STATE_END && stats[GAME_STATE_END][BENCH_COMMIT].calls != 0
+            && replies[BENCH_REPLY_ACK].tick == 0)
+        {
+            break;
+        }
+    }
+
+    if (cpu_state == cpu_Crashed)
+    {
+        fprintf(stderr, "%s: the simulated AVR crashed\n", argv[0]);
+        return 2;
+    }
+    if (game_state != GAME_STATE_END)
+    {
+        fprintf(stderr, "%s: the game did not reach the end state within %u seconds\n", argv[0], seconds);
+    }
+
+    return bench_report(frequency, budget) ? 1 : 0;
+}
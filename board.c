@@ -4,23 +4,37 @@
  *
  * This file contains the implementation of functions for creating, managing,
  * and updating the game boards in the Battleship game. It includes functions
- * for creating a new board based on a predefined layout, freeing the memory
- * used by the boards, and checking the result of firing a shot at the opponent's
- * board.
+ * for acquiring a board from a static pool based on a predefined layout,
+ * releasing the boards back to the pool, and checking the result of firing a
+ * shot at the opponent's board.
+ *
+ * Boards are never allocated on the heap, the pool is sized at compile time
+ * so the linker accounts for all board memory. Only the pool and the handles
+ * are shared, board_init() and board_fire() work on the board they are given
+ * so host tools can use them on their own boards from many threads.
  *
  * @date   17/10/2024
  * @author Corey Hines
  */
 
-#include <stdlib.h> 
-#include <string.h>
+#include <stddef.h>
 #include "board.h"
 
-/** @brief Pointer to the player's game board. */
-Board_t* our_board = NULL;
+/** @brief Static storage for every board used in the game. */
+static Board_t board_pool[BOARD_POOL_SIZE];
+
+/** @brief Bit n is set when board_pool[n] has been acquired. */
+static uint8_t board_pool_in_use = 0;
+
+// a game holds our board and theirs, which is why board_acquire() is not checked
+_Static_assert(BOARD_POOL_SIZE >= 2, "the board pool must hold our board and theirs");
+_Static_assert(BOARD_POOL_SIZE <= 8, "board_pool_in_use has one bit for each board");
+
+/** @brief Handle of the player's game board. */
+BoardHandle_t our_board = BOARD_HANDLE_NONE;
 
-/** @brief Pointer to the opponent's game board. */
-Board_t* their_board = NULL;
+/** @brief Handle of the opponent's game board. */
+BoardHandle_t their_board = BOARD_HANDLE_NONE;
 
 /** @brief Predefined board ID for the player's board. */
 uint8_t our_predefined_board_id = 0;
@@ -29,91 +43,264 @@ uint8_t our_predefined_board_id = 0;
 uint8_t their_predefined_board_id = 0;
 
 /**
- * @brief Creates a new game board based on a predefined layout.
+ * @brief Counts the number of set bits in a packed row.
  *
- * This function allocates memory for a new game board and initializes it
- * based on a given predefined board configuration. Each cell in the new
- * board is set to either SHIP_UNEXPLORED or EMPTY_UNEXPLORED based on the
- * predefined board data.
+ * Each iteration clears the lowest set bit, so this loops at most
+ * BOARD_COLS_NUM times.
  *
- * @param predefined_board The predefined board configuration to use.
- * @return A pointer to the newly allocated board.
+ * @param row_data The packed row to count.
+ * @return The number of set bits.
+ */
+static uint8_t board_row_popcount(uint8_t row_data)
+{
+    uint8_t count = 0;
+    while (row_data)
+    {
+        row_data &= row_data - 1;
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Clears the explored plane of a board and counts its ship cells.
+ *
+ * @param board The board to clear.
  */
-Board_t* create_board(const PredefinedBoard_t* predefined_board)
+static void board_clear_explored(Board_t* board)
 {
-    Board_t* new_board = (Board_t*) malloc(sizeof(Board_t));
+    board->ships_remaining = 0;
     for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
     {
-        uint8_t row_data = (*predefined_board)[row];  // Get the packed row
-        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
-        {
-            // Extract each bit from the row (shift right and mask)
-            uint8_t cell = (row_data >> (BOARD_COLS_NUM - 1 - col)) & 1;
-            (*new_board)[row][col] = (cell == 1) ? SHIP_UNEXPLORED : EMPTY_UNEXPLORED;
-        }
+        board->explored[row] = 0;
+        board->ships_remaining += board_row_popcount(board->ships[row]);
     }
-    return new_board;
 }
 
 /**
- * @brief Frees the memory used by both the player's and the opponent's boards.
+ * @brief Restores a board to the state it was in when it was acquired.
  *
- * This function deallocates the memory allocated for the player's and the
- * opponent's game boards, effectively clearing the boards' data.
+ * The ship plane is kept, so the explored plane is cleared and the number
+ * of ship cells is counted again.
+ *
+ * @param handle The handle of the board to reset.
  */
-void delete_boards(void)
+void board_reset(BoardHandle_t handle)
 {
-    free(our_board);
-    free(their_board);
+    Board_t* board = board_get(handle);
+    if (board == NULL)
+    {
+        return;
+    }
+    board_clear_explored(board);
 }
 
 /**
- * @brief Checks if all the opponent's ships have been sunk.
+ * @brief Sets up a board from a predefined layout, with no cell explored.
  *
- * This function iterates through the opponent's board and checks if all ship
- * cells have been explored. If all ships are sunk, it returns true.
+ * The predefined rows are copied directly into the ship plane, the explored
+ * plane is cleared and the number of ship cells is counted once so a win can
+ * be detected without rescanning the board.
  *
- * @return True if all opponent's ships are sunk, false otherwise.
+ * @param board The board to set up, which need not be in the pool.
+ * @param predefined_board The predefined board configuration to use.
  */
-static bool check_all_their_ships_sunk(void)
+void board_init(Board_t* board, const PredefinedBoard_t* predefined_board)
 {
     for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
     {
-        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        board->ships[row] = (*predefined_board)[row] & BOARD_ROW_MASK;  // Get the packed row
+    }
+    board_clear_explored(board);
+}
+
+/**
+ * @brief Acquires a board from the static pool and sets it up from a predefined layout.
+ *
+ * This function takes the first free board in the pool and initializes it
+ * based on a given predefined board configuration with board_init().
+ *
+ * Between game_init() and release_boards() a game acquires our board once,
+ * when it is chosen or edited, and their board once, when their tag is
+ * received. The pool holds both, so the game's callers cannot be refused.
+ *
+ * @param predefined_board The predefined board configuration to use.
+ * @return A handle to the board, or BOARD_HANDLE_NONE if the pool is exhausted.
+ */
+BoardHandle_t board_acquire(const PredefinedBoard_t* predefined_board)
+{
+    for (BoardHandle_t handle = 0; handle < BOARD_POOL_SIZE; handle++)
+    {
+        if (!(board_pool_in_use & (1 << handle)))
         {
-            if ((*their_board)[row][col] == SHIP_UNEXPLORED)
-            {
-                return false;
-            }
+            board_pool_in_use |= 1 << handle;
+            board_init(&board_pool[handle], predefined_board);
+            return handle;
         }
     }
-    return true;
+    return BOARD_HANDLE_NONE;
 }
 
 /**
- * @brief Checks the result of firing a shot at the opponent's board.
+ * @brief Returns a board to the static pool.
  *
- * This function determines the result of a shot fired at a specified cell
- * on the opponent's board. It updates the cell's state and returns a response
- * indicating if the shot was a HIT, MISS, or if it resulted in a WINNER.
+ * Releasing a handle which is not acquired has no effect.
  *
+ * @param handle The handle of the board to release.
+ */
+void board_release(BoardHandle_t handle)
+{
+    if (handle < BOARD_POOL_SIZE)
+    {
+        board_pool_in_use &= ~(1 << handle);
+    }
+}
+
+/**
+ * @brief Gets the board referred to by a handle.
+ *
+ * @param handle The handle of the board.
+ * @return A pointer to the board, or NULL if the handle is not acquired.
+ */
+Board_t* board_get(BoardHandle_t handle)
+{
+    if (handle >= BOARD_POOL_SIZE || !(board_pool_in_use & (1 << handle)))
+    {
+        return NULL;
+    }
+    return &board_pool[handle];
+}
+
+/**
+ * @brief Gets the state of a single cell on a board.
+ *
+ * The state is derived from the cell's bit in the ship and explored planes.
+ *
+ * @param board The board to read.
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ * @return The state of the cell.
+ */
+BoardCellState_t board_get_cell_state(const Board_t* board, uint8_t row, uint8_t col)
+{
+    uint8_t mask = BOARD_COL_MASK(col);
+    bool ship = board->ships[row] & mask;
+    if (board->explored[row] & mask)
+    {
+        return ship ? SHIP_EXPLORED : EMPTY_EXPLORED;
+    }
+    return ship ? SHIP_UNEXPLORED : EMPTY_UNEXPLORED;
+}
+
+/**
+ * @brief Gets the cells of a row another ship may not cover.
+ *
+ * With apart set, the cells next to a ship in the same row, and the cells
+ * above and below it, are blocked as well. The packed rows are shifted and
+ * or'ed together, so the whole row is done at once.
+ *
+ * @param ships The ships placed so far, packed like a predefined board.
+ * @param row The row index.
+ * @param apart true if ships may not be side by side or end to end.
+ * @return The blocked cells as a packed row.
+ */
+uint8_t board_blocked_cells(const PredefinedBoard_t* ships, uint8_t row, bool apart)
+{
+    uint8_t blocked = (*ships)[row];
+
+    if (apart)
+    {
+        blocked |= (uint8_t) ((*ships)[row] << 1) | ((*ships)[row] >> 1);
+        blocked |= row > 0 ? (*ships)[row - 1] : 0;
+        blocked |= row < BOARD_ROWS_NUM - 1 ? (*ships)[row + 1] : 0;
+    }
+    return blocked & BOARD_ROW_MASK;
+}
+
+/**
+ * @brief Releases both the player's and the opponent's boards back to the pool.
+ *
+ * This function returns the player's and the opponent's game boards to the
+ * pool so they can be acquired again for another game.
+ */
+void release_boards(void)
+{
+    board_release(our_board);
+    board_release(their_board);
+    our_board = BOARD_HANDLE_NONE;
+    their_board = BOARD_HANDLE_NONE;
+}
+
+/**
+ * @brief Fires a shot at a cell of a board, marking it explored.
+ *
+ * The cell is resolved with a single mask against the ship and explored
+ * planes, and a win is detected from the remaining ship count, so the cost
+ * does not depend on the board contents.
+ *
+ * @param board The board to fire at.
+ * @param row The row index of the targeted cell.
+ * @param col The column index of the targeted cell.
+ * @return NONE if the cell was already explored, otherwise a HIT, MISS, or WINNER when it sank the last ship.
+ */
+BoardResponse_t board_fire(Board_t* board, uint8_t row, uint8_t col)
+{
+    uint8_t mask = BOARD_COL_MASK(col);
+
+    if (board->explored[row] & mask)
+    {
+        return NONE;
+    }
+    board->explored[row] |= mask;
+
+    if (!(board->ships[row] & mask))
+    {
+        return MISS;
+    }
+    // when they hit a ship cell, check if all of them are now sunk, if so they win.
+    return --board->ships_remaining == 0 ? WINNER : HIT;
+}
+
+/**
+ * @brief Answers a shot fired at a board, marking the cell explored.
+ *
+ * The opponent never fires at a cell twice, but if they do the cell is
+ * answered as it was the first time without counting the hit again.
+ *
+ * @param board The board fired at.
  * @param row The row index of the targeted cell.
  * @param col The column index of the targeted cell.
- * @return The response indicating if the shot was a HIT, MISS, or if it resulted in a WINNER.
+ * @return HIT or MISS, or WINNER when it sank the last ship.
  */
-BoardResponse_t board_check_our_shot_their_board(uint8_t row, uint8_t col)
+BoardResponse_t board_answer_shot(Board_t* board, uint8_t row, uint8_t col)
 {
-    switch ((*their_board)[row][col]) 
+    BoardResponse_t response = board_fire(board, row, col);
+
+    if (response == NONE)
     {
-            (*their_board)[row][col] = SHIP_EXPLORED;
-            // when they hit a ship cell, check if all of them are now sunk, if so they win.
-            return check_all_their_ships_sunk() ? WINNER : HIT;
-        case EMPTY_UNEXPLORED:
-            (*their_board)[row][col] = EMPTY_EXPLORED;
-            return MISS;
-        case SHIP_EXPLORED:
-        case EMPTY_EXPLORED:
-            return NONE;
+        response = board_get_cell_state(board, row, col) == SHIP_EXPLORED ? HIT : MISS;
     }
-    return 9;
-}
\ No newline at end of file
+    return response;
+}
+
+/**
+ * @brief Records the answer to our shot at the opponent's board.
+ *
+ * Their board starts empty and only ever holds the ship cells they answered
+ * as hit, so its explored cells draw the same as when it held their ships.
+ *
+ * @param row The row index of the targeted cell.
+ * @param col The column index of the targeted cell.
+ * @param response The answer, a ship is recorded in the cell if it was a HIT or WINNER.
+ */
+void board_record_our_shot_their_board(uint8_t row, uint8_t col, BoardResponse_t response)
+{
+    Board_t* board = board_get(their_board);
+    uint8_t mask = BOARD_COL_MASK(col);
+
+    board->explored[row] |= mask;
+    if (response == HIT || response == WINNER)
+    {
+        board->ships[row] |= mask;
+    }
+}
@@ -13,12 +13,35 @@
 
 #define BOARD_ROWS_NUM LEDMAT_ROWS_NUM
 #define BOARD_COLS_NUM LEDMAT_COLS_NUM
+#define BOARD_ROW_MASK ((uint8_t) ((1 << BOARD_COLS_NUM) - 1)) // All columns of a packed row
 
 /* we were running out of memory I think (adding another board resulted
    in weird behavior) so instead of having a 2D array  of uint8_t (35 bytes), 
-   use an array of uint8_t which store each column (7 bytes) */
+   use an array of uint8_t which store each column (7 bytes).
+   memory.h now measures this, the debug display shows the least free SRAM */
 typedef uint8_t PredefinedBoard_t[LEDMAT_ROWS_NUM];
-typedef uint8_t Board_t[LEDMAT_ROWS_NUM][LEDMAT_COLS_NUM];
+
+/**
+ * @brief Mask selecting a column within a packed row.
+ *
+ * Rows are packed with column 0 in the most significant of the
+ * BOARD_COLS_NUM bits, matching the PredefinedBoard_t layout.
+ *
+ * @param col The column index.
+ */
+#define BOARD_COL_MASK(col) ((uint8_t) (1 << (BOARD_COLS_NUM - 1 - (col))))
+
+/**
+ * @struct Board_t
+ * @brief  A game board stored as two bit planes sharing the PredefinedBoard_t
+ *         packed row layout, 15 bytes instead of one byte per cell.
+ */
+typedef struct
+{
+    PredefinedBoard_t ships;    /**< A set bit marks a ship cell. */
+    PredefinedBoard_t explored; /**< A set bit marks a cell which has been shot at. */
+    uint8_t ships_remaining;    /**< Number of ship cells which have not been hit. */
+} Board_t;
 
 /**
  * @enum  BoardCellState_t.
@@ -34,42 +57,116 @@ typedef enum
 
 /**
  * @enum  BoardResponse_t.
- * @brief Represents the result of a shot fired on their board.
+ * @brief Represents the answer to a shot fired at a board.
  */
 typedef enum
 {
     NONE,   /**< Represents a cell has previously been discovered */
     MISS,   /**< Represents a cell that was targeted but contained no ship. */
     HIT,    /**< Represents a ship point that has been hit */
-    WINNER, /**< Represents we won - all their ships are sunk */
+    WINNER, /**< Represents the shot sank the last ship - the shooter won */
     LOSER,  /**< Represents we lost - all our ships are sunk */
 } BoardResponse_t;
 
 /**
- * @brief  Creates a new game board based on a predefined layout.
+ * @brief Handle to a board held in the static board pool.
+ */
+typedef uint8_t BoardHandle_t;
+
+#define BOARD_POOL_SIZE 2       // Boards in the static pool, one for us and one for them
+#define BOARD_HANDLE_NONE 0xFF  // Handle value which does not refer to a board
+
+/**
+ * @brief  Sets up a board from a predefined layout, with no cell explored.
+ * @param  board: The board to set up, which need not be in the pool.
+ * @param  predefined_board: The predefined board configuration to use.
+ */
+void board_init(Board_t* board, const PredefinedBoard_t* predefined_board);
+
+/**
+ * @brief  Acquires a board from the static pool and sets it up from a predefined layout.
+ *
+ * A game acquires our board and their board once each, which the pool
+ * always has room for, so the game does not check for BOARD_HANDLE_NONE.
+ *
  * @param  predefined_board: The predefined board configuration to use.
- * @return A pointer to the newly allocated board.
+ * @return A handle to the board, or BOARD_HANDLE_NONE if the pool is exhausted.
+ */
+BoardHandle_t board_acquire(const PredefinedBoard_t* predefined_board);
+
+/**
+ * @brief Returns a board to the static pool.
+ * @param handle: The handle of the board to release.
+ */
+void board_release(BoardHandle_t handle);
+
+/**
+ * @brief Restores a board to the state it was in when it was acquired.
+ * @param handle: The handle of the board to reset.
+ */
+void board_reset(BoardHandle_t handle);
+
+/**
+ * @brief  Gets the board referred to by a handle.
+ * @param  handle: The handle of the board.
+ * @return A pointer to the board, or NULL if the handle is not acquired.
+ */
+Board_t* board_get(BoardHandle_t handle);
+
+/**
+ * @brief  Gets the state of a single cell on a board.
+ * @param  board: The board to read.
+ * @param  row: The row index of the cell.
+ * @param  col: The column index of the cell.
+ * @return The state of the cell.
+ */
+BoardCellState_t board_get_cell_state(const Board_t* board, uint8_t row, uint8_t col);
+
+/**
+ * @brief  Gets the cells of a row another ship may not cover.
+ * @param  ships: The ships placed so far, packed like a predefined board.
+ * @param  row: The row index.
+ * @param  apart: true if ships may not be side by side or end to end, they may still touch at a corner.
+ * @return The blocked cells as a packed row.
  */
-Board_t* create_board(const PredefinedBoard_t* predefined_board);
+uint8_t board_blocked_cells(const PredefinedBoard_t* ships, uint8_t row, bool apart);
 
 /**
- * @brief Frees the memory used by both the player's and the opponent's boards.
+ * @brief Releases both the player's and the opponent's boards back to the pool.
+ */
+void release_boards(void);
+
+/**
+ * @brief  Fires a shot at a cell of a board, marking it explored.
+ * @param  board: The board to fire at.
+ * @param  row: The row index of the targeted cell.
+ * @param  col: The column index of the targeted cell.
+ * @return NONE if the cell was already explored, otherwise a HIT, MISS, or WINNER when it sank the last ship.
+ */
+BoardResponse_t board_fire(Board_t* board, uint8_t row, uint8_t col);
+
+/**
+ * @brief  Answers a shot fired at a board, marking the cell explored.
+ * @param  board: The board fired at.
+ * @param  row: The row index of the targeted cell.
+ * @param  col: The column index of the targeted cell.
+ * @return HIT or MISS, or WINNER when it sank the last ship, a cell shot before is answered as it was.
  */
-void delete_boards(void);
+BoardResponse_t board_answer_shot(Board_t* board, uint8_t row, uint8_t col);
 
 /**
- * @brief  Checks the result of firing a shot at the opponent's board.
+ * @brief  Records the answer to our shot at the opponent's board, whose ships we only know from their answers.
  * @param  row: The row index of the targeted cell.
  * @param  col: The column index of the targeted cell.
- * @return The response indicating if the shot was a HIT, MISS, or if it resulted in a WINNER.
+ * @param  response: The answer, a ship is recorded in the cell if it was a HIT or WINNER.
  */
-BoardResponse_t board_check_our_shot_their_board(uint8_t row, uint8_t col);
+void board_record_our_shot_their_board(uint8_t row, uint8_t col, BoardResponse_t response);
 
-/** @brief Pointer to the player's game board. */
-extern Board_t* our_board;
+/** @brief Handle of the player's game board. */
+extern BoardHandle_t our_board;
 
-/** @brief Pointer to the opponent's game board. */
-extern Board_t* their_board;
+/** @brief Handle of the opponent's game board, holding our shots and which of them hit. */
+extern BoardHandle_t their_board;
 
 /** @brief Predefined board ID for the player's board. */
 extern uint8_t our_predefined_board_id;
@@ -0,0 +1,354 @@
+/**
+ * @file   board_editor.c
+ * @brief  Implementation of the board editor, where the player places their own ships.
+ *
+ * The ship being placed is drawn on the cursor layer so it blinks over the
+ * ships already placed, which are drawn on the board layer. Each new ship
+ * starts at the first place it fits, so pushing the button again and again
+ * places a whole fleet. When a ship fits nowhere, the ships placed so far
+ * are cleared and the player starts again.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "board_editor.h"
+#include "board.h"
+#include "fleet_layout.h"
+#include "scheduler.h"
+#include "screen.h"
+#include "navigation_switch.h"
+#include "button.h"
+#include "commit.h"
+#include "game_state.h"
+#include "game.h"
+#include "input_trace.h"
+#include "bench.h"
+
+/** @brief Steps of a rank or rebuild walk at most, for its progress. */
+#define BOARD_EDITOR_JOB_STEPS FLEET_LAYOUT_STEPS_MAX
+
+/** @brief Lengths of the ships placed, in the order they are placed. */
+static const uint8_t EDITOR_SHIP_LENGTHS[FLEET_SHIPS_NUM] = FLEET_LENGTHS;
+
+/** @brief Whether the editor has been set up for this game. */
+static bool editor_started;
+
+/** @brief The ships placed so far. */
+static PredefinedBoard_t editor_ships;
+
+/** @brief The placements of the ships placed so far. */
+static FleetLayout_t editor_layout;
+
+/** @brief Index of the ship being placed, FLEET_SHIPS_NUM once every ship is placed. */
+static uint8_t editor_ship;
+
+/** @brief Row of the top cell of the ship being placed. */
+static uint8_t editor_row;
+
+/** @brief Column of the leftmost cell of the ship being placed. */
+static uint8_t editor_col;
+
+/** @brief Whether the ship being placed runs down the board rather than across. */
+static bool editor_down;
+
+/** @brief The reflection taking our canonical layout back to our board. */
+static uint8_t editor_reflection;
+
+/** @brief State of the walk finding the rank of our layout. */
+static FleetWalk_t editor_rank;
+
+/** @brief The job finding the rank of our layout. */
+static SchedulerJob_t editor_rank_job = {fleet_layout_rank_step, &editor_rank, BOARD_EDITOR_JOB_BUDGET,
+                                         BOARD_EDITOR_JOB_STEPS, 0, SCHEDULER_JOB_IDLE};
+
+/** @brief The reflection taking the opponent's canonical layout back to their board. */
+static uint8_t rebuild_reflection;
+
+/** @brief State of the walk rebuilding the opponent's layout from its rank. */
+static FleetWalk_t rebuild_unrank;
+
+/** @brief The job rebuilding the opponent's layout. */
+static SchedulerJob_t rebuild_job = {fleet_layout_unrank_step, &rebuild_unrank, BOARD_EDITOR_JOB_BUDGET,
+                                     BOARD_EDITOR_JOB_STEPS, 0, SCHEDULER_JOB_IDLE};
+
+/**
+ * @brief Gets the cells of the ship being placed.
+ *
+ * @param cells The board to fill with the ship's cells, packed like a predefined board.
+ */
+static void board_editor_ship_cells(PredefinedBoard_t* cells)
+{
+    uint8_t length = EDITOR_SHIP_LENGTHS[editor_ship];
+
+    memset(*cells, 0, sizeof(*cells));
+    if (!editor_down)
+    {
+        (*cells)[editor_row] = (uint8_t) (((1 << length) - 1) << (BOARD_COLS_NUM - length - editor_col));
+        return;
+    }
+    for (uint8_t k = 0; k < length; k++)
+    {
+        (*cells)[editor_row + k] = BOARD_COL_MASK(editor_col);
+    }
+}
+
+/**
+ * @brief Checks the ship being placed does not cover, or with BOARD_EDITOR_APART sit beside, a placed ship.
+ *
+ * @return true if the ship can be placed where it is.
+ */
+static bool board_editor_ship_fits(void)
+{
+    PredefinedBoard_t cells;
+
+    board_editor_ship_cells(&cells);
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        if (cells[row] & board_blocked_cells(&editor_ships, row, BOARD_EDITOR_APART))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Moves the ship being placed back onto the board if it runs off an edge.
+ */
+static void board_editor_clamp(void)
+{
+    uint8_t length = EDITOR_SHIP_LENGTHS[editor_ship];
+    uint8_t rows = editor_down ? BOARD_ROWS_NUM - length + 1 : BOARD_ROWS_NUM;
+    uint8_t cols = editor_down ? BOARD_COLS_NUM : BOARD_COLS_NUM - length + 1;
+
+    editor_row = editor_row < rows ? editor_row : rows - 1;
+    editor_col = editor_col < cols ? editor_col : cols - 1;
+}
+
+/**
+ * @brief Draws the placed ships and the ship being placed.
+ */
+static void board_editor_draw(void)
+{
+    PredefinedBoard_t cells;
+
+    screen_layer_set(SCREEN_LAYER_BOARD, &editor_ships);
+    board_editor_ship_cells(&cells);
+    screen_layer_set(SCREEN_LAYER_CURSOR, &cells);
+    screen_layer_show(SCREEN_LAYER_CURSOR, true);
+}
+
+/**
+ * @brief Starts placing the next ship at the first place it fits, across before down, row by row.
+ *
+ * @return true if the ship fits somewhere, false if the board has no room left for it.
+ */
+static bool board_editor_next_ship(void)
+{
+    for (uint8_t down = 0; down < 2; down++)
+    {
+        editor_down = down;
+        for (editor_row = 0; editor_row < BOARD_ROWS_NUM; editor_row++)
+        {
+            for (editor_col = 0; editor_col < BOARD_COLS_NUM; editor_col++)
+            {
+                uint8_t row = editor_row;
+                uint8_t col = editor_col;
+                board_editor_clamp();
+                if (editor_row == row && editor_col == col && board_editor_ship_fits())
+                {
+                    return true;
+                }
+                editor_row = row;
+                editor_col = col;
+            }
+        }
+    }
+    editor_row = 0;
+    editor_col = 0;
+    editor_down = false;
+    return false;
+}
+
+/**
+ * @brief Clears every placed ship and starts again from the first.
+ */
+static void board_editor_restart(void)
+{
+    memset(editor_ships, 0, sizeof(editor_ships));
+    editor_ship = 0;
+    board_editor_next_ship();
+    board_editor_draw();
+}
+
+/**
+ * @brief Places the ship being placed, then starts the next one.
+ */
+static void board_editor_place(void)
+{
+    PredefinedBoard_t cells;
+    uint8_t length = EDITOR_SHIP_LENGTHS[editor_ship];
+
+    board_editor_ship_cells(&cells);
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        editor_ships[row] |= cells[row];
+    }
+    editor_layout.placements[editor_ship] = fleet_placement(length, editor_row, editor_col, editor_down);
+
+    if (++editor_ship == FLEET_SHIPS_NUM)
+    {
+        // the whole fleet is placed, it no longer blinks
+        scheduler_task_enable(GAME_TASK_SHOW_CURSOR, false);
+        screen_layer_clear(SCREEN_LAYER_CURSOR);
+        screen_layer_set(SCREEN_LAYER_BOARD, &editor_ships);
+        return;
+    }
+    if (!board_editor_next_ship())
+    {
+        screen_set_scrolling_text(MESSAGE_NO_ROOM);
+        board_editor_restart();
+        return;
+    }
+    board_editor_draw();
+}
+
+/**
+ * @brief Commits to our board once its rank has been found.
+ *
+ * The rank job waits for any rebuild of an opponent's board still running,
+ * as only one job runs at a time.
+ */
+static void board_editor_send(void)
+{
+    if (rebuild_job.status == SCHEDULER_JOB_RUNNING)
+    {
+        return;
+    }
+    if (editor_rank_job.status == SCHEDULER_JOB_IDLE)
+    {
+        FleetLayout_t canonical = editor_layout;
+        editor_reflection = fleet_layout_canonicalize(&canonical);
+        fleet_layout_rank_start(&editor_rank, &canonical);
+        scheduler_job_start(&editor_rank_job);
+        return;
+    }
+    if (editor_rank_job.status != SCHEDULER_JOB_FINISHED)
+    {
+        return;
+    }
+
+    editor_rank_job.status = SCHEDULER_JOB_IDLE;
+    editor_started = false;
+    our_board = board_acquire(&editor_ships);
+    our_predefined_board_id = BOARD_EDITOR_ID;
+    set_game_state(GAME_STATE_AWAIT_BOARD_EXCHANGE);
+    CommitReveal_t reveal = {.id = BOARD_EDITOR_ID, .code = FLEET_LAYOUT_CODE(editor_rank.rank, editor_reflection)};
+    commit_send_our_board(&editor_ships, &reveal);
+    sent_our_board = true;
+}
+
+/**
+ * @brief Forgets any board being edited or rebuilt.
+ */
+void board_editor_init(void)
+{
+    if (editor_rank_job.status == SCHEDULER_JOB_RUNNING || rebuild_job.status == SCHEDULER_JOB_RUNNING)
+    {
+        scheduler_job_cancel();
+    }
+    editor_rank_job.status = SCHEDULER_JOB_IDLE;
+    rebuild_job.status = SCHEDULER_JOB_IDLE;
+    editor_started = false;
+}
+
+/**
+ * @brief Updates the board editor.
+ *
+ * North, south, east and west move the ship being placed, pushing the
+ * navigation switch down turns it, and the button places it if it fits.
+ */
+void update_edit_board(void)
+{
+    if (!editor_started)
+    {
+        editor_started = true;
+        scheduler_task_enable(GAME_TASK_SHOW_CURSOR, true);
+        board_editor_restart();
+    }
+    if (editor_ship == FLEET_SHIPS_NUM)
+    {
+        board_editor_send();
+        return;
+    }
+
+    button_update();
+
+    uint8_t row = editor_row;
+    uint8_t col = editor_col;
+    bool down = editor_down;
+    switch (navigation_switch_get())
+    {
+        case DIR_NORTH:
+            editor_row = editor_row > 0 ? editor_row - 1 : 0;
+            break;
+        case DIR_SOUTH:
+            editor_row++;
+            break;
+        case DIR_WEST:
+            editor_col = editor_col > 0 ? editor_col - 1 : 0;
+            break;
+        case DIR_EAST:
+            editor_col++;
+            break;
+        case DIR_PUSHED:
+            editor_down = !editor_down;
+            break;
+        default:
+            break;
+    }
+    board_editor_clamp();
+    if (editor_row != row || editor_col != col || editor_down != down)
+    {
+        board_editor_draw();
+    }
+
+    if (input_trace_button(button_push_event_p (0) || BENCH_INPUT_TAKE(BENCH_INPUT_BUTTON)) && board_editor_ship_fits())
+    {
+        board_editor_place();
+    }
+}
+
+/**
+ * @brief Starts rebuilding the opponent's edited board from its code.
+ *
+ * @param code The fleet layout code the opponent revealed.
+ */
+void board_editor_rebuild_start(uint32_t code)
+{
+    rebuild_reflection = FLEET_LAYOUT_CODE_REFLECTION(code);
+    fleet_layout_unrank_start(&rebuild_unrank, FLEET_LAYOUT_CODE_RANK(code));
+    scheduler_job_start(&rebuild_job);
+}
+
+/**
+ * @brief Checks if the opponent's edited board has been rebuilt.
+ *
+ * @param board The board to fill with the opponent's ships once it has.
+ * @return true once, when the board has been rebuilt.
+ */
+bool board_editor_rebuild_finished(PredefinedBoard_t* board)
+{
+    if (rebuild_job.status != SCHEDULER_JOB_FINISHED)
+    {
+        return false;
+    }
+    rebuild_job.status = SCHEDULER_JOB_IDLE;
+    fleet_layout_reflect(&rebuild_unrank.layout, rebuild_reflection);
+    fleet_layout_board(&rebuild_unrank.layout, board);
+    return true;
+}
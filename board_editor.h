@@ -0,0 +1,69 @@
+/**
+ * @file   board_editor.h
+ * @brief  Header of the board editor, where the player places their own ships.
+ *
+ * The editor runs in GAME_STATE_EDIT_BOARD. The ships of FLEET_LENGTHS are
+ * placed one at a time, longest first: the navigation switch moves the ship,
+ * pushing it down turns it between across and down, and the button places
+ * it. A ship is only placed where it does not cover another ship, nor with
+ * BOARD_EDITOR_APART sit beside one, checked a packed row at a time.
+ *
+ * The finished board is committed to, see commit.h, and revealed once the
+ * game ends as its fleet layout code, the rank of its canonical layout and
+ * the reflection back to it, see fleet_layout.h.
+ * Finding the rank and rebuilding the opponent's board from theirs both count
+ * layouts one short ship placement per step, so each runs as a scheduler job.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef BOARD_EDITOR_H
+#define BOARD_EDITOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+
+/**
+ * @brief Whether placed ships must be kept apart, not side by side or end to end, like random boards.
+ */
+#define BOARD_EDITOR_APART true
+
+/**
+ * @brief Board ID recorded for an edited board, one no predefined board has.
+ */
+#define BOARD_EDITOR_ID 0xFE
+
+/**
+ * @brief Timer counts the rank and rebuild jobs may run for each tick, about 0.5 ms.
+ */
+#define BOARD_EDITOR_JOB_BUDGET 4
+
+/**
+ * @brief Forgets any board being edited or rebuilt, called when the game starts.
+ */
+void board_editor_init(void);
+
+/**
+ * @brief Updates the board editor, run every tick in GAME_STATE_EDIT_BOARD.
+ *
+ * Once the last ship is placed, the board's code is found, the board is
+ * committed to and the game moves on to GAME_STATE_AWAIT_BOARD_EXCHANGE.
+ */
+void update_edit_board(void);
+
+/**
+ * @brief Starts rebuilding the opponent's edited board from its code.
+ * @param code The fleet layout code the opponent revealed.
+ */
+void board_editor_rebuild_start(uint32_t code);
+
+/**
+ * @brief  Checks if the opponent's edited board has been rebuilt.
+ * @param  board: The board to fill with the opponent's ships once it has.
+ * @return true once, when the board has been rebuilt.
+ */
+bool board_editor_rebuild_finished(PredefinedBoard_t* board);
+
+#endif /* BOARD_EDITOR_H */
@@ -6,6 +6,11 @@
  * management in the Battleship game. It includes functions to update the game 
  * state based on the opponent's actions and the player's cell selection.
  *
+ * Each board answers the shots fired at it, so our board never leaves this
+ * UCFK4. Their board starts empty and only holds our shots and the answers
+ * they gave, which are checked against their board once it is revealed at the
+ * end of the game, see commit.h.
+ *
  * @date   17/10/2024
  * @author Corey Hines
  */
@@ -15,165 +20,161 @@
 #include "screen.h"
 #include "game_state.h"
 #include "game.h"
-#include "ir.h"
+#include "opponent.h"
 #include "navigation_switch.h"
+#include "bench.h"
+#include "scheduler.h"
 #include <stdint.h>
 #include <stdbool.h>
 
 
+/** @brief Row of the cell currently selected to shoot at. */
+static uint8_t cursor_row = 3;
+
+/** @brief Column of the cell currently selected to shoot at. */
+static uint8_t cursor_col = 2;
+
+/** @brief Whether the cursor is currently shown, it blinks. */
+static bool cursor_on = false;
+
+/** @brief Row of the cell of our last shot, waiting for its answer. */
+static uint8_t shot_row;
+
+/** @brief Column of the cell of our last shot, waiting for its answer. */
+static uint8_t shot_col;
+
 /**
- * @brief Updates the display of explored cells.
+ * @brief Draws the explored cells of their board into the screen layers.
  *
- * This function toggles the display of explored cells on the opponent's 
- * board at regular intervals. It ensures that the explored cells are 
- * highlighted appropriately while excluding the currently selected cell.
- *
- * @param row The row index of the currently selected cell.
- * @param col The column index of the currently selected cell.
+ * Misses are drawn on the dim layer and hits on the bright one, a row of
+ * each at a time from the board's bit planes. Their board only changes
+ * when we shoot, so this is done once each time a shot starts being selected.
  */
-static void update_showing_explored_cells(uint8_t row, uint8_t col)
+static void show_explored_cells(void)
 {
-    static bool initialised;
-    static uint8_t explored_ticks = 0;
-    static bool explored_on = false;
+    const Board_t* board = board_get(their_board);
+    PredefinedBoard_t misses;
+    PredefinedBoard_t hits;
 
-    if (!initialised)
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
     {
-        explored_ticks = 0;
-        explored_on = false;
-        initialised = true;
-    }
-
-    if (explored_ticks++ == 10)
-    {
-        explored_on = !explored_on;
-        for (uint8_t cell_row = 0; cell_row < BOARD_ROWS_NUM; cell_row++)
-        {
-            for (uint8_t cell_col = 0; cell_col < BOARD_COLS_NUM; cell_col++)
-            {
-                // dont prevent it from flashing if we are on this current row, col
-                if (cell_row != row || cell_col != col)
-                {
-                    BoardCellState_t cell_state = (*their_board)[cell_row][cell_col];
-                    if (cell_state == SHIP_EXPLORED)
-                    {
-                        screen_set_pixel(cell_col, cell_row, explored_on);
-                    }
-                    else if (cell_state == EMPTY_EXPLORED)
-                    {
-                        screen_set_pixel(cell_col, cell_row, PIXEL_ON);
-                    }
-                }
-            }
-        }
-        explored_ticks = 0;
+        misses[row] = board->explored[row] & ~board->ships[row];
+        hits[row] = board->explored[row] & board->ships[row];
     }
+    screen_layer_set(SCREEN_LAYER_MISSES, &misses);
+    screen_layer_set(SCREEN_LAYER_HITS, &hits);
 }
 
 /**
  * @brief Updates the display of the cursor.
  *
- * This function toggles the display of the cursor at the currently selected 
- * cell at regular intervals, creating a blinking effect.
- *
- * @param row The row index of the currently selected cell.
- * @param col The column index of the currently selected cell.
+ * This function toggles the cursor layer holding the currently selected 
+ * cell, creating a blinking effect. It is run by the scheduler every
+ * GAME_TASK_SHOW_CURSOR period while a shot is being selected.
  */
-static void update_showing_cursor(uint8_t row, uint8_t col)
+void update_showing_cursor(void)
 {
-    static bool initialised;
-    static uint8_t cursor_ticks = 0;
-    static bool cursor_on = false;
-
-    if (!initialised)
-    {
-        cursor_ticks = 0;
-        cursor_on = false;
-        initialised = true;
-    }
-
-    if (cursor_ticks++ == 100)
-    {
-        cursor_on = !cursor_on;
-        screen_set_pixel(col, row, cursor_on);
-        cursor_ticks = 0;
-    }
+    cursor_on = !cursor_on;
+    screen_layer_show(SCREEN_LAYER_CURSOR, cursor_on);
 }
 
 /**
- * @brief Updates to check if the other player has sent their turn.
+ * @brief Updates to check if the other player has sent their shot.
  *
- * This function checks if the opponent's turn has been received via IR 
- * communication. If a valid response is received, the game state is updated 
- * to the next phase. If not, it continues to wait.
+ * This function checks if the opponent's shot has been received via IR 
+ * communication or from the computer. If a shot is received, it is answered from our
+ * board and the game state is updated to the next phase. If not, it continues to wait.
  */
 void update_receive_their_turn(void)
 {
-    static uint8_t ticks = 0;
-    static bool initialise = false;
-
-    if (!initialise)
-    {
-        ticks = 0;
-        initialise = true;
-    }
-
-    // wait 250 ticks (~0.5 seconds) before trying to receive their response
-    // as there are troubles with receiving our own signal even when the 
-    // internal ir driver waits then accepts their own signal if received.
-    if (ticks != 250) {
-        ticks++;
-        return;
-    }
-    BoardResponse_t response;
-    if (ir_get_their_turn_state(&response)) 
+    // our own frames are dropped by ir.c, so their shot can be
+    // read as soon as it arrives
+    uint8_t row;
+    uint8_t col;
+    if (opponent_get_their_shot(&row, &col)) 
     {
+        BENCH_BEGIN(BENCH_CHECK_SHOT);
+        BoardResponse_t response = board_answer_shot(board_get(our_board), row, col);
+        BENCH_END(BENCH_CHECK_SHOT);
+        opponent_send_our_turn_state(response);
         if (response == HIT)
         {
             set_game_state(GAME_STATE_SELECT_SHOOT_POSITION);
             screen_set_scrolling_text(MESSAGE_HIT);
-            initialise = false;
         }
         else if (response == MISS)
         {
             set_game_state(GAME_STATE_SELECT_SHOOT_POSITION);
             screen_set_scrolling_text(MESSAGE_MISS);
-            initialise = false;
         }
         else if (response == WINNER)
         {
             // if they won we lost :(
+            won_game = false;
             set_game_state(GAME_STATE_END);
             screen_set_scrolling_text(MESSAGE_LOSER);
-            initialise = false;
         }
     }
 }
 
+/**
+ * @brief Updates to check if the other player has answered our shot.
+ *
+ * This function checks if the opponent's answer to our last shot has been received.
+ * If it has, the answer is recorded on their board and the game state is updated to
+ * the next phase. If not, it continues to wait.
+ */
+void update_await_shot_result(void)
+{
+    BoardResponse_t response;
+    if (!opponent_get_their_turn_state(&response))
+    {
+        return;
+    }
+
+    board_record_our_shot_their_board(shot_row, shot_col, response);
+    if (response == HIT) 
+    {   
+        set_game_state(GAME_STATE_THEIR_TURN);
+        screen_set_scrolling_text(MESSAGE_HIT);
+    }
+    else if (response == MISS)
+    {
+        set_game_state(GAME_STATE_THEIR_TURN);
+        screen_set_scrolling_text(MESSAGE_MISS);
+    }
+    else if (response == WINNER)
+    {
+        // they answered that our shot sank their last ship
+        won_game = true;
+        set_game_state(GAME_STATE_END);
+        screen_set_scrolling_text(MESSAGE_WINNER);
+    }
+}
+
 /**
  * @brief Updates the cell selection process where the user selects a cell to send a shot.
  *
  * This function handles the logic for selecting a cell to fire a shot at. It updates the 
- * selected cell based on user input from the navigation switch and sends the shot result 
- * to the opponent via IR communication.
+ * selected cell based on user input from the navigation switch and sends the shot 
+ * to the opponent, who answers it from their board.
  */
 void update_select_shoot_position(void)
 {
     static bool initialised = false;
-    static uint8_t col = 2;
-    static uint8_t row = 3;
-    static bool previous_shot = false;
 
     // Initialize the starting position if not done already
     if (!initialised)
     {
-        screen_set_pixel(col, row, PIXEL_ON);
+        show_explored_cells();
+        screen_layer_set_cell(SCREEN_LAYER_CURSOR, cursor_col, cursor_row, true);
+        cursor_on = true;
         initialised = true;
-        previous_shot = false;
+        scheduler_task_enable(GAME_TASK_SHOW_CURSOR, true);
     }
 
-    uint8_t prev_row = row;
-    uint8_t prev_col = col;
+    uint8_t prev_row = cursor_row;
+    uint8_t prev_col = cursor_col;
     int8_t row_offset = 0;
     int8_t col_offset = 0;
 
@@ -191,56 +192,34 @@ void update_select_shoot_position(void)
         case DIR_EAST:
             col_offset = 1;
             break;
-        case DIR_PUSHED: {
-            BoardResponse_t response = board_check_our_shot_their_board(row, col);
-            if (response == HIT) 
-            {   
-                ir_send_our_turn_state(HIT);
-                set_game_state(GAME_STATE_THEIR_TURN);
-                screen_set_scrolling_text(MESSAGE_HIT);
-                initialised = false;
-                previous_shot = true;
-            }
-            else if (response == MISS)
+        case DIR_PUSHED:
+            // a cell we have shot before needs no answer
+            if (board_get_cell_state(board_get(their_board), cursor_row, cursor_col) == EMPTY_UNEXPLORED)
             {
-                ir_send_our_turn_state(MISS);
-                set_game_state(GAME_STATE_THEIR_TURN);
-                screen_set_scrolling_text(MESSAGE_MISS);
-                initialised = false;
-                previous_shot = true;
-            }
-            else if (response == WINNER)
-            {
-                // other board will interpret receiving WINNER as we won and they lost
-                ir_send_our_turn_state(WINNER);
-                set_game_state(GAME_STATE_END);
-                screen_set_scrolling_text(MESSAGE_WINNER);
+                // the blinking only runs while a shot is being selected
+                scheduler_task_enable(GAME_TASK_SHOW_CURSOR, false);
+                shot_row = cursor_row;
+                shot_col = cursor_col;
+                opponent_send_our_shot(shot_row, shot_col);
+                set_game_state(GAME_STATE_AWAIT_SHOT_RESULT);
                 initialised = false;
             }
             break;
-        }
         default:
             break;
     }
 
     // boundary checks, ensure we don't cause an underflow or try go to a row/col that doesn't exist
-    row = (row + row_offset < LEDMAT_ROWS_NUM) ? (row + row_offset >= 0 ? row + row_offset : 0) : LEDMAT_ROWS_NUM - 1;
-    col = (col + col_offset < LEDMAT_COLS_NUM) ? (col + col_offset >= 0 ? col + col_offset : 0) : LEDMAT_COLS_NUM - 1;
+    cursor_row = (cursor_row + row_offset < LEDMAT_ROWS_NUM) ? (cursor_row + row_offset >= 0 ? cursor_row + row_offset : 0) : LEDMAT_ROWS_NUM - 1;
+    cursor_col = (cursor_col + col_offset < LEDMAT_COLS_NUM) ? (cursor_col + col_offset >= 0 ? cursor_col + col_offset : 0) : LEDMAT_COLS_NUM - 1;
 
-    // only update when a row or col has changed
-    if (row != prev_row || col != prev_col)
+    // only update when a row or col has changed, the cursor layer sits above
+    // the explored cells so the one it leaves shows through again
+    if (cursor_row != prev_row || cursor_col != prev_col)
     {
-        // turn off previous only if it wasnt previously hit
-        if (!previous_shot)
-        {
-            screen_set_pixel(prev_col, prev_row, PIXEL_OFF);
-        } 
-        else 
-        {
-            previous_shot = false;
-        }
+        screen_layer_set_cell(SCREEN_LAYER_CURSOR, prev_col, prev_row, false);
+        screen_layer_set_cell(SCREEN_LAYER_CURSOR, cursor_col, cursor_row, true);
+        cursor_on = true;
+        screen_layer_show(SCREEN_LAYER_CURSOR, true);
     }
-   
-    update_showing_explored_cells(row, col);
-    update_showing_cursor(row, col);
 }
\ No newline at end of file
@@ -10,17 +10,32 @@
 
 /**
  * @brief Updates to check if the other player has sent their
- * turn.
+ * shot.
  * 
- * If the turn has been received, the next phase of the game will
- * begin, if not we will keep waiting.
+ * If the shot has been received, it is answered from our board and
+ * the next phase of the game will begin, if not we will keep waiting.
  */
 void update_receive_their_turn(void);
 
+/**
+ * @brief Updates to check if the other player has answered our
+ * shot.
+ * 
+ * If the answer has been received, it is recorded on their board and
+ * the next phase of the game will begin, if not we will keep waiting.
+ */
+void update_await_shot_result(void);
+
 /**
  * @brief Updates the cell selection process where the user
  * selects a cell to send a shot.
  */
 void update_select_shoot_position(void);
 
+/**
+ * @brief Toggles the display of the cursor, run periodically by the
+ * scheduler while a shot is being selected.
+ */
+void update_showing_cursor(void);
+
 #endif /* BOARD_MANAGER_H */
\ No newline at end of file
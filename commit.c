@@ -0,0 +1,375 @@
+/**
+ * @file   commit.c
+ * @brief  Implementation of the board commitments, which keep each player's board private until the game ends.
+ *
+ * HalfSipHash works on 32 bit words, 4 bytes an operation on the AVR where
+ * SipHash needs 8, and the board and its length fit in two message blocks.
+ * With the 64 bit tag that is 12 rounds in all, measured by make bench as
+ * the commit_hash point, so the tag is found within a tick rather than
+ * being run as a scheduler job.
+ *
+ * The salt is drawn from a pool which every input stirs in with the timer
+ * count it was read at, so it gathers the jitter of each push and each byte
+ * received since reset. The counts are read straight from the timer rather
+ * than through the input trace, so a recorded trace does not give the salt
+ * away, and replay draws a different salt without changing the game.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "commit.h"
+#include "board.h"
+#include "predefined_boards.h"
+#include "random_board.h"
+#include "board_editor.h"
+#include "opponent.h"
+#include "screen.h"
+#include "game.h"
+#include "timer.h"
+#include "bench.h"
+
+#define COMMIT_ROTL(x, b) ((uint32_t) (((x) << (b)) | ((x) >> (32 - (b))))) // Rotates a word left by b bits
+
+/** @brief HalfSipHash state the inputs are stirred into, salts are squeezed from a copy. */
+static uint32_t commit_pool[4] = {0, 0, 0x6C796765, 0x74656462};
+
+/** @brief The salt of our board's tag. */
+static CommitSalt_t our_salt;
+
+/** @brief How our board is revealed once the game ends. */
+static CommitReveal_t our_reveal;
+
+/** @brief The tag of the opponent's board. */
+static CommitTag_t their_tag;
+
+/** @brief The salt of the opponent's board, valid when their_salt_ready is set. */
+static CommitSalt_t their_salt;
+
+/** @brief Whether the opponent's salt has been received. */
+static bool their_salt_ready;
+
+/** @brief Whether our board has been revealed. */
+static bool revealed;
+
+/** @brief The result of checking the opponent's board. */
+static CommitResult_t commit_result;
+
+/**
+ * @brief Runs a round of HalfSipHash on its four words.
+ *
+ * @param v The state words.
+ */
+static void commit_round(uint32_t* v)
+{
+    v[0] += v[1];
+    v[1] = COMMIT_ROTL(v[1], 5);
+    v[1] ^= v[0];
+    v[0] = COMMIT_ROTL(v[0], 16);
+    v[2] += v[3];
+    v[3] = COMMIT_ROTL(v[3], 8);
+    v[3] ^= v[2];
+    v[0] += v[3];
+    v[3] = COMMIT_ROTL(v[3], 7);
+    v[3] ^= v[0];
+    v[2] += v[1];
+    v[1] = COMMIT_ROTL(v[1], 13);
+    v[1] ^= v[2];
+    v[2] = COMMIT_ROTL(v[2], 16);
+}
+
+/**
+ * @brief Absorbs a message word, running two rounds.
+ *
+ * @param v The state words.
+ * @param m The message word.
+ */
+static void commit_absorb(uint32_t* v, uint32_t m)
+{
+    v[3] ^= m;
+    commit_round(v);
+    commit_round(v);
+    v[0] ^= m;
+}
+
+/**
+ * @brief Reads a little endian word.
+ *
+ * @param bytes The 4 bytes of the word.
+ * @return The word.
+ */
+static uint32_t commit_read_word(const uint8_t* bytes)
+{
+    return bytes[0] | ((uint32_t) bytes[1] << 8) | ((uint32_t) bytes[2] << 16) | ((uint32_t) bytes[3] << 24);
+}
+
+/**
+ * @brief Writes the word of the tag the state gives after four more rounds.
+ *
+ * @param v The state words.
+ * @param bytes The 4 bytes of the tag to set, little endian.
+ */
+static void commit_squeeze(uint32_t* v, uint8_t* bytes)
+{
+    for (uint8_t round = 0; round < 4; round++)
+    {
+        commit_round(v);
+    }
+    uint32_t word = v[1] ^ v[3];
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        bytes[i] = (uint8_t) (word >> (8 * i));
+    }
+}
+
+/**
+ * @brief Hashes a board with HalfSipHash-2-4 keyed by a salt.
+ *
+ * The message is the board's BOARD_ROWS_NUM rows, the first 4 in one block
+ * and the rest in the last block with the length in its top byte.
+ *
+ * @param board The board, its rows are the message.
+ * @param salt The salt, the key.
+ * @param tag The tag to set.
+ */
+void commit_hash(const PredefinedBoard_t* board, const CommitSalt_t* salt, CommitTag_t* tag)
+{
+    BENCH_BEGIN(BENCH_COMMIT);
+    uint32_t k0 = commit_read_word(&(*salt)[0]);
+    uint32_t k1 = commit_read_word(&(*salt)[4]);
+    // the 0xEE asks for a 64 bit tag
+    uint32_t v[4] = {k0, k1 ^ 0xEE, 0x6C796765 ^ k0, 0x74656462 ^ k1};
+    uint8_t last[4] = {0, 0, 0, BOARD_ROWS_NUM};
+
+    uint8_t row = 0;
+    for (; row + 4 <= BOARD_ROWS_NUM; row += 4)
+    {
+        commit_absorb(v, commit_read_word(&(*board)[row]));
+    }
+    for (uint8_t i = 0; row < BOARD_ROWS_NUM; i++, row++)
+    {
+        last[i] = (*board)[row];
+    }
+    commit_absorb(v, commit_read_word(last));
+
+    v[2] ^= 0xEE;
+    commit_squeeze(v, &(*tag)[0]);
+    v[1] ^= 0xDD;
+    commit_squeeze(v, &(*tag)[4]);
+    BENCH_END(BENCH_COMMIT);
+}
+
+/**
+ * @brief Stirs an input into the pool salts are drawn from, with the timer count it was read at.
+ *
+ * @param event The input read, its kind in the top byte and any data in the bottom.
+ */
+void commit_stir(uint16_t event)
+{
+    commit_absorb(commit_pool, ((uint32_t) timer_get() << 16) | event);
+}
+
+/**
+ * @brief Draws a new random salt from the inputs stirred in since reset.
+ *
+ * The salt is squeezed from a copy of the pool, so revealing it once the
+ * game ends does not give away the pool the next salt is drawn from.
+ *
+ * @param salt The salt to set.
+ */
+void commit_salt_choose(CommitSalt_t* salt)
+{
+    commit_stir(COMMIT_STIR_SALT);
+    uint32_t v[4] = {commit_pool[0], commit_pool[1], commit_pool[2] ^ 0xEE, commit_pool[3]};
+
+    commit_squeeze(v, &(*salt)[0]);
+    v[1] ^= 0xDD;
+    commit_squeeze(v, &(*salt)[4]);
+}
+
+/**
+ * @brief Checks a revealed board against a tag and the answers to our shots.
+ *
+ * Every cell we shot must hold a ship exactly when it was answered as a hit,
+ * and if the last answer said every ship was sunk none may be left.
+ *
+ * @param board The revealed board.
+ * @param salt The revealed salt.
+ * @param tag The tag sent when the game started.
+ * @param shots Our shots at the board and which of them were answered as a hit.
+ * @param sunk true if the last answer said every ship was sunk.
+ * @return true if the board matches.
+ */
+bool commit_check(const PredefinedBoard_t* board, const CommitSalt_t* salt, const CommitTag_t* tag,
+                  const Board_t* shots, bool sunk)
+{
+    CommitTag_t hashed;
+
+    commit_hash(board, salt, &hashed);
+    if (memcmp(hashed, *tag, COMMIT_TAG_BYTES) != 0)
+    {
+        return false;
+    }
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        if (((*board)[row] & shots->explored[row]) != shots->ships[row])
+        {
+            return false;
+        }
+        if (sunk && ((*board)[row] & ~shots->explored[row]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Forgets both commitments.
+ */
+void commit_init(void)
+{
+    their_salt_ready = false;
+    revealed = false;
+    commit_result = COMMIT_PENDING;
+}
+
+/**
+ * @brief Commits to our board and sends the tag to the opponent.
+ *
+ * @param board Our board.
+ * @param reveal How our board is revealed once the game ends.
+ */
+void commit_send_our_board(const PredefinedBoard_t* board, const CommitReveal_t* reveal)
+{
+    CommitTag_t tag;
+
+    commit_salt_choose(&our_salt);
+    commit_hash(board, &our_salt, &tag);
+    our_reveal = *reveal;
+    opponent_send_our_commitment(&tag);
+}
+
+/**
+ * @brief Retrieves the tag of the opponent's board.
+ *
+ * @return true once the tag has been received.
+ */
+bool commit_receive_their_board(void)
+{
+    return opponent_get_their_commitment(&their_tag);
+}
+
+/**
+ * @brief Sends our salt and board to the opponent, as they were chosen.
+ */
+static void commit_reveal_our_board(void)
+{
+    opponent_send_our_salt(&our_salt);
+    if (our_reveal.id == RANDOM_BOARD_ID)
+    {
+        opponent_send_our_random_board(&our_reveal.random_board);
+    }
+    else if (our_reveal.id == BOARD_EDITOR_ID)
+    {
+        opponent_send_our_edited_board(our_reveal.code);
+    }
+    else
+    {
+        opponent_send_our_predefined_board_id(our_reveal.id);
+    }
+}
+
+/**
+ * @brief Retrieves the opponent's revealed board.
+ *
+ * An edited board is rebuilt from its code by a scheduler job, so it is
+ * received a few ticks after the code. A random board must be of the fleet
+ * we choose from, so the opponent cannot reveal a smaller one. A board which
+ * cannot be read is received as an empty board, so the check fails.
+ *
+ * @param board The board to fill with the opponent's ships.
+ * @return true once their board has been received, false while waiting.
+ */
+static bool commit_receive_their_reveal(PredefinedBoard_t* board)
+{
+    uint8_t id;
+    RandomBoard_t random_board;
+    uint32_t code;
+    bool read = false;
+
+    if (opponent_get_their_predefined_board_id(&id))
+    {
+        their_predefined_board_id = id;
+        read = predefined_board_read(id, board);
+    }
+    else if (opponent_get_their_random_board(&random_board))
+    {
+        their_predefined_board_id = RANDOM_BOARD_ID;
+        read = random_board.fleet == RANDOM_BOARD_FLEET && random_board_generate(&random_board, board);
+    }
+    else if (opponent_get_their_edited_board(&code))
+    {
+        their_predefined_board_id = BOARD_EDITOR_ID;
+        board_editor_rebuild_start(code);
+        return false;
+    }
+    else
+    {
+        return board_editor_rebuild_finished(board);
+    }
+
+    if (!read)
+    {
+        memset(*board, 0, sizeof(*board));
+    }
+    return true;
+}
+
+/**
+ * @brief Reveals both boards and checks theirs.
+ *
+ * Our board is revealed as soon as the game ends. Theirs is checked once
+ * both their salt and their board have arrived, and the result is shown
+ * after the result of the game has scrolled past.
+ */
+void update_verify_their_board(void)
+{
+    PredefinedBoard_t board;
+
+    if (!revealed)
+    {
+        revealed = true;
+        commit_reveal_our_board();
+    }
+    if (commit_result != COMMIT_PENDING || screen_scrolling_message_active())
+    {
+        return;
+    }
+
+    if (!their_salt_ready)
+    {
+        their_salt_ready = opponent_get_their_salt(&their_salt);
+    }
+    if (!their_salt_ready || !commit_receive_their_reveal(&board))
+    {
+        return;
+    }
+    bool matched = commit_check(&board, &their_salt, &their_tag, board_get(their_board), won_game);
+    commit_result = matched ? COMMIT_VERIFIED : COMMIT_MISMATCH;
+    screen_set_scrolling_text(matched ? MESSAGE_VERIFIED : MESSAGE_MISMATCH);
+    release_boards();
+}
+
+/**
+ * @brief Gets the result of checking the opponent's board.
+ *
+ * @return COMMIT_PENDING until their board has been revealed and checked.
+ */
+CommitResult_t commit_get_result(void)
+{
+    return commit_result;
+}
@@ -0,0 +1,124 @@
+/**
+ * @file   commit.h
+ * @brief  Header of the board commitments, which keep each player's board private until the game ends.
+ *
+ * Each board answers the shots fired at it, so neither player sends their
+ * board at the start of the game. Instead, once a board is chosen a random
+ * salt is drawn and the board's rows are hashed with HalfSipHash-2-4 keyed by
+ * the salt, and only the 8 byte tag is sent. The tag does not give away the
+ * board, and the player cannot swap their board later without changing it.
+ *
+ * When the game ends both players reveal their salt and their board, as the
+ * predefined board ID, the random board's seed or the edited board's code
+ * they would once have sent. Each then checks the tag, and that the revealed
+ * board gives the answer they received for every shot they fired.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef COMMIT_H
+#define COMMIT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+#include "random_board.h"
+
+#define COMMIT_SALT_BYTES 8     // Bytes of a salt, the key of the hash
+#define COMMIT_TAG_BYTES 8      // Bytes of a commitment tag
+#define COMMIT_STIR_SALT 0xFF00 // Event stirred in as a salt is drawn, no input has this kind
+
+/** @brief The salt keying the hash of a board. */
+typedef uint8_t CommitSalt_t[COMMIT_SALT_BYTES];
+
+/** @brief The tag committing to a board. */
+typedef uint8_t CommitTag_t[COMMIT_TAG_BYTES];
+
+/**
+ * @struct CommitReveal_t
+ * @brief  How a board is revealed once the game ends.
+ */
+typedef struct
+{
+    uint8_t id;                 /**< The predefined board ID, RANDOM_BOARD_ID or BOARD_EDITOR_ID. */
+    RandomBoard_t random_board; /**< The seed and fleet of a random board. */
+    uint32_t code;              /**< The fleet layout code of an edited board. */
+} CommitReveal_t;
+
+/**
+ * @enum  CommitResult_t
+ * @brief Whether the opponent's revealed board matched what they told us.
+ */
+typedef enum
+{
+    COMMIT_PENDING,  /**< The opponent's board has not been revealed and checked yet. */
+    COMMIT_VERIFIED, /**< The board matches the tag and every answer. */
+    COMMIT_MISMATCH, /**< The board does not match the tag or an answer. */
+} CommitResult_t;
+
+/**
+ * @brief Hashes a board with HalfSipHash-2-4 keyed by a salt.
+ * @param board The board, its rows are the message.
+ * @param salt The salt, the key.
+ * @param tag The tag to set.
+ */
+void commit_hash(const PredefinedBoard_t* board, const CommitSalt_t* salt, CommitTag_t* tag);
+
+/**
+ * @brief Stirs an input into the pool salts are drawn from, with the timer count it was read at.
+ * @param event The input read, its kind in the top byte and any data in the bottom.
+ */
+void commit_stir(uint16_t event);
+
+/**
+ * @brief Draws a new random salt from the inputs stirred in since reset.
+ * @param salt The salt to set.
+ */
+void commit_salt_choose(CommitSalt_t* salt);
+
+/**
+ * @brief  Checks a revealed board against a tag and the answers to our shots.
+ * @param  board: The revealed board.
+ * @param  salt: The revealed salt.
+ * @param  tag: The tag sent when the game started.
+ * @param  shots: Our shots at the board and which of them were answered as a hit.
+ * @param  sunk: true if the last answer said every ship was sunk.
+ * @return true if the board matches.
+ */
+bool commit_check(const PredefinedBoard_t* board, const CommitSalt_t* salt, const CommitTag_t* tag,
+                  const Board_t* shots, bool sunk);
+
+/**
+ * @brief Forgets both commitments, called when the game starts.
+ */
+void commit_init(void);
+
+/**
+ * @brief Commits to our board and sends the tag to the opponent.
+ * @param board Our board.
+ * @param reveal How our board is revealed once the game ends.
+ */
+void commit_send_our_board(const PredefinedBoard_t* board, const CommitReveal_t* reveal);
+
+/**
+ * @brief  Retrieves the tag of the opponent's board.
+ * @return true once the tag has been received.
+ */
+bool commit_receive_their_board(void);
+
+/**
+ * @brief Reveals both boards and checks theirs, run every tick in GAME_STATE_END.
+ *
+ * Once the result of the game has scrolled past, the result of the check is
+ * shown and the boards are released.
+ */
+void update_verify_their_board(void);
+
+/**
+ * @brief  Gets the result of checking the opponent's board.
+ * @return COMMIT_PENDING until their board has been revealed and checked.
+ */
+CommitResult_t commit_get_result(void);
+
+#endif /* COMMIT_H */
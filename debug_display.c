@@ -0,0 +1,125 @@
+/** 
+ * @file   debug_display.c
+ * @brief  Implementation of the debug display for the Battleship game.
+ *
+ * This file contains the implementation of the debug display, which scrolls
+ * the game's internal counters across the LED matrix so they can be read
+ * without a debugger. Numbers are written by hand as printf is too large
+ * for the flash.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "debug_display.h"
+#include "button.h"
+#include "screen.h"
+#include "game.h"
+#include "power.h"
+#include "scheduler.h"
+#include "memory.h"
+#include "input_trace.h"
+#include "opponent.h"
+
+/** @brief The text of the page being scrolled, it must outlive the message. */
+static char debug_text[DEBUG_DISPLAY_TEXT_SIZE];
+
+/** @brief Number of characters written to the text. */
+static uint8_t debug_text_length;
+
+/** @brief The page shown by the next button push. */
+static DebugPage_t debug_page = DEBUG_PAGE_OVERRUNS;
+
+/**
+ * @brief Appends a string to the page text, dropping what does not fit.
+ *
+ * @param text The string to append.
+ */
+static void debug_append(const char* text)
+{
+    while (*text && debug_text_length < DEBUG_DISPLAY_TEXT_SIZE - 1)
+    {
+        debug_text[debug_text_length++] = *text++;
+    }
+    debug_text[debug_text_length] = '\0';
+}
+
+/**
+ * @brief Appends a number in decimal to the page text, preceded by a space.
+ *
+ * @param value The number to append.
+ */
+static void debug_append_number(uint32_t value)
+{
+    char digits[11];
+    uint8_t index = sizeof(digits) - 1;
+
+    digits[index] = '\0';
+    do
+    {
+        digits[--index] = '0' + value % 10;
+        value /= 10;
+    } while (value != 0);
+    digits[--index] = ' ';
+    debug_append(&digits[index]);
+}
+
+/**
+ * @brief Writes the text of a page.
+ *
+ * @param page The page to write.
+ */
+static void debug_write_page(DebugPage_t page)
+{
+    debug_text_length = 0;
+    debug_text[0] = '\0';
+
+    switch (page)
+    {
+        case DEBUG_PAGE_OVERRUNS:
+            debug_append(" OVR");
+            for (uint8_t state = 0; state < POWER_STATES_NUM; state++)
+            {
+                debug_append_number(power_stats(state)->overruns);
+            }
+            debug_append(" SHED");
+            debug_append_number(scheduler_tasks_shed());
+            break;
+        case DEBUG_PAGE_MEMORY:
+            debug_append(" FREE");
+            debug_append_number(memory_free_min());
+            debug_append(" STACK");
+            debug_append_number(memory_stack_peak());
+            break;
+        default:
+            break;
+    }
+    debug_append(" ");
+}
+
+/**
+ * @brief Checks the button and scrolls the next debug page when it is pushed.
+ *
+ * Only the states waiting on the opponent or the end of the game leave the
+ * button free, in every other state it belongs to the state's handler. A
+ * game ended by the link being lost gives the button to starting a new game.
+ */
+void update_debug_display(void)
+{
+    GameState_t state = game_get_state();
+    if ((state != GAME_STATE_THEIR_TURN && state != GAME_STATE_AWAIT_SHOT_RESULT && state != GAME_STATE_END)
+        || opponent_link_lost())
+    {
+        return;
+    }
+
+    button_update();
+    if (input_trace_button(button_push_event_p(BUTTON1)))
+    {
+        debug_write_page(debug_page);
+        screen_set_scrolling_text(debug_text);
+        debug_page = (debug_page + 1) % DEBUG_PAGES_NUM;
+    }
+}
@@ -0,0 +1,42 @@
+/** 
+ * @file   debug_display.h
+ * @brief  Header of the debug display for the Battleship game.
+ *
+ * While waiting for the opponent's turn or once the game has ended, the
+ * button is otherwise unused. Pushing it then scrolls the next page of
+ * counters across the LED matrix.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef DEBUG_DISPLAY_H
+#define DEBUG_DISPLAY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Longest text a debug page scrolls, including the terminator.
+ */
+#define DEBUG_DISPLAY_TEXT_SIZE 64
+
+/**
+ * @enum  DebugPage_t
+ * @brief The pages of the debug display, shown in order.
+ */
+typedef enum {
+    DEBUG_PAGE_OVERRUNS, /**< Overruns in each game state, then the number of tasks shed. */
+    DEBUG_PAGE_MEMORY,   /**< The least free SRAM and the deepest stack since reset. */
+    DEBUG_PAGES_NUM,     /**< Number of pages. */
+} DebugPage_t;
+
+/**
+ * @brief Checks the button and scrolls the next debug page when it is pushed.
+ *
+ * This is run periodically by the scheduler and only reads the button in
+ * the game states which do not use it.
+ */
+void update_debug_display(void);
+
+#endif /* DEBUG_DISPLAY_H */
@@ -0,0 +1,748 @@
+/**
+ * @file   fleet_layout.c
+ * @brief  Implementation of the fleet layouts and their ranks.
+ *
+ * This file contains the walk through the canonical layouts in rank order,
+ * used by host/fleet_enumerate to rank every layout and generate the tables,
+ * and the counting which ranks and unranks a layout from those tables.
+ *
+ * The walk is a search over the ships in order. A ship's placement only
+ * moves on to placements which do not share a cell with the ships before it,
+ * and a ship of the same length as the one before starts after its
+ * placement, so no placement which could not be part of a layout is visited.
+ *
+ * The counting places the short ships one at a time, keeping the set of
+ * placements which still fit after those placed. A placement starts as many
+ * layouts as there are ways to place the ships left in the placements after
+ * it which do not share a cell with it. For one ship left that is the size
+ * of the set. For two it is every pair from the set less the pairs sharing a
+ * cell, and as two short ships share at most one cell each such pair is
+ * counted once by the number of placements covering each cell.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <string.h>
+#include <avr/pgmspace.h>
+#include "fleet_layout.h"
+
+/** @brief Length of each ship of the fleet. */
+static const uint8_t FLEET_SHIP_LENGTHS[FLEET_SHIPS_NUM] = FLEET_LENGTHS;
+
+/** @brief Number of short ships, placed by counting after the pair. */
+#define FLEET_SHORT_SHIPS (FLEET_SHIPS_NUM - FLEET_PAIR_SHIPS)
+
+/** @brief Number of placements of a short ship across the board, those down the board follow them. */
+#define FLEET_SHORT_ACROSS_NUM (BOARD_ROWS_NUM * (BOARD_COLS_NUM - FLEET_SHORT_LENGTH + 1))
+
+_Static_assert(FLEET_SHORT_LENGTH == 2, "the counting relies on two short ships sharing at most one cell");
+_Static_assert(FLEET_SHORT_SHIPS == 3, "the counting places exactly three short ships after the pair");
+
+#define FLEET_SET_HAS(set, placement) ((set)[(placement) >> 3] & (1 << ((placement) & 7))) // Checks a placement is in a set
+#define FLEET_SET_ADD(set, placement) ((set)[(placement) >> 3] |= (uint8_t) (1 << ((placement) & 7))) // Adds a placement to a set
+
+/**
+ * @brief Gets the number of placements of a ship.
+ *
+ * @param length The length of the ship.
+ * @return The number of placements across and down the board.
+ */
+uint8_t fleet_placements_num(uint8_t length)
+{
+    return BOARD_ROWS_NUM * (BOARD_COLS_NUM - length + 1) + (BOARD_ROWS_NUM - length + 1) * BOARD_COLS_NUM;
+}
+
+/**
+ * @brief Gets the cells of a ship's placement, adding them to a board or checking them against it.
+ *
+ * @param length The length of the ship.
+ * @param placement The index of the placement.
+ * @param board The board.
+ * @param add true to add the cells to the board, false to only check them.
+ * @return true if none of the cells were already on the board.
+ */
+static bool fleet_placement_cells(uint8_t length, uint8_t placement, PredefinedBoard_t* board, bool add)
+{
+    uint8_t across = BOARD_ROWS_NUM * (BOARD_COLS_NUM - length + 1);
+    bool free = true;
+
+    if (placement < across)
+    {
+        uint8_t row = placement / (BOARD_COLS_NUM - length + 1);
+        uint8_t col = placement % (BOARD_COLS_NUM - length + 1);
+        // the ship's cells are length bits starting at its leftmost column
+        uint8_t cells = (uint8_t) (((1 << length) - 1) << (BOARD_COLS_NUM - length - col));
+        free = !((*board)[row] & cells);
+        if (add)
+        {
+            (*board)[row] |= cells;
+        }
+        return free;
+    }
+
+    placement -= across;
+    uint8_t row = placement / BOARD_COLS_NUM;
+    uint8_t mask = BOARD_COL_MASK(placement % BOARD_COLS_NUM);
+    for (uint8_t k = 0; k < length; k++)
+    {
+        free = free && !((*board)[row + k] & mask);
+        if (add)
+        {
+            (*board)[row + k] |= mask;
+        }
+    }
+    return free;
+}
+
+/**
+ * @brief Searches for the next placement of every ship from one ship on.
+ *
+ * The ships before the one given keep their placements. The ship given moves
+ * on from its candidate placement, when it runs out of placements the ship
+ * before it moves on instead.
+ *
+ * @param layout The layout.
+ * @param ship The first ship to move.
+ * @param candidate The first placement tried for that ship.
+ * @return true if a layout was found, false once every ship has run out.
+ */
+static bool fleet_layout_search(FleetLayout_t* layout, int8_t ship, uint8_t candidate)
+{
+    while (ship >= 0)
+    {
+        uint8_t length = FLEET_SHIP_LENGTHS[ship];
+        uint8_t placements = fleet_placements_num(length);
+        PredefinedBoard_t board = {0};
+
+        for (uint8_t before = 0; before < ship; before++)
+        {
+            fleet_placement_cells(FLEET_SHIP_LENGTHS[before], layout->placements[before], &board, true);
+        }
+        while (candidate < placements && !fleet_placement_cells(length, candidate, &board, false))
+        {
+            candidate++;
+        }
+
+        if (candidate == placements)
+        {
+            // this ship has run out, so the ship before it moves on
+            ship--;
+            candidate = ship >= 0 ? layout->placements[ship] + 1 : 0;
+            continue;
+        }
+
+        layout->placements[ship++] = candidate;
+        if (ship == FLEET_SHIPS_NUM)
+        {
+            return true;
+        }
+        // a ship of the same length starts after the one before it, so each layout is listed once
+        candidate = FLEET_SHIP_LENGTHS[ship] == length ? layout->placements[ship - 1] + 1 : 0;
+    }
+    return false;
+}
+
+/**
+ * @brief Reflects the placement of a ship.
+ *
+ * @param length The length of the ship.
+ * @param placement The index of the placement.
+ * @param reflection Bit 0 reflects top to bottom, bit 1 left to right.
+ * @return The index of the reflected placement.
+ */
+uint8_t fleet_placement_reflect(uint8_t length, uint8_t placement, uint8_t reflection)
+{
+    uint8_t across = BOARD_ROWS_NUM * (BOARD_COLS_NUM - length + 1);
+    bool flip_rows = reflection & 1;
+    bool flip_cols = reflection & 2;
+
+    if (placement < across)
+    {
+        uint8_t starts = BOARD_COLS_NUM - length + 1;
+        uint8_t row = placement / starts;
+        uint8_t col = placement % starts;
+        row = flip_rows ? BOARD_ROWS_NUM - 1 - row : row;
+        col = flip_cols ? starts - 1 - col : col;
+        return row * starts + col;
+    }
+
+    placement -= across;
+    uint8_t row = placement / BOARD_COLS_NUM;
+    uint8_t col = placement % BOARD_COLS_NUM;
+    row = flip_rows ? BOARD_ROWS_NUM - length - row : row;
+    col = flip_cols ? BOARD_COLS_NUM - 1 - col : col;
+    return across + row * BOARD_COLS_NUM + col;
+}
+
+/**
+ * @brief Gets the index of a ship's placement.
+ *
+ * @param length The length of the ship.
+ * @param row The row index of the ship's top cell.
+ * @param col The column index of the ship's leftmost cell.
+ * @param down true if the ship runs down the board, false if across.
+ * @return The index of the placement among those of its length.
+ */
+uint8_t fleet_placement(uint8_t length, uint8_t row, uint8_t col, bool down)
+{
+    if (!down)
+    {
+        return row * (BOARD_COLS_NUM - length + 1) + col;
+    }
+    return BOARD_ROWS_NUM * (BOARD_COLS_NUM - length + 1) + row * BOARD_COLS_NUM + col;
+}
+
+/**
+ * @brief Reflects a layout, putting it back in order.
+ *
+ * Each ship is reflected, then the ships of the same length are sorted by
+ * placement again with an insertion sort.
+ *
+ * @param layout The layout to reflect.
+ * @param reflection Bit 0 reflects top to bottom, bit 1 left to right.
+ */
+void fleet_layout_reflect(FleetLayout_t* layout, uint8_t reflection)
+{
+    FleetLayout_t reflected;
+
+    for (uint8_t ship = 0; ship < FLEET_SHIPS_NUM; ship++)
+    {
+        uint8_t length = FLEET_SHIP_LENGTHS[ship];
+        uint8_t placement = fleet_placement_reflect(length, layout->placements[ship], reflection);
+        uint8_t at = ship;
+        while (at > 0 && FLEET_SHIP_LENGTHS[at - 1] == length && reflected.placements[at - 1] > placement)
+        {
+            reflected.placements[at] = reflected.placements[at - 1];
+            at--;
+        }
+        reflected.placements[at] = placement;
+    }
+    *layout = reflected;
+}
+
+/**
+ * @brief Checks if a layout is the canonical one among its reflections.
+ *
+ * Each reflection is compared with the layout ship by ship.
+ *
+ * @param layout A layout with no two ships sharing a cell.
+ * @return true if no reflection of the layout comes before it.
+ */
+bool fleet_layout_canonical(const FleetLayout_t* layout)
+{
+    for (uint8_t reflection = 1; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+    {
+        FleetLayout_t reflected = *layout;
+        fleet_layout_reflect(&reflected, reflection);
+        if (memcmp(reflected.placements, layout->placements, FLEET_SHIPS_NUM) < 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Replaces a layout with the canonical one among its reflections.
+ *
+ * Every reflection undoes itself, so reflecting the canonical layout with the
+ * reflection returned gives back the layout.
+ *
+ * @param layout A layout with no two ships sharing a cell, in any order.
+ * @return The reflection which took the layout to the canonical one.
+ */
+uint8_t fleet_layout_canonicalize(FleetLayout_t* layout)
+{
+    FleetLayout_t canonical = *layout;
+    uint8_t canonical_reflection = 0;
+
+    // reflection 0 only puts the layout in order
+    fleet_layout_reflect(&canonical, 0);
+    for (uint8_t reflection = 1; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+    {
+        FleetLayout_t reflected = *layout;
+        fleet_layout_reflect(&reflected, reflection);
+        if (memcmp(reflected.placements, canonical.placements, FLEET_SHIPS_NUM) < 0)
+        {
+            canonical = reflected;
+            canonical_reflection = reflection;
+        }
+    }
+    *layout = canonical;
+    return canonical_reflection;
+}
+
+/**
+ * @brief Sets a layout to the canonical layout of rank 0.
+ *
+ * @param layout The layout to set.
+ */
+void fleet_layout_first(FleetLayout_t* layout)
+{
+    fleet_layout_search(layout, 0, 0);
+    if (!fleet_layout_canonical(layout))
+    {
+        fleet_layout_next(layout);
+    }
+}
+
+/**
+ * @brief Moves a layout on to the canonical layout after it.
+ *
+ * @param layout A canonical layout, left unchanged if it is the last.
+ * @return true if there was a next layout.
+ */
+bool fleet_layout_next(FleetLayout_t* layout)
+{
+    FleetLayout_t next = *layout;
+
+    do
+    {
+        if (!fleet_layout_search(&next, FLEET_SHIPS_NUM - 1, next.placements[FLEET_SHIPS_NUM - 1] + 1))
+        {
+            return false;
+        }
+    } while (!fleet_layout_canonical(&next));
+    *layout = next;
+    return true;
+}
+
+/**
+ * @brief Builds the board of a layout.
+ *
+ * @param layout The layout.
+ * @param board The board to fill with the cells of every ship.
+ */
+void fleet_layout_board(const FleetLayout_t* layout, PredefinedBoard_t* board)
+{
+    memset(*board, 0, sizeof(*board));
+    for (uint8_t ship = 0; ship < FLEET_SHIPS_NUM; ship++)
+    {
+        fleet_placement_cells(FLEET_SHIP_LENGTHS[ship], layout->placements[ship], board, true);
+    }
+}
+
+/**
+ * @brief Gets the first cell of a short ship's placement, counting cells in row major order.
+ *
+ * @param placement The index of the placement.
+ * @return The index of the cell, the second cell is fleet_short_step() after it.
+ */
+static uint8_t fleet_short_cell(uint8_t placement)
+{
+    if (placement < FLEET_SHORT_ACROSS_NUM)
+    {
+        // each row has one start fewer than it has cells
+        return placement + placement / (BOARD_COLS_NUM - FLEET_SHORT_LENGTH + 1);
+    }
+    return placement - FLEET_SHORT_ACROSS_NUM;
+}
+
+/**
+ * @brief Gets the cells between the first and second cell of a short ship's placement.
+ *
+ * @param placement The index of the placement.
+ * @return 1 for a placement across the board, BOARD_COLS_NUM for one down it.
+ */
+static uint8_t fleet_short_step(uint8_t placement)
+{
+    return placement < FLEET_SHORT_ACROSS_NUM ? 1 : BOARD_COLS_NUM;
+}
+
+/**
+ * @brief Gets the placements after a short ship's placement which do not share a cell with it.
+ *
+ * @param free The set of placements which fit with the ships before.
+ * @param placement The placement of the ship, which need not be in the set.
+ * @param after The set to fill, which may be the same as free.
+ */
+static void fleet_short_after(const uint8_t* free, uint8_t placement, uint8_t* after)
+{
+    uint8_t first = fleet_short_cell(placement);
+    uint8_t second = first + fleet_short_step(placement);
+    uint8_t fits[FLEET_SHORT_SET_BYTES] = {0};
+
+    for (uint8_t other = placement + 1; other < FLEET_SHORT_PLACEMENTS_NUM; other++)
+    {
+        uint8_t cell = fleet_short_cell(other);
+        uint8_t next = cell + fleet_short_step(other);
+        if (FLEET_SET_HAS(free, other) && cell != first && cell != second && next != first && next != second)
+        {
+            FLEET_SET_ADD(fits, other);
+        }
+    }
+    memcpy(after, fits, sizeof(fits));
+}
+
+/**
+ * @brief Counts the ways to place two short ships in a set of placements without them sharing a cell.
+ *
+ * @param set The set of placements.
+ * @return The number of pairs of placements in the set which share no cell.
+ */
+static uint16_t fleet_short_pairs(const uint8_t* set)
+{
+    uint8_t covering[BOARD_ROWS_NUM * BOARD_COLS_NUM] = {0};
+    uint8_t placements = 0;
+    uint16_t pairs = 0;
+
+    for (uint8_t placement = 0; placement < FLEET_SHORT_PLACEMENTS_NUM; placement++)
+    {
+        if (FLEET_SET_HAS(set, placement))
+        {
+            uint8_t cell = fleet_short_cell(placement);
+            placements++;
+            covering[cell]++;
+            covering[cell + fleet_short_step(placement)]++;
+        }
+    }
+    pairs = (uint16_t) placements * (placements - 1) / 2;
+    for (uint8_t cell = 0; cell < BOARD_ROWS_NUM * BOARD_COLS_NUM; cell++)
+    {
+        // the pairs of placements covering a cell share it, and no other cell
+        pairs -= (uint16_t) covering[cell] * (covering[cell] - 1) / 2;
+    }
+    return pairs;
+}
+
+/**
+ * @brief Checks if the short ships of a layout come first among their reflections.
+ *
+ * Only the reflections which leave the pair as it is are checked, under any
+ * other the pair itself comes after it.
+ *
+ * @param reflections Bit r set when reflection r leaves the pair as it is.
+ * @param shorts The placements of the short ships, in order.
+ * @return true if the layout is canonical.
+ */
+static bool fleet_shorts_canonical(uint8_t reflections, const uint8_t* shorts)
+{
+    for (uint8_t reflection = 1; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+    {
+        if (!(reflections & (1 << reflection)))
+        {
+            continue;
+        }
+
+        uint8_t reflected[FLEET_SHORT_SHIPS];
+        for (uint8_t ship = 0; ship < FLEET_SHORT_SHIPS; ship++)
+        {
+            uint8_t placement = pgm_read_byte(&FLEET_SHORT_REFLECTIONS[reflection - 1][shorts[ship]]);
+            uint8_t at = ship;
+            while (at > 0 && reflected[at - 1] > placement)
+            {
+                reflected[at] = reflected[at - 1];
+                at--;
+            }
+            reflected[at] = placement;
+        }
+        if (memcmp(reflected, shorts, FLEET_SHORT_SHIPS) < 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Counts the canonical layouts starting with the ships placed and one placement of the ship being placed.
+ *
+ * Where no reflection leaves the pair as it is, every way to place the ships
+ * left is canonical, so they are counted from the set. Otherwise the counts
+ * for the third ship are read from FLEET_LAYOUT_COUNTS, and the layouts for
+ * the ships after it are checked one at a time.
+ *
+ * @param walk The walk.
+ * @param placement The placement of the ship being placed.
+ * @param after The placements after it which fit with it and the ships before.
+ * @return The number of layouts.
+ */
+static uint16_t fleet_walk_count(const FleetWalk_t* walk, uint8_t placement, const uint8_t* after)
+{
+    FleetLayoutPair_t pair;
+    uint8_t left = FLEET_SHIPS_NUM - 1 - walk->ship;
+    uint8_t shorts[FLEET_SHORT_SHIPS];
+    uint16_t layouts = 0;
+
+    memcpy_P(&pair, &FLEET_LAYOUT_PAIRS[walk->pair], sizeof(pair));
+    if (!pair.reflections)
+    {
+        if (left == 0)
+        {
+            return 1;
+        }
+        if (left == 1)
+        {
+            for (uint8_t other = placement + 1; other < FLEET_SHORT_PLACEMENTS_NUM; other++)
+            {
+                layouts += FLEET_SET_HAS(after, other) ? 1 : 0;
+            }
+            return layouts;
+        }
+        return fleet_short_pairs(after);
+    }
+
+    if (walk->ship == FLEET_PAIR_SHIPS)
+    {
+        uint16_t end = FLEET_LAYOUT_COUNTS_NUM;
+        if (walk->pair + 1 < FLEET_LAYOUT_PAIRS_NUM)
+        {
+            memcpy_P(&end, &FLEET_LAYOUT_PAIRS[walk->pair + 1].counts, sizeof(end));
+        }
+        for (uint16_t entry = pair.counts; entry < end; entry++)
+        {
+            FleetLayoutCount_t count;
+            memcpy_P(&count, &FLEET_LAYOUT_COUNTS[entry], sizeof(count));
+            if (count.placement == placement)
+            {
+                return count.layouts;
+            }
+        }
+        // the placements starting no layout are left out
+        return 0;
+    }
+
+    memcpy(shorts, &walk->layout.placements[FLEET_PAIR_SHIPS], FLEET_SHORT_SHIPS);
+    shorts[walk->ship - FLEET_PAIR_SHIPS] = placement;
+    if (left == 0)
+    {
+        return fleet_shorts_canonical(pair.reflections, shorts) ? 1 : 0;
+    }
+    for (uint8_t other = placement + 1; other < FLEET_SHORT_PLACEMENTS_NUM; other++)
+    {
+        shorts[FLEET_SHORT_SHIPS - 1] = other;
+        if (FLEET_SET_HAS(after, other) && fleet_shorts_canonical(pair.reflections, shorts))
+        {
+            layouts++;
+        }
+    }
+    return layouts;
+}
+
+/**
+ * @brief Starts a walk at the first short ship after a pair.
+ *
+ * The set of short placements which fit with the pair is built a row at a
+ * time from the pair's board.
+ *
+ * @param walk The walk to start.
+ * @param index The index of the pair in FLEET_LAYOUT_PAIRS.
+ */
+static void fleet_walk_start(FleetWalk_t* walk, uint16_t index)
+{
+    FleetLayoutPair_t pair;
+    PredefinedBoard_t board = {0};
+    uint8_t placement = 0;
+
+    memcpy_P(&pair, &FLEET_LAYOUT_PAIRS[index], sizeof(pair));
+    memset(walk->free, 0, sizeof(walk->free));
+    for (uint8_t ship = 0; ship < FLEET_PAIR_SHIPS; ship++)
+    {
+        walk->layout.placements[ship] = pair.placements[ship];
+        fleet_placement_cells(FLEET_SHIP_LENGTHS[ship], pair.placements[ship], &board, true);
+    }
+
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col + FLEET_SHORT_LENGTH <= BOARD_COLS_NUM; col++, placement++)
+        {
+            if (!(board[row] & (BOARD_COL_MASK(col) | BOARD_COL_MASK(col + 1))))
+            {
+                FLEET_SET_ADD(walk->free, placement);
+            }
+        }
+    }
+    for (uint8_t row = 0; row + FLEET_SHORT_LENGTH <= BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++, placement++)
+        {
+            if (!((board[row] | board[row + 1]) & BOARD_COL_MASK(col)))
+            {
+                FLEET_SET_ADD(walk->free, placement);
+            }
+        }
+    }
+
+    walk->pair = index;
+    walk->ship = FLEET_PAIR_SHIPS;
+    walk->candidate = 0;
+}
+
+/**
+ * @brief Gets the next placement of the ship being placed which fits with the ships before it.
+ *
+ * @param walk The walk.
+ * @return The placement, FLEET_SHORT_PLACEMENTS_NUM if none is left.
+ */
+static uint8_t fleet_walk_candidate(const FleetWalk_t* walk)
+{
+    uint8_t placement = walk->candidate;
+
+    while (placement < FLEET_SHORT_PLACEMENTS_NUM && !FLEET_SET_HAS(walk->free, placement))
+    {
+        placement++;
+    }
+    return placement;
+}
+
+/**
+ * @brief Places the ship being placed and moves the walk on to the next ship.
+ *
+ * @param walk The walk.
+ * @param placement The placement of the ship.
+ */
+static void fleet_walk_place(FleetWalk_t* walk, uint8_t placement)
+{
+    walk->layout.placements[walk->ship++] = placement;
+    fleet_short_after(walk->free, placement, walk->free);
+    walk->candidate = placement + 1;
+}
+
+/**
+ * @brief Starts rebuilding a layout from its rank.
+ *
+ * The pairs are in rank order, so they are searched for the last one whose
+ * first layout is at or before the rank, and the walk counts on from there.
+ *
+ * @param walk The walk to start.
+ * @param rank The rank of the layout, wrapped to below FLEET_LAYOUTS_NUM.
+ */
+void fleet_layout_unrank_start(FleetWalk_t* walk, uint32_t rank)
+{
+    uint16_t low = 0;
+    uint16_t high = FLEET_LAYOUT_PAIRS_NUM;
+
+    rank %= FLEET_LAYOUTS_NUM;
+    // the first pair starts at rank 0, so it is always at or before the rank
+    while (high - low > 1)
+    {
+        uint16_t middle = (low + high) / 2;
+        uint32_t first;
+        memcpy_P(&first, &FLEET_LAYOUT_PAIRS[middle].first, sizeof(first));
+        if (first <= rank)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    fleet_walk_start(walk, low);
+    memcpy_P(&walk->rank, &FLEET_LAYOUT_PAIRS[low].first, sizeof(walk->rank));
+    walk->rank = rank - walk->rank;
+}
+
+/**
+ * @brief Counts the layouts one placement of the ship being placed starts.
+ *
+ * If the layouts left to skip are fewer, the layout is among them and the
+ * ship takes the placement, otherwise they are all skipped.
+ *
+ * @param state The FleetWalk_t being unranked.
+ * @return true once the layout of the rank has been reached.
+ */
+bool fleet_layout_unrank_step(void* state)
+{
+    FleetWalk_t* walk = state;
+    uint8_t placement = fleet_walk_candidate(walk);
+    uint8_t after[FLEET_SHORT_SET_BYTES];
+    uint16_t layouts;
+
+    fleet_short_after(walk->free, placement, after);
+    layouts = fleet_walk_count(walk, placement, after);
+    if (walk->rank < layouts)
+    {
+        fleet_walk_place(walk, placement);
+    }
+    else
+    {
+        walk->rank -= layouts;
+        walk->candidate = placement + 1;
+    }
+    return walk->ship == FLEET_SHIPS_NUM;
+}
+
+/**
+ * @brief Starts finding the rank of a canonical layout.
+ *
+ * The pairs are searched for the layout's first two placements, and the walk
+ * counts on from the rank of the pair's first layout.
+ *
+ * @param walk The walk to start.
+ * @param layout A canonical layout, see fleet_layout_canonicalize().
+ */
+void fleet_layout_rank_start(FleetWalk_t* walk, const FleetLayout_t* layout)
+{
+    uint16_t low = 0;
+    uint16_t high = FLEET_LAYOUT_PAIRS_NUM;
+
+    // a canonical layout's pair is always in the table, the first at or before it
+    while (high - low > 1)
+    {
+        uint16_t middle = (low + high) / 2;
+        uint8_t placements[FLEET_PAIR_SHIPS];
+        memcpy_P(placements, FLEET_LAYOUT_PAIRS[middle].placements, sizeof(placements));
+        if (memcmp(placements, layout->placements, FLEET_PAIR_SHIPS) <= 0)
+        {
+            low = middle;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    fleet_walk_start(walk, low);
+    memcpy(&walk->layout.placements[FLEET_PAIR_SHIPS], &layout->placements[FLEET_PAIR_SHIPS], FLEET_SHORT_SHIPS);
+    memcpy_P(&walk->rank, &FLEET_LAYOUT_PAIRS[low].first, sizeof(walk->rank));
+}
+
+/**
+ * @brief Counts the layouts one placement before that of the ship being ranked starts.
+ *
+ * Once the walk reaches the ship's own placement the ship takes it and the
+ * walk moves on to the next ship.
+ *
+ * @param state The FleetWalk_t being ranked.
+ * @return true once the rank has been found.
+ */
+bool fleet_layout_rank_step(void* state)
+{
+    FleetWalk_t* walk = state;
+    uint8_t placement = fleet_walk_candidate(walk);
+    uint8_t target = walk->layout.placements[walk->ship];
+    uint8_t after[FLEET_SHORT_SET_BYTES];
+
+    if (placement >= target)
+    {
+        fleet_walk_place(walk, target);
+    }
+    else
+    {
+        fleet_short_after(walk->free, placement, after);
+        walk->rank += fleet_walk_count(walk, placement, after);
+        walk->candidate = placement + 1;
+    }
+    return walk->ship == FLEET_SHIPS_NUM;
+}
+
+/**
+ * @brief Rebuilds the board of a layout from its rank, running every step at once.
+ *
+ * This takes at most FLEET_LAYOUT_STEPS_MAX steps, but the game still runs
+ * them as a scheduler job so no tick runs long.
+ *
+ * @param rank The rank of the layout, wrapped to below FLEET_LAYOUTS_NUM.
+ * @param board The board to fill with the cells of every ship.
+ */
+void fleet_layout_unrank(uint32_t rank, PredefinedBoard_t* board)
+{
+    FleetWalk_t walk;
+
+    fleet_layout_unrank_start(&walk, rank);
+    while (!fleet_layout_unrank_step(&walk))
+    {
+    }
+    fleet_layout_board(&walk.layout, board);
+}
@@ -0,0 +1,269 @@
+/**
+ * @file   fleet_layout.h
+ * @brief  Header of the fleet layouts, every placement of the fleet on the board with a dense rank.
+ *
+ * A fleet layout places each ship of FLEET_LENGTHS on the board without two
+ * ships sharing a cell. Each ship is given by the index of its placement
+ * among those of its length: every placement across the board in row major
+ * order of its leftmost cell, then every placement down the board in row
+ * major order of its top cell. Ships of the same length are kept in
+ * increasing order of placement, so each layout is listed once.
+ *
+ * Layouts which are a reflection of each other, top to bottom, left to right
+ * or both, are the same layout. Only the canonical one of each is kept, the
+ * one whose placements, compared ship by ship, come first.
+ *
+ * The canonical layouts are ranked from 0 in the order of their placements,
+ * so a layout can be sent as its rank in FLEET_LAYOUT_RANK_BYTES bytes and
+ * rebuilt with fleet_layout_unrank(). Ranking and unranking count layouts
+ * rather than walk through them. The first two ships are looked up in a
+ * table of the pairs of placements which start a canonical layout, with the
+ * rank of the first layout of each. The short ships after them are counted
+ * one placement at a time: the layouts a placement starts are the ways the
+ * ships left fit in the cells still free, counted from the cells each free
+ * placement covers. Where a reflection leaves the pair as it is, only the
+ * short ships tell a layout from its reflection, so those layouts are
+ * counted one at a time and the counts for the third ship are kept in a
+ * second table. A walk is split into steps, one placement each, so it can
+ * run as a scheduler job, see scheduler.h.
+ *
+ * The tables are generated by host/fleet_enumerate, see fleet_layout_table.c.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef FLEET_LAYOUT_H
+#define FLEET_LAYOUT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+
+/**
+ * @brief Lengths of the ships of the fleet, those on predefined boards 1 to 5, ships of the same length together.
+ */
+#define FLEET_LENGTHS {3, 3, 2, 2, 2}
+
+/**
+ * @brief Number of ships in FLEET_LENGTHS.
+ */
+#define FLEET_SHIPS_NUM 5
+
+/**
+ * @brief Number of ships at the start of FLEET_LENGTHS placed by FLEET_LAYOUT_PAIRS.
+ */
+#define FLEET_PAIR_SHIPS 2
+
+/**
+ * @brief Length of the ships after the pair, which are counted rather than looked up.
+ */
+#define FLEET_SHORT_LENGTH 2
+
+/**
+ * @brief Number of placements of a short ship.
+ */
+#define FLEET_SHORT_PLACEMENTS_NUM \
+    (BOARD_ROWS_NUM * (BOARD_COLS_NUM - FLEET_SHORT_LENGTH + 1) + (BOARD_ROWS_NUM - FLEET_SHORT_LENGTH + 1) * BOARD_COLS_NUM)
+
+/**
+ * @brief Bytes of a set of short ship placements, one bit each.
+ */
+#define FLEET_SHORT_SET_BYTES ((FLEET_SHORT_PLACEMENTS_NUM + 7) / 8)
+
+/**
+ * @brief Steps a rank or unrank walk takes at most, one for each placement of each short ship.
+ */
+#define FLEET_LAYOUT_STEPS_MAX ((FLEET_SHIPS_NUM - FLEET_PAIR_SHIPS) * FLEET_SHORT_PLACEMENTS_NUM)
+
+/**
+ * @brief Bytes needed to send a rank, enough for every layout.
+ */
+#define FLEET_LAYOUT_RANK_BYTES 3
+
+/**
+ * @brief Bits of a layout code holding the rank, the reflection is in the 3 bits above them.
+ *
+ * A layout code gives a layout which need not be canonical, as the rank of
+ * its canonical layout and the reflection taking that back to it, in
+ * FLEET_LAYOUT_RANK_BYTES bytes. A code whose reflection is not below
+ * FLEET_LAYOUT_REFLECTIONS_NUM is not valid.
+ */
+#define FLEET_LAYOUT_CODE_RANK_BITS 21
+
+/**
+ * @brief Number of reflections of a layout, counting the one leaving it as it is.
+ */
+#define FLEET_LAYOUT_REFLECTIONS_NUM 4
+
+#define FLEET_LAYOUT_CODE(rank, reflection) \
+    ((uint32_t) (rank) | ((uint32_t) (reflection) << FLEET_LAYOUT_CODE_RANK_BITS)) // Packs a layout code
+#define FLEET_LAYOUT_CODE_RANK(code) ((code) & ((1UL << FLEET_LAYOUT_CODE_RANK_BITS) - 1)) // Rank of a layout code
+#define FLEET_LAYOUT_CODE_REFLECTION(code) ((uint8_t) ((code) >> FLEET_LAYOUT_CODE_RANK_BITS)) // Reflection of a layout code
+
+/**
+ * @struct FleetLayout_t
+ * @brief  A placement of every ship of the fleet.
+ */
+typedef struct
+{
+    uint8_t placements[FLEET_SHIPS_NUM]; /**< Index of each ship's placement among those of its length. */
+} FleetLayout_t;
+
+/**
+ * @struct FleetLayoutPair_t
+ * @brief  Placements of the first two ships which start a canonical layout.
+ */
+typedef struct
+{
+    uint8_t placements[FLEET_PAIR_SHIPS]; /**< The placements of the first two ships. */
+    uint8_t reflections;                  /**< Bit r set when reflection r leaves the pair as it is, 0 for most pairs. */
+    uint16_t counts;                      /**< Index of the pair's first entry in FLEET_LAYOUT_COUNTS, which only pairs with reflections have. */
+    uint32_t first;                       /**< The rank of the first layout starting with the pair. */
+} FleetLayoutPair_t;
+
+/**
+ * @struct FleetLayoutCount_t
+ * @brief  Number of canonical layouts starting with a pair which has reflections and a placement of the third ship.
+ */
+typedef struct
+{
+    uint8_t placement; /**< The placement of the third ship. */
+    uint16_t layouts;  /**< The canonical layouts starting with the pair and that placement. */
+} FleetLayoutCount_t;
+
+/**
+ * @struct FleetWalk_t
+ * @brief  State of a walk ranking or unranking a layout, kept between its steps.
+ */
+typedef struct
+{
+    FleetLayout_t layout;                /**< The layout being ranked, or the placements unranked so far. */
+    uint32_t rank;                       /**< The layouts before the layout being ranked, or those still to skip when unranking. */
+    uint8_t free[FLEET_SHORT_SET_BYTES]; /**< Placements of the ship being placed which fit with those before it. */
+    uint16_t pair;                       /**< Index of the first two placements in FLEET_LAYOUT_PAIRS. */
+    uint8_t ship;                        /**< The ship being placed, FLEET_SHIPS_NUM once the walk finishes. */
+    uint8_t candidate;                   /**< The next placement of that ship to count. */
+} FleetWalk_t;
+
+/** @brief Number of canonical layouts, generated by host/fleet_enumerate. */
+extern const uint32_t FLEET_LAYOUTS_NUM;
+
+/** @brief Number of pairs in FLEET_LAYOUT_PAIRS, generated by host/fleet_enumerate. */
+extern const uint16_t FLEET_LAYOUT_PAIRS_NUM;
+
+/** @brief Every pair of placements of the first two ships starting a canonical layout, in rank order, in program memory. */
+extern const FleetLayoutPair_t FLEET_LAYOUT_PAIRS[];
+
+/** @brief Number of entries in FLEET_LAYOUT_COUNTS, generated by host/fleet_enumerate. */
+extern const uint16_t FLEET_LAYOUT_COUNTS_NUM;
+
+/** @brief The layouts each third placement starts, for the pairs which have reflections, in program memory. */
+extern const FleetLayoutCount_t FLEET_LAYOUT_COUNTS[];
+
+/** @brief Each placement of a short ship under reflections 1 to 3, in program memory. */
+extern const uint8_t FLEET_SHORT_REFLECTIONS[FLEET_LAYOUT_REFLECTIONS_NUM - 1][FLEET_SHORT_PLACEMENTS_NUM];
+
+/**
+ * @brief  Gets the number of placements of a ship.
+ * @param  length: The length of the ship.
+ * @return The number of placements across and down the board.
+ */
+uint8_t fleet_placements_num(uint8_t length);
+
+/**
+ * @brief  Sets a layout to the canonical layout of rank 0.
+ * @param  layout: The layout to set.
+ */
+void fleet_layout_first(FleetLayout_t* layout);
+
+/**
+ * @brief  Moves a layout on to the canonical layout after it.
+ * @param  layout: A canonical layout, left unchanged if it is the last.
+ * @return true if there was a next layout.
+ */
+bool fleet_layout_next(FleetLayout_t* layout);
+
+/**
+ * @brief  Gets the index of a ship's placement.
+ * @param  length: The length of the ship.
+ * @param  row: The row index of the ship's top cell.
+ * @param  col: The column index of the ship's leftmost cell.
+ * @param  down: true if the ship runs down the board, false if across.
+ * @return The index of the placement among those of its length.
+ */
+uint8_t fleet_placement(uint8_t length, uint8_t row, uint8_t col, bool down);
+
+/**
+ * @brief  Reflects the placement of a ship.
+ * @param  length: The length of the ship.
+ * @param  placement: The index of the placement.
+ * @param  reflection: Bit 0 reflects top to bottom, bit 1 left to right.
+ * @return The index of the reflected placement.
+ */
+uint8_t fleet_placement_reflect(uint8_t length, uint8_t placement, uint8_t reflection);
+
+/**
+ * @brief  Reflects a layout, putting the ships of the same length back in order.
+ * @param  layout: The layout to reflect.
+ * @param  reflection: Bit 0 reflects top to bottom, bit 1 left to right, 0 only puts the layout in order.
+ */
+void fleet_layout_reflect(FleetLayout_t* layout, uint8_t reflection);
+
+/**
+ * @brief  Replaces a layout with the canonical one among its reflections.
+ * @param  layout: A layout with no two ships sharing a cell, in any order.
+ * @return The reflection which gives back the layout when applied to the canonical one.
+ */
+uint8_t fleet_layout_canonicalize(FleetLayout_t* layout);
+
+/**
+ * @brief  Checks if a layout is the canonical one among its reflections.
+ * @param  layout: A layout with no two ships sharing a cell.
+ * @return true if no reflection of the layout comes before it.
+ */
+bool fleet_layout_canonical(const FleetLayout_t* layout);
+
+/**
+ * @brief  Builds the board of a layout.
+ * @param  layout: The layout.
+ * @param  board: The board to fill with the cells of every ship.
+ */
+void fleet_layout_board(const FleetLayout_t* layout, PredefinedBoard_t* board);
+
+/**
+ * @brief  Starts rebuilding a layout from its rank, run the steps with fleet_layout_unrank_step().
+ * @param  walk: The walk to start.
+ * @param  rank: The rank of the layout, wrapped to below FLEET_LAYOUTS_NUM.
+ */
+void fleet_layout_unrank_start(FleetWalk_t* walk, uint32_t rank);
+
+/**
+ * @brief  Counts the layouts one placement of the ship being placed starts, a scheduler job step.
+ * @param  state: The FleetWalk_t being unranked.
+ * @return true once the layout of the rank has been reached.
+ */
+bool fleet_layout_unrank_step(void* state);
+
+/**
+ * @brief  Starts finding the rank of a canonical layout, run the steps with fleet_layout_rank_step().
+ * @param  walk: The walk to start.
+ * @param  layout: A canonical layout, see fleet_layout_canonicalize().
+ */
+void fleet_layout_rank_start(FleetWalk_t* walk, const FleetLayout_t* layout);
+
+/**
+ * @brief  Counts the layouts one placement before that of the ship being ranked starts, a scheduler job step.
+ * @param  state: The FleetWalk_t being ranked.
+ * @return true once the rank has been found.
+ */
+bool fleet_layout_rank_step(void* state);
+
+/**
+ * @brief  Rebuilds the board of a layout from its rank, running every step at once.
+ * @param  rank: The rank of the layout, wrapped to below FLEET_LAYOUTS_NUM.
+ * @param  board: The board to fill with the cells of every ship.
+ */
+void fleet_layout_unrank(uint32_t rank, PredefinedBoard_t* board);
+
+#endif /* FLEET_LAYOUT_H */
@@ -0,0 +1,1206 @@
+/**
+ * @file   fleet_layout_table.c
+ * @brief  Rank tables of the fleet layouts, generated by host/fleet_enumerate -t, do not edit.
+ *
+ * The 237 pairs of placements of the first two ships starting the 1722857 canonical
+ * layouts, the counts for the third ship of the pairs a reflection leaves as
+ * they are and the reflections of the short placements, see fleet_layout.h.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <avr/pgmspace.h>
+#include "fleet_layout.h"
+
+const uint32_t FLEET_LAYOUTS_NUM = 1722857UL;
+
+const uint16_t FLEET_LAYOUT_PAIRS_NUM = 237;
+
+const FleetLayoutPair_t FLEET_LAYOUT_PAIRS[] PROGMEM = {
+    {{0, 3}, 0, 0, 0UL},
+    {{0, 4}, 0, 0, 10838UL},
+    {{0, 5}, 0, 0, 20221UL},
+    {{0, 6}, 0, 0, 29572UL},
+    {{0, 7}, 0, 0, 38363UL},
+    {{0, 8}, 0, 0, 46630UL},
+    {{0, 9}, 0, 0, 55489UL},
+    {{0, 10}, 0, 0, 64376UL},
+    {{0, 11}, 0, 0, 72698UL},
+    {{0, 12}, 0, 0, 81583UL},
+    {{0, 13}, 0, 0, 90470UL},
+    {{0, 14}, 0, 0, 98793UL},
+    {{0, 15}, 0, 0, 107680UL},
+    {{0, 16}, 0, 0, 116473UL},
+    {{0, 17}, 0, 0, 124711UL},
+    {{0, 18}, 2, 0, 133504UL},
+    {{0, 19}, 0, 23, 138937UL},
+    {{0, 20}, 8, 23, 148973UL},
+    {{0, 24}, 0, 45, 154374UL},
+    {{0, 25}, 0, 45, 163792UL},
+    {{0, 26}, 0, 45, 174556UL},
+    {{0, 27}, 0, 45, 185357UL},
+    {{0, 28}, 0, 45, 194148UL},
+    {{0, 29}, 0, 45, 203069UL},
+    {{0, 30}, 0, 45, 211271UL},
+    {{0, 31}, 0, 45, 221345UL},
+    {{0, 32}, 0, 45, 231417UL},
+    {{0, 33}, 0, 45, 239682UL},
+    {{0, 34}, 0, 45, 248033UL},
+    {{0, 35}, 0, 45, 256328UL},
+    {{0, 36}, 0, 45, 266436UL},
+    {{0, 37}, 0, 45, 276508UL},
+    {{0, 38}, 0, 45, 284773UL},
+    {{0, 39}, 0, 45, 293126UL},
+    {{0, 40}, 0, 45, 301390UL},
+    {{0, 41}, 0, 45, 311461UL},
+    {{0, 42}, 0, 45, 322262UL},
+    {{0, 43}, 0, 45, 331054UL},
+    {{0, 44}, 0, 45, 339943UL},
+    {{0, 45}, 0, 45, 348735UL},
+    {{1, 3}, 0, 45, 359536UL},
+    {{1, 4}, 4, 45, 368808UL},
+    {{1, 6}, 0, 68, 373530UL},
+    {{1, 7}, 4, 68, 381698UL},
+    {{1, 9}, 0, 89, 385522UL},
+    {{1, 10}, 4, 89, 393745UL},
+    {{1, 12}, 0, 110, 397612UL},
+    {{1, 13}, 4, 110, 405836UL},
+    {{1, 15}, 0, 131, 409703UL},
+    {{1, 16}, 4, 131, 417836UL},
+    {{1, 19}, 14, 151, 421662UL},
+    {{1, 21}, 0, 163, 424019UL},
+    {{1, 26}, 0, 163, 434783UL},
+    {{1, 27}, 0, 163, 444055UL},
+    {{1, 28}, 4, 163, 452222UL},
+    {{1, 31}, 0, 184, 456351UL},
+    {{1, 32}, 0, 184, 465732UL},
+    {{1, 33}, 4, 184, 473366UL},
+    {{1, 36}, 0, 204, 477235UL},
+    {{1, 37}, 0, 204, 486577UL},
+    {{1, 38}, 4, 204, 494213UL},
+    {{1, 41}, 0, 224, 498082UL},
+    {{1, 42}, 0, 224, 508117UL},
+    {{1, 43}, 4, 224, 516249UL},
+    {{3, 6}, 0, 245, 520379UL},
+    {{3, 7}, 0, 245, 529204UL},
+    {{3, 8}, 0, 245, 536811UL},
+    {{3, 9}, 0, 245, 544423UL},
+    {{3, 10}, 0, 245, 551499UL},
+    {{3, 11}, 0, 245, 558135UL},
+    {{3, 12}, 0, 245, 565271UL},
+    {{3, 13}, 0, 245, 572437UL},
+    {{3, 14}, 0, 245, 579126UL},
+    {{3, 15}, 2, 245, 586290UL},
+    {{3, 16}, 0, 265, 589855UL},
+    {{3, 17}, 8, 265, 596466UL},
+    {{3, 24}, 0, 284, 600005UL},
+    {{3, 25}, 0, 284, 607523UL},
+    {{3, 29}, 0, 284, 616287UL},
+    {{3, 30}, 0, 284, 623371UL},
+    {{3, 31}, 0, 284, 631507UL},
+    {{3, 32}, 0, 284, 640300UL},
+    {{3, 33}, 0, 284, 647377UL},
+    {{3, 34}, 0, 284, 654571UL},
+    {{3, 35}, 0, 284, 661178UL},
+    {{3, 36}, 0, 284, 669380UL},
+    {{3, 37}, 0, 284, 677513UL},
+    {{3, 38}, 0, 284, 684124UL},
+    {{3, 39}, 0, 284, 690812UL},
+    {{3, 40}, 0, 284, 697449UL},
+    {{3, 41}, 0, 284, 705614UL},
+    {{3, 42}, 0, 284, 714407UL},
+    {{3, 43}, 0, 284, 721485UL},
+    {{3, 44}, 0, 284, 728651UL},
+    {{3, 45}, 0, 284, 735728UL},
+    {{4, 6}, 0, 284, 744520UL},
+    {{4, 7}, 4, 284, 752133UL},
+    {{4, 9}, 0, 305, 755993UL},
+    {{4, 10}, 4, 305, 762635UL},
+    {{4, 12}, 0, 324, 765731UL},
+    {{4, 13}, 4, 324, 772426UL},
+    {{4, 16}, 14, 343, 775562UL},
+    {{4, 21}, 0, 353, 777123UL},
+    {{4, 26}, 0, 353, 785886UL},
+    {{4, 31}, 0, 353, 794059UL},
+    {{4, 32}, 0, 353, 801673UL},
+    {{4, 33}, 4, 353, 808315UL},
+    {{4, 36}, 0, 372, 811670UL},
+    {{4, 37}, 0, 372, 819314UL},
+    {{4, 38}, 4, 372, 825482UL},
+    {{4, 41}, 0, 390, 828605UL},
+    {{4, 42}, 0, 390, 836842UL},
+    {{4, 43}, 4, 390, 843453UL},
+    {{6, 9}, 0, 409, 846809UL},
+    {{6, 10}, 0, 409, 855728UL},
+    {{6, 11}, 0, 409, 863422UL},
+    {{6, 12}, 2, 409, 871120UL},
+    {{6, 13}, 0, 429, 874734UL},
+    {{6, 14}, 8, 429, 881455UL},
+    {{6, 24}, 0, 448, 885067UL},
+    {{6, 25}, 0, 448, 892709UL},
+    {{6, 29}, 0, 448, 901565UL},
+    {{6, 30}, 0, 448, 908706UL},
+    {{6, 34}, 0, 448, 916935UL},
+    {{6, 35}, 0, 448, 924132UL},
+    {{6, 36}, 0, 448, 932393UL},
+    {{6, 37}, 0, 448, 941246UL},
+    {{6, 38}, 0, 448, 948383UL},
+    {{6, 39}, 0, 448, 955637UL},
+    {{6, 40}, 0, 448, 962301UL},
+    {{6, 41}, 0, 448, 970560UL},
+    {{6, 42}, 0, 448, 979413UL},
+    {{6, 43}, 0, 448, 986551UL},
+    {{6, 44}, 0, 448, 993775UL},
+    {{6, 45}, 0, 448, 1000940UL},
+    {{7, 9}, 0, 448, 1009826UL},
+    {{7, 10}, 4, 448, 1017520UL},
+    {{7, 13}, 14, 469, 1021421UL},
+    {{7, 21}, 0, 479, 1023003UL},
+    {{7, 26}, 0, 479, 1031893UL},
+    {{7, 31}, 0, 479, 1040120UL},
+    {{7, 36}, 0, 479, 1048414UL},
+    {{7, 37}, 0, 479, 1056077UL},
+    {{7, 38}, 4, 479, 1062771UL},
+    {{7, 41}, 0, 498, 1066152UL},
+    {{7, 42}, 0, 498, 1074477UL},
+    {{7, 43}, 4, 498, 1081138UL},
+    {{9, 21}, 0, 517, 1084520UL},
+    {{9, 22}, 0, 517, 1094033UL},
+    {{9, 23}, 0, 517, 1101637UL},
+    {{9, 24}, 0, 517, 1109368UL},
+    {{9, 25}, 0, 517, 1116473UL},
+    {{9, 29}, 0, 517, 1125359UL},
+    {{9, 30}, 0, 517, 1132527UL},
+    {{9, 34}, 2, 517, 1140751UL},
+    {{9, 35}, 2, 535, 1144333UL},
+    {{10, 21}, 0, 554, 1148463UL},
+    {{10, 22}, 0, 554, 1156720UL},
+    {{10, 23}, 4, 554, 1163856UL},
+    {{10, 26}, 0, 574, 1167470UL},
+    {{10, 31}, 2, 574, 1175727UL},
+    {{21, 22}, 0, 593, 1179856UL},
+    {{21, 23}, 0, 593, 1190692UL},
+    {{21, 24}, 0, 593, 1199484UL},
+    {{21, 25}, 4, 593, 1208278UL},
+    {{21, 27}, 0, 618, 1213719UL},
+    {{21, 28}, 0, 618, 1223129UL},
+    {{21, 29}, 0, 618, 1231424UL},
+    {{21, 30}, 0, 618, 1239689UL},
+    {{21, 32}, 0, 618, 1249759UL},
+    {{21, 33}, 0, 618, 1258581UL},
+    {{21, 34}, 0, 618, 1266933UL},
+    {{21, 35}, 0, 618, 1275225UL},
+    {{21, 36}, 0, 618, 1285332UL},
+    {{21, 37}, 0, 618, 1296131UL},
+    {{21, 38}, 0, 618, 1304332UL},
+    {{21, 39}, 0, 618, 1312686UL},
+    {{21, 40}, 0, 618, 1320949UL},
+    {{21, 41}, 2, 618, 1331019UL},
+    {{21, 42}, 0, 641, 1336434UL},
+    {{21, 43}, 0, 641, 1345228UL},
+    {{21, 44}, 0, 641, 1354116UL},
+    {{21, 45}, 8, 641, 1362907UL},
+    {{22, 23}, 0, 663, 1368307UL},
+    {{22, 24}, 4, 663, 1377133UL},
+    {{22, 26}, 0, 685, 1380670UL},
+    {{22, 28}, 0, 685, 1389975UL},
+    {{22, 29}, 0, 685, 1397609UL},
+    {{22, 30}, 0, 685, 1404194UL},
+    {{22, 31}, 0, 685, 1412360UL},
+    {{22, 33}, 0, 685, 1421086UL},
+    {{22, 34}, 0, 685, 1428249UL},
+    {{22, 35}, 0, 685, 1434884UL},
+    {{22, 36}, 0, 685, 1443083UL},
+    {{22, 37}, 0, 685, 1451185UL},
+    {{22, 38}, 0, 685, 1458297UL},
+    {{22, 39}, 0, 685, 1464957UL},
+    {{22, 40}, 0, 685, 1471593UL},
+    {{22, 42}, 2, 685, 1479757UL},
+    {{22, 43}, 0, 705, 1483309UL},
+    {{22, 44}, 8, 705, 1490476UL},
+    {{23, 26}, 0, 724, 1494014UL},
+    {{23, 27}, 0, 724, 1502216UL},
+    {{23, 31}, 0, 724, 1509856UL},
+    {{23, 32}, 0, 724, 1518121UL},
+    {{23, 36}, 0, 724, 1525290UL},
+    {{23, 37}, 0, 724, 1533551UL},
+    {{23, 38}, 4, 724, 1540217UL},
+    {{23, 43}, 14, 743, 1543859UL},
+    {{26, 27}, 0, 753, 1545679UL},
+    {{26, 28}, 0, 753, 1555127UL},
+    {{26, 29}, 0, 753, 1562792UL},
+    {{26, 30}, 4, 753, 1570461UL},
+    {{26, 32}, 0, 777, 1575187UL},
+    {{26, 33}, 0, 777, 1583971UL},
+    {{26, 34}, 0, 777, 1591695UL},
+    {{26, 35}, 0, 777, 1599390UL},
+    {{26, 37}, 0, 777, 1608802UL},
+    {{26, 38}, 0, 777, 1616968UL},
+    {{26, 39}, 0, 777, 1624693UL},
+    {{26, 40}, 8, 777, 1632360UL},
+    {{27, 28}, 0, 798, 1637048UL},
+    {{27, 29}, 4, 798, 1644781UL},
+    {{27, 31}, 0, 819, 1647889UL},
+    {{27, 33}, 0, 819, 1656679UL},
+    {{27, 34}, 0, 819, 1663873UL},
+    {{27, 35}, 0, 819, 1670065UL},
+    {{27, 38}, 0, 819, 1677766UL},
+    {{27, 39}, 8, 819, 1684458UL},
+    {{28, 31}, 0, 837, 1687554UL},
+    {{28, 32}, 0, 837, 1695284UL},
+    {{31, 32}, 2, 837, 1702478UL},
+    {{31, 33}, 2, 858, 1707254UL},
+    {{31, 34}, 2, 877, 1711125UL},
+    {{31, 35}, 14, 896, 1714998UL},
+    {{32, 33}, 2, 908, 1717388UL},
+    {{32, 34}, 14, 927, 1721291UL},
+};
+
+const uint16_t FLEET_LAYOUT_COUNTS_NUM = 937;
+
+const FleetLayoutCount_t FLEET_LAYOUT_COUNTS[] PROGMEM = {
+    {3, 784},
+    {4, 671},
+    {5, 603},
+    {6, 505},
+    {7, 443},
+    {8, 366},
+    {9, 321},
+    {10, 279},
+    {11, 259},
+    {12, 108},
+    {13, 100},
+    {14, 92},
+    {15, 92},
+    {31, 204},
+    {32, 166},
+    {33, 132},
+    {34, 102},
+    {35, 76},
+    {36, 54},
+    {37, 36},
+    {38, 24},
+    {39, 12},
+    {40, 4},
+    {3, 782},
+    {4, 669},
+    {5, 601},
+    {6, 503},
+    {7, 441},
+    {8, 364},
+    {9, 319},
+    {10, 277},
+    {11, 257},
+    {12, 201},
+    {13, 177},
+    {31, 204},
+    {32, 166},
+    {33, 132},
+    {34, 102},
+    {35, 76},
+    {36, 54},
+    {37, 36},
+    {38, 21},
+    {39, 11},
+    {40, 6},
+    {41, 2},
+    {8, 640},
+    {9, 622},
+    {12, 480},
+    {13, 436},
+    {16, 376},
+    {17, 339},
+    {20, 285},
+    {21, 254},
+    {24, 246},
+    {25, 214},
+    {28, 206},
+    {33, 168},
+    {38, 134},
+    {39, 104},
+    {40, 44},
+    {43, 66},
+    {44, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {4, 572},
+    {5, 588},
+    {12, 420},
+    {13, 406},
+    {16, 295},
+    {17, 262},
+    {20, 217},
+    {21, 191},
+    {24, 184},
+    {25, 157},
+    {28, 150},
+    {33, 118},
+    {38, 90},
+    {43, 66},
+    {44, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {4, 546},
+    {5, 530},
+    {8, 425},
+    {9, 409},
+    {16, 326},
+    {17, 314},
+    {20, 219},
+    {21, 192},
+    {24, 187},
+    {25, 160},
+    {28, 153},
+    {33, 121},
+    {34, 105},
+    {35, 44},
+    {38, 55},
+    {43, 37},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {4, 547},
+    {5, 532},
+    {8, 402},
+    {9, 362},
+    {12, 329},
+    {13, 316},
+    {20, 243},
+    {21, 233},
+    {24, 186},
+    {25, 158},
+    {28, 153},
+    {33, 121},
+    {34, 92},
+    {35, 39},
+    {38, 58},
+    {39, 47},
+    {40, 18},
+    {43, 17},
+    {48, 8},
+    {53, 5},
+    {54, 1},
+    {4, 544},
+    {5, 529},
+    {8, 400},
+    {9, 361},
+    {12, 307},
+    {13, 274},
+    {16, 245},
+    {17, 234},
+    {24, 206},
+    {25, 194},
+    {28, 150},
+    {33, 118},
+    {34, 90},
+    {35, 38},
+    {38, 55},
+    {39, 36},
+    {40, 14},
+    {43, 17},
+    {44, 11},
+    {45, 3},
+    {4, 606},
+    {5, 525},
+    {8, 346},
+    {9, 268},
+    {12, 105},
+    {13, 92},
+    {28, 187},
+    {33, 119},
+    {34, 67},
+    {35, 20},
+    {38, 19},
+    {39, 3},
+    {4, 607},
+    {8, 510},
+    {12, 454},
+    {16, 376},
+    {17, 365},
+    {20, 284},
+    {21, 253},
+    {24, 245},
+    {25, 214},
+    {28, 205},
+    {33, 167},
+    {34, 133},
+    {38, 103},
+    {39, 77},
+    {43, 55},
+    {44, 37},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {4, 545},
+    {5, 562},
+    {8, 424},
+    {12, 373},
+    {16, 326},
+    {20, 261},
+    {21, 253},
+    {24, 223},
+    {25, 193},
+    {28, 185},
+    {33, 149},
+    {34, 117},
+    {38, 89},
+    {39, 65},
+    {43, 45},
+    {44, 29},
+    {48, 16},
+    {49, 8},
+    {53, 5},
+    {54, 1},
+    {4, 547},
+    {5, 532},
+    {8, 401},
+    {9, 387},
+    {12, 328},
+    {16, 284},
+    {20, 243},
+    {24, 224},
+    {25, 214},
+    {28, 185},
+    {33, 149},
+    {34, 117},
+    {35, 58},
+    {38, 75},
+    {39, 53},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {4, 576},
+    {5, 561},
+    {8, 427},
+    {9, 386},
+    {12, 329},
+    {13, 317},
+    {16, 264},
+    {20, 224},
+    {24, 225},
+    {28, 205},
+    {33, 167},
+    {34, 133},
+    {35, 58},
+    {38, 89},
+    {39, 65},
+    {40, 32},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {0, 609},
+    {1, 540},
+    {2, 445},
+    {3, 387},
+    {7, 285},
+    {8, 267},
+    {9, 227},
+    {10, 172},
+    {11, 139},
+    {12, 52},
+    {13, 47},
+    {14, 43},
+    {15, 44},
+    {31, 102},
+    {32, 76},
+    {36, 54},
+    {37, 36},
+    {38, 24},
+    {39, 12},
+    {40, 4},
+    {0, 607},
+    {1, 538},
+    {2, 443},
+    {3, 385},
+    {7, 283},
+    {8, 265},
+    {9, 225},
+    {10, 170},
+    {11, 137},
+    {12, 97},
+    {13, 81},
+    {31, 102},
+    {32, 76},
+    {36, 54},
+    {37, 36},
+    {38, 21},
+    {39, 11},
+    {40, 6},
+    {41, 2},
+    {0, 608},
+    {1, 588},
+    {12, 420},
+    {13, 406},
+    {16, 295},
+    {17, 262},
+    {20, 217},
+    {21, 191},
+    {24, 184},
+    {25, 157},
+    {28, 150},
+    {33, 118},
+    {38, 90},
+    {43, 66},
+    {44, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {0, 516},
+    {1, 498},
+    {8, 367},
+    {9, 379},
+    {16, 249},
+    {17, 239},
+    {20, 157},
+    {21, 135},
+    {24, 131},
+    {25, 109},
+    {28, 103},
+    {33, 77},
+    {38, 55},
+    {43, 37},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {0, 519},
+    {1, 501},
+    {8, 348},
+    {9, 335},
+    {12, 254},
+    {13, 242},
+    {20, 181},
+    {21, 173},
+    {24, 133},
+    {25, 110},
+    {28, 106},
+    {33, 80},
+    {38, 58},
+    {39, 47},
+    {40, 18},
+    {43, 17},
+    {48, 8},
+    {53, 5},
+    {54, 1},
+    {0, 487},
+    {1, 409},
+    {8, 230},
+    {9, 184},
+    {12, 51},
+    {13, 42},
+    {28, 90},
+    {33, 46},
+    {38, 19},
+    {39, 3},
+    {0, 547},
+    {1, 529},
+    {8, 395},
+    {12, 318},
+    {16, 276},
+    {20, 217},
+    {21, 210},
+    {24, 183},
+    {25, 156},
+    {28, 149},
+    {33, 117},
+    {38, 89},
+    {39, 65},
+    {43, 45},
+    {44, 29},
+    {48, 16},
+    {49, 8},
+    {53, 5},
+    {54, 1},
+    {0, 518},
+    {1, 501},
+    {8, 346},
+    {9, 359},
+    {12, 252},
+    {16, 215},
+    {20, 180},
+    {24, 164},
+    {25, 156},
+    {28, 131},
+    {33, 101},
+    {38, 75},
+    {39, 53},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {0, 547},
+    {1, 529},
+    {8, 371},
+    {9, 358},
+    {12, 254},
+    {13, 243},
+    {16, 199},
+    {20, 165},
+    {24, 166},
+    {28, 149},
+    {33, 117},
+    {38, 89},
+    {39, 65},
+    {40, 32},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {0, 548},
+    {1, 487},
+    {2, 429},
+    {3, 401},
+    {4, 319},
+    {5, 274},
+    {6, 214},
+    {7, 179},
+    {11, 152},
+    {12, 90},
+    {13, 82},
+    {14, 60},
+    {15, 47},
+    {28, 118},
+    {29, 88},
+    {30, 62},
+    {31, 33},
+    {32, 19},
+    {36, 9},
+    {37, 3},
+    {0, 548},
+    {1, 487},
+    {2, 429},
+    {3, 401},
+    {4, 319},
+    {5, 274},
+    {6, 214},
+    {7, 179},
+    {11, 150},
+    {12, 136},
+    {13, 129},
+    {28, 120},
+    {29, 90},
+    {30, 64},
+    {31, 35},
+    {32, 21},
+    {36, 10},
+    {37, 4},
+    {41, 2},
+    {0, 581},
+    {1, 530},
+    {4, 424},
+    {5, 409},
+    {16, 326},
+    {17, 314},
+    {20, 219},
+    {21, 192},
+    {24, 187},
+    {25, 160},
+    {28, 153},
+    {29, 135},
+    {30, 58},
+    {33, 77},
+    {38, 55},
+    {43, 37},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {0, 465},
+    {1, 367},
+    {4, 240},
+    {5, 193},
+    {12, 72},
+    {13, 75},
+    {28, 93},
+    {29, 56},
+    {30, 15},
+    {33, 6},
+    {0, 521},
+    {1, 474},
+    {4, 374},
+    {5, 361},
+    {12, 304},
+    {16, 239},
+    {20, 203},
+    {24, 186},
+    {25, 177},
+    {28, 151},
+    {29, 133},
+    {30, 58},
+    {33, 75},
+    {38, 53},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {0, 521},
+    {1, 474},
+    {4, 374},
+    {5, 361},
+    {12, 282},
+    {13, 293},
+    {16, 200},
+    {20, 167},
+    {24, 168},
+    {28, 151},
+    {29, 133},
+    {30, 58},
+    {33, 75},
+    {38, 53},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {0, 548},
+    {1, 487},
+    {2, 427},
+    {3, 398},
+    {4, 275},
+    {5, 236},
+    {6, 218},
+    {7, 200},
+    {8, 168},
+    {9, 152},
+    {28, 135},
+    {29, 105},
+    {30, 79},
+    {31, 67},
+    {32, 38},
+    {33, 29},
+    {34, 15},
+    {35, 5},
+    {0, 610},
+    {1, 545},
+    {2, 482},
+    {3, 450},
+    {4, 317},
+    {5, 276},
+    {6, 236},
+    {7, 237},
+    {8, 201},
+    {9, 167},
+    {10, 136},
+    {28, 135},
+    {29, 105},
+    {30, 79},
+    {31, 58},
+    {32, 47},
+    {33, 29},
+    {34, 15},
+    {35, 5},
+    {0, 580},
+    {4, 452},
+    {8, 426},
+    {16, 351},
+    {17, 339},
+    {20, 239},
+    {21, 211},
+    {24, 205},
+    {25, 177},
+    {28, 169},
+    {29, 134},
+    {33, 105},
+    {34, 90},
+    {38, 55},
+    {43, 37},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {0, 609},
+    {1, 545},
+    {2, 482},
+    {3, 451},
+    {4, 340},
+    {5, 273},
+    {6, 235},
+    {7, 217},
+    {9, 201},
+    {10, 167},
+    {11, 136},
+    {28, 151},
+    {29, 103},
+    {30, 77},
+    {31, 55},
+    {32, 38},
+    {34, 29},
+    {35, 15},
+    {36, 5},
+    {1, 763},
+    {5, 616},
+    {9, 555},
+    {12, 514},
+    {13, 438},
+    {16, 376},
+    {17, 339},
+    {20, 286},
+    {21, 254},
+    {24, 247},
+    {25, 214},
+    {29, 207},
+    {30, 93},
+    {34, 151},
+    {35, 66},
+    {39, 104},
+    {40, 44},
+    {43, 66},
+    {44, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {1, 746},
+    {2, 672},
+    {3, 635},
+    {5, 473},
+    {6, 419},
+    {7, 392},
+    {9, 324},
+    {10, 281},
+    {11, 260},
+    {12, 129},
+    {13, 100},
+    {14, 92},
+    {15, 92},
+    {29, 203},
+    {30, 165},
+    {31, 131},
+    {32, 101},
+    {34, 75},
+    {35, 53},
+    {36, 35},
+    {37, 21},
+    {39, 12},
+    {40, 4},
+    {1, 745},
+    {2, 671},
+    {3, 634},
+    {5, 472},
+    {6, 418},
+    {7, 391},
+    {9, 323},
+    {10, 280},
+    {11, 258},
+    {12, 221},
+    {13, 177},
+    {29, 204},
+    {30, 166},
+    {31, 132},
+    {32, 102},
+    {34, 76},
+    {35, 54},
+    {36, 36},
+    {37, 21},
+    {39, 11},
+    {40, 6},
+    {41, 2},
+    {12, 515},
+    {13, 468},
+    {16, 376},
+    {17, 338},
+    {20, 286},
+    {21, 254},
+    {24, 247},
+    {25, 214},
+    {28, 207},
+    {30, 93},
+    {33, 151},
+    {35, 66},
+    {38, 104},
+    {40, 44},
+    {43, 66},
+    {44, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {2, 545},
+    {3, 513},
+    {6, 370},
+    {7, 346},
+    {10, 283},
+    {11, 262},
+    {12, 129},
+    {13, 120},
+    {14, 92},
+    {15, 92},
+    {28, 203},
+    {30, 165},
+    {31, 131},
+    {32, 101},
+    {33, 75},
+    {35, 53},
+    {36, 35},
+    {37, 21},
+    {38, 12},
+    {40, 4},
+    {2, 544},
+    {3, 512},
+    {6, 369},
+    {7, 345},
+    {10, 281},
+    {11, 260},
+    {12, 222},
+    {13, 195},
+    {28, 204},
+    {30, 166},
+    {31, 132},
+    {32, 102},
+    {33, 76},
+    {35, 54},
+    {36, 35},
+    {37, 22},
+    {38, 11},
+    {40, 6},
+    {41, 2},
+    {0, 582},
+    {4, 455},
+    {8, 403},
+    {12, 353},
+    {16, 307},
+    {20, 264},
+    {24, 244},
+    {25, 234},
+    {28, 203},
+    {29, 165},
+    {33, 131},
+    {34, 101},
+    {38, 75},
+    {39, 53},
+    {43, 35},
+    {44, 21},
+    {48, 10},
+    {49, 4},
+    {53, 2},
+    {0, 549},
+    {4, 372},
+    {8, 283},
+    {12, 105},
+    {13, 111},
+    {28, 184},
+    {29, 116},
+    {33, 64},
+    {34, 28},
+    {38, 8},
+    {0, 711},
+    {1, 617},
+    {5, 486},
+    {9, 432},
+    {13, 381},
+    {16, 349},
+    {17, 288},
+    {20, 239},
+    {21, 211},
+    {24, 205},
+    {25, 175},
+    {29, 169},
+    {30, 75},
+    {34, 119},
+    {35, 51},
+    {39, 78},
+    {40, 32},
+    {44, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {0, 708},
+    {1, 601},
+    {2, 535},
+    {3, 502},
+    {5, 360},
+    {6, 314},
+    {7, 290},
+    {9, 234},
+    {10, 198},
+    {11, 198},
+    {13, 142},
+    {29, 166},
+    {30, 132},
+    {31, 102},
+    {32, 75},
+    {34, 54},
+    {35, 36},
+    {36, 22},
+    {37, 15},
+    {39, 3},
+    {40, 1},
+    {0, 518},
+    {1, 467},
+    {16, 350},
+    {17, 312},
+    {20, 239},
+    {21, 210},
+    {24, 205},
+    {25, 175},
+    {28, 169},
+    {30, 75},
+    {33, 119},
+    {35, 51},
+    {38, 78},
+    {40, 32},
+    {43, 46},
+    {45, 18},
+    {48, 22},
+    {49, 12},
+    {50, 4},
+    {53, 5},
+    {54, 1},
+    {0, 517},
+    {1, 457},
+    {2, 373},
+    {3, 347},
+    {6, 233},
+    {7, 215},
+    {10, 182},
+    {11, 166},
+    {28, 166},
+    {30, 132},
+    {31, 101},
+    {32, 76},
+    {33, 54},
+    {35, 36},
+    {36, 27},
+    {37, 10},
+    {38, 3},
+    {40, 1},
+    {0, 676},
+    {1, 608},
+    {2, 542},
+    {3, 509},
+    {4, 416},
+    {5, 339},
+    {6, 272},
+    {7, 252},
+    {10, 200},
+    {11, 184},
+    {14, 76},
+    {15, 76},
+    {28, 185},
+    {29, 147},
+    {30, 100},
+    {31, 74},
+    {32, 52},
+    {35, 34},
+    {36, 20},
+    {37, 10},
+    {40, 4},
+    {0, 579},
+    {1, 516},
+    {2, 455},
+    {3, 426},
+    {4, 318},
+    {5, 274},
+    {6, 235},
+    {7, 198},
+    {11, 168},
+    {15, 76},
+    {28, 185},
+    {29, 132},
+    {30, 115},
+    {31, 74},
+    {32, 52},
+    {34, 34},
+    {36, 20},
+    {37, 10},
+    {39, 4},
+    {0, 579},
+    {1, 517},
+    {2, 455},
+    {3, 425},
+    {4, 320},
+    {5, 255},
+    {6, 236},
+    {7, 216},
+    {9, 168},
+    {13, 76},
+    {28, 185},
+    {29, 132},
+    {30, 102},
+    {31, 87},
+    {32, 52},
+    {34, 34},
+    {35, 20},
+    {37, 10},
+    {39, 4},
+    {0, 643},
+    {1, 524},
+    {4, 367},
+    {5, 262},
+    {9, 192},
+    {13, 76},
+    {28, 169},
+    {29, 90},
+    {30, 29},
+    {34, 29},
+    {35, 6},
+    {39, 3},
+    {0, 581},
+    {1, 517},
+    {2, 457},
+    {3, 428},
+    {4, 319},
+    {5, 298},
+    {6, 235},
+    {7, 198},
+    {11, 168},
+    {15, 76},
+    {28, 168},
+    {29, 149},
+    {30, 115},
+    {31, 74},
+    {32, 52},
+    {33, 34},
+    {36, 20},
+    {37, 10},
+    {38, 4},
+    {0, 463},
+    {1, 364},
+    {4, 239},
+    {5, 174},
+    {28, 154},
+    {29, 105},
+    {30, 29},
+    {33, 29},
+    {35, 6},
+    {38, 3},
+};
+
+const uint8_t FLEET_SHORT_REFLECTIONS[FLEET_LAYOUT_REFLECTIONS_NUM - 1][FLEET_SHORT_PLACEMENTS_NUM] PROGMEM = {
+    {24, 25, 26, 27, 20, 21, 22, 23, 16, 17, 18, 19, 12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3, 53, 54, 55, 56, 57, 48, 49, 50, 51, 52, 43, 44, 45, 46, 47, 38, 39, 40, 41, 42, 33, 34, 35, 36, 37, 28, 29, 30, 31, 32},
+    {3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12, 19, 18, 17, 16, 23, 22, 21, 20, 27, 26, 25, 24, 32, 31, 30, 29, 28, 37, 36, 35, 34, 33, 42, 41, 40, 39, 38, 47, 46, 45, 44, 43, 52, 51, 50, 49, 48, 57, 56, 55, 54, 53},
+    {27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0, 57, 56, 55, 54, 53, 52, 51, 50, 49, 48, 47, 46, 45, 44, 43, 42, 41, 40, 39, 38, 37, 36, 35, 34, 33, 32, 31, 30, 29, 28},
+};
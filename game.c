@@ -22,7 +22,16 @@
 #include "ir.h"                /** Wrapper for ir_uart.h */
 #include "screen.h"            /** Wrapper for tinygl.h */
 #include "setup_manager.h"     /** Handles game states SELECT_PLAYER, CHOOSE_BOARD, AWAIT_BOARD_EXCHANGE */
-#include "board_manager.h"     /** Handles game states THEIR_TURN, SELECT_SHOOT_POSITION,  */
+#include "board_manager.h"     /** Handles game states THEIR_TURN, SELECT_SHOOT_POSITION, AWAIT_SHOT_RESULT */
+#include "board_editor.h"      /** Handles game state EDIT_BOARD */
+#include "commit.h"            /** Handles game state END, checking the opponent's board */
+#include "scheduler.h"         /** Runs the periodic tasks of every tick */
+#include "power.h"             /** Sleeps between ticks */
+#include "debug_display.h"     /** Shows internal counters on the LED matrix */
+#include "input_trace.h"       /** Records and replays the inputs of a game */
+#include "opponent.h"          /** Plays against IR or the computer */
+#include "ai.h"                /** The computer opponent */
+#include "bench.h"             /** Markers for the simavr benchmark */
 
 /** @brief The current game state. */
 static GameState_t game_state;
@@ -36,94 +45,213 @@ bool sent_our_board;
 /** @brief The player number (1 or 2) of the player using this board. */
 uint8_t player_number;
 
+/** @brief Flag indicating if we sank the other player's last ship, set when the game ends. */
+bool won_game;
+
+/** @brief Flag indicating if the game has been ended because the opponent stopped answering. */
+static bool link_lost_shown;
+
 /**
  * @brief Set the current game state.
  *
  * This function updates the game state to the specified new state and clears
  * the screen. It also updates the LED to indicate if it is the other player's turn.
+ * The boards are returned to the pool once they have been checked at the end
+ * of the game, see update_verify_their_board().
  *
  * @param new_game_state The new game state to be set.
  */
 void set_game_state(GameState_t new_game_state)
 {
     game_state = new_game_state;
+    BENCH_STATE(game_state);
 
     // turn LED on when its the other players turn
     // set it only when game state changes instead of every tick
+    screen_pins_hold();
     led_set(LED1, game_state == GAME_STATE_THEIR_TURN);
+    screen_pins_release();
     screen_clear();
+}
+
+/**
+ * @brief Get the current game state.
+ *
+ * @return The current game state.
+ */
+GameState_t game_get_state(void)
+{
+    return game_state;
+}
+
+/**
+ * @brief Puts the game back at the title screen, forgetting everything the last game held.
+ *
+ * The IR link is started again too, so a link which was given up on is
+ * tried afresh. The scheduler and the input trace carry on, a restart is
+ * part of the trace like any other push of the button.
+ */
+static void game_reset(void)
+{
+    ir_init();
+    opponent_select(OPPONENT_IR);
+    board_editor_init();
+    commit_init();
+    // a game which ended without checking their board still holds both boards
+    release_boards();
+    game_state = GAME_STATE_TITLE_SCREEN;
+    BENCH_STATE(game_state);
+    received_their_board = false;
+    sent_our_board = false;
+    won_game = false;
+    link_lost_shown = false;
+}
 
-    // when the game ends, free the boards where were dynamically allocated.
-    if (game_state == GAME_STATE_END)
+/**
+ * @brief Run the handler of the current game state.
+ *
+ * This function checks the current game state to perform the appropriate
+ * actions, it is run every tick by the scheduler. If the opponent stops
+ * answering over IR, the game ends showing MESSAGE_LINK_LOST instead, and
+ * once it has scrolled the button starts a new game from player select.
+ */
+static void update_game_state(void)
+{
+    // a frame the opponent never acknowledged leaves the state waiting for a
+    // reply which cannot come, so end the game and say why rather than hang
+    if (opponent_link_lost() && commit_get_result() == COMMIT_PENDING)
     {
-        delete_boards();
+        if (!link_lost_shown)
+        {
+            link_lost_shown = true;
+            scheduler_task_enable(GAME_TASK_SHOW_CURSOR, false);
+            set_game_state(GAME_STATE_END);
+            screen_set_scrolling_text(MESSAGE_LINK_LOST);
+            return;
+        }
+        button_update();
+        if (!screen_scrolling_message_active()
+            && input_trace_button(button_push_event_p (0) || BENCH_INPUT_TAKE(BENCH_INPUT_BUTTON)))
+        {
+            game_reset();
+        }
+        return;
+    }
+
+    switch (game_state) 
+    {
+        case GAME_STATE_TITLE_SCREEN:
+            set_game_state(GAME_STATE_SELECT_PLAYER);
+            screen_set_scrolling_text(" BATTLESHIPS ");
+            break;
+        case GAME_STATE_SELECT_PLAYER:
+            update_receive_their_board();
+            update_select_player();
+            break;
+        case GAME_STATE_CHOOSE_BOARD:
+            update_receive_their_board();
+            update_choose_board();
+            break;
+        case GAME_STATE_EDIT_BOARD:
+            update_receive_their_board();
+            update_edit_board();
+            break;
+        case GAME_STATE_AWAIT_BOARD_EXCHANGE:
+            update_receive_their_board();
+            break;
+        case GAME_STATE_SELECT_SHOOT_POSITION:
+            update_select_shoot_position();
+            break;
+        case GAME_STATE_AWAIT_SHOT_RESULT:
+            update_await_shot_result();
+            break;
+        case GAME_STATE_THEIR_TURN:
+            update_receive_their_turn();
+            break;
+        case GAME_STATE_END:
+            update_verify_their_board();
+            break;
+        default: 
+            break;
     }
 }
 
 /**
- * @brief Main function to initialize the game and run the game loop.
+ * @brief The game's periodic tasks, indexed by GameTask_t.
  *
- * This function initializes the system, sets up the initial game state, and
- * runs the main game loop. The game loop updates the screen and checks the
- * current game state to perform the appropriate actions.
+ * The cursor blink only flips a screen layer and the input trace only
+ * writes to EEPROM, so both are shed when a tick starts late, a blink put
+ * off runs on the next tick which starts on time. The debug display is not: it reads the button through the input
+ * trace, and a late tick on replay would read the push on another tick.
  */
-int main(void)
+static SchedulerTask_t game_tasks[GAME_TASKS_NUM] = {
+    [GAME_TASK_SCREEN_UPDATE]     = {screen_update, 1, 0, 0, true, false, BENCH_SCREEN_UPDATE},
+    [GAME_TASK_IR_UPDATE]         = {ir_update, 1, 0, 0, true, false, BENCH_IR_UPDATE},
+    [GAME_TASK_SCROLLING_MESSAGE] = {screen_scrolling_message_update, 1, 0, 0, true, false, BENCH_SCROLLING_MESSAGE},
+    [GAME_TASK_GAME_STATE]        = {update_game_state, 1, 0, 0, true, false, BENCH_GAME_STATE},
+    [GAME_TASK_SHOW_CURSOR]       = {update_showing_cursor, 100, 100, 0, false, true, BENCH_SHOW_CURSOR},
+    [GAME_TASK_DEBUG_DISPLAY]     = {update_debug_display, 10, 3, 0, true, false, BENCH_DEBUG_DISPLAY},
+    [GAME_TASK_INPUT_TRACE]       = {input_trace_update, 1, 0, 0, true, true, BENCH_INPUT_TRACE},
+    [GAME_TASK_AI]                = {ai_update, 1, 0, 0, false, false, BENCH_AI},
+};
+
+/**
+ * @brief Initialize the components of the UCFK4 and the game state.
+ *
+ * This function initializes the system and every component used by the game,
+ * then puts the game back at the title screen.
+ */
+void game_init(void)
 {
     // initialise system and components of UCFK4
     system_init();
     pacer_init(PACER_RATE);
+    power_init();
     button_init();
     screen_init();
-    ir_uart_init();
     led_init();
 
     // initialise states
-    game_state = GAME_STATE_TITLE_SCREEN;
-    received_their_board = false;
-    sent_our_board = false;
+    scheduler_init(game_tasks, GAME_TASKS_NUM);
+    input_trace_init();
+    game_reset();
+}
+
+/**
+ * @brief Run a single tick of the game.
+ *
+ * This function runs the tasks which are due this tick: the screen and IR
+ * link every tick, the scrolling message as an overlay, the handler of the
+ * current game state and the blinking of the shot selection display. It
+ * should be called once per pacer tick.
+ */
+void game_update(void)
+{
+    BENCH_BEGIN(BENCH_TICK);
+    // a tick starts late when the one before it overran its slot,
+    // the scheduler then puts off the work which can wait
+    scheduler_run(power_tick_late());
+    BENCH_END(BENCH_TICK);
+}
+
+/* host builds link the game into their own programs which drive
+   game_update() from their own loop, so they do not get this main */
+#ifdef __AVR__
+/**
+ * @brief Main function to initialize the game and run the game loop.
+ *
+ * This function initializes the game then runs the game loop, sleeping
+ * until the next pacer tick before running each tick of the game.
+ */
+int main(void)
+{
+    game_init();
 
     // game loop
     while (1)
     {
-        pacer_wait();
-        screen_update(); // every state uses the screen so update every tick
-
-        // check if a scrolling message is active
-        // if it is, update it then skip game state checking
-        if (screen_scrolling_message_active())
-        {
-            screen_scrolling_message_update();
-            continue;
-        }
-
-        switch (game_state) 
-        {
-            case GAME_STATE_TITLE_SCREEN:
-                set_game_state(GAME_STATE_SELECT_PLAYER);
-                screen_set_scrolling_text(" BATTLESHIPS ");
-                break;
-            case GAME_STATE_SELECT_PLAYER:
-                update_receive_their_board();
-                update_select_player();
-                break;
-            case GAME_STATE_CHOOSE_BOARD:
-                update_receive_their_board();
-                update_choose_board();
-                break;
-            case GAME_STATE_AWAIT_BOARD_EXCHANGE:
-                update_receive_their_board();
-                break;
-            case GAME_STATE_SELECT_SHOOT_POSITION:
-                update_select_shoot_position();
-                break;
-            case GAME_STATE_THEIR_TURN:
-                update_receive_their_turn();
-                break;
-            case GAME_STATE_END:
-                break;
-            default: 
-                break;
-        }
-
+        power_wait();
+        game_update();
     }
-}
\ No newline at end of file
+}
+#endif /* __AVR__ */
@@ -14,12 +14,44 @@
 
 #define PACER_RATE 500  /**< Defines the pacer tick rate (ticks per second). */
 
+/**
+ * @enum  GameTask_t
+ * @brief The tasks in the game's scheduler table, in the order they run each tick.
+ */
+typedef enum {
+    GAME_TASK_SCREEN_UPDATE,      /**< Refreshes the LED matrix, every tick. */
+    GAME_TASK_IR_UPDATE,          /**< Runs the IR link, every tick. */
+    GAME_TASK_SCROLLING_MESSAGE,  /**< Advances the scrolling message, every tick. */
+    GAME_TASK_GAME_STATE,         /**< Runs the handler of the current game state, every tick. */
+    GAME_TASK_SHOW_CURSOR,        /**< Blinks the cursor, enabled while selecting a shot. */
+    GAME_TASK_DEBUG_DISPLAY,      /**< Shows the debug display when the button is pushed. */
+    GAME_TASK_INPUT_TRACE,        /**< Writes the recorded input trace to EEPROM. */
+    GAME_TASK_AI,                 /**< Takes the computer's turn, enabled while it is thinking. */
+    GAME_TASKS_NUM,               /**< Number of tasks. */
+} GameTask_t;
+
+/**
+ * @brief Initialize the components of the UCFK4 and the game state.
+ */
+void game_init(void);
+
+/**
+ * @brief Run a single tick of the game, called once per pacer tick.
+ */
+void game_update(void);
+
 /**
  * @brief Set the current game state.
  * @param new_game_state The new game state to be set.
  */
 void set_game_state(GameState_t new_game_state);
 
+/**
+ * @brief  Get the current game state.
+ * @return The current game state.
+ */
+GameState_t game_get_state(void);
+
 /** 
  * @brief Flag indicating if the other player's board has been received. 
  */
@@ -35,4 +67,9 @@ extern bool sent_our_board;
  */
 extern uint8_t player_number;
 
+/** 
+ * @brief Flag indicating if we sank the other player's last ship, set when the game ends.
+ */
+extern bool won_game;
+
 #endif /* GAME_H */
\ No newline at end of file
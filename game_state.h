@@ -16,10 +16,12 @@ typedef enum {
     GAME_STATE_TITLE_SCREEN,           /**< The game is at the title screen, where players can start. */
     GAME_STATE_SELECT_PLAYER,          /**< The state where players select their number. 1 goes first, 2 goes after. */
     GAME_STATE_CHOOSE_BOARD,           /**< The state where players choose the game board configuration. */
-    GAME_STATE_AWAIT_BOARD_EXCHANGE,   /**< The state where players exchange their selected boards with each other. */
+    GAME_STATE_EDIT_BOARD,             /**< The state where the player places their own ships, see board_editor.h. */
+    GAME_STATE_AWAIT_BOARD_EXCHANGE,   /**< The state where players exchange the tags committing to their boards. */
     GAME_STATE_SELECT_SHOOT_POSITION,  /**< The state where a player selects a position to shoot on the opponent's board. */
+    GAME_STATE_AWAIT_SHOT_RESULT,      /**< The state where a player waits for the opponent to answer their shot. */
     GAME_STATE_THEIR_TURN,             /**< The state indicating that it is the opponent's turn to play. */
-    GAME_STATE_END,                    /**< The final state of the game, indicating that the game has ended. */
+    GAME_STATE_END,                    /**< The final state of the game, where the boards are revealed and checked. */
 } GameState_t;
 
 #endif /* GAME_STATE_H */
\ No newline at end of file
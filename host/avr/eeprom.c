@@ -0,0 +1,103 @@
+/** 
+ * @file   eeprom.c
+ * @brief  Host stand-in for avr-libc's EEPROM access.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <avr/eeprom.h>
+
+/** @brief The EEPROM, erased until first written. */
+static uint8_t eeprom_data[E2END + 1];
+
+/** @brief Flag indicating the EEPROM has been erased. */
+static bool eeprom_erased = false;
+
+/**
+ * @brief Erases the EEPROM the first time it is used.
+ */
+static void eeprom_erase_once(void)
+{
+    if (!eeprom_erased)
+    {
+        memset(eeprom_data, 0xFF, sizeof(eeprom_data));
+        eeprom_erased = true;
+    }
+}
+
+/**
+ * @brief Reads a byte of EEPROM.
+ *
+ * @param address The EEPROM address.
+ * @return The byte, 0xFF past the end of the EEPROM.
+ */
+uint8_t eeprom_read_byte(const uint8_t* address)
+{
+    uintptr_t offset = (uintptr_t) address;
+
+    eeprom_erase_once();
+    return offset <= E2END ? eeprom_data[offset] : 0xFF;
+}
+
+/**
+ * @brief Writes a byte of EEPROM, writes past the end of the EEPROM are ignored.
+ *
+ * @param address The EEPROM address.
+ * @param value The byte to write.
+ */
+void eeprom_write_byte(uint8_t* address, uint8_t value)
+{
+    uintptr_t offset = (uintptr_t) address;
+
+    eeprom_erase_once();
+    if (offset <= E2END)
+    {
+        eeprom_data[offset] = value;
+    }
+}
+
+/**
+ * @brief Erases the EEPROM, then loads the start of it from a file.
+ *
+ * @param path The file to load, bytes past the end of the EEPROM are ignored.
+ * @return true if the file was read.
+ */
+bool eeprom_host_load(const char* path)
+{
+    FILE* file = fopen(path, "rb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    memset(eeprom_data, 0xFF, sizeof(eeprom_data));
+    eeprom_erased = true;
+    fread(eeprom_data, 1, sizeof(eeprom_data), file);
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+/**
+ * @brief Saves the start of the EEPROM to a file.
+ *
+ * @param path The file to write.
+ * @param size The number of bytes to save, at most the size of the EEPROM.
+ * @return true if the file was written.
+ */
+bool eeprom_host_save(const char* path, size_t size)
+{
+    FILE* file = fopen(path, "wb");
+    if (file == NULL)
+    {
+        return false;
+    }
+    eeprom_erase_once();
+    if (size > sizeof(eeprom_data))
+    {
+        size = sizeof(eeprom_data);
+    }
+    bool ok = fwrite(eeprom_data, 1, size, file) == size;
+    return fclose(file) == 0 && ok;
+}
@@ -0,0 +1,55 @@
+/** 
+ * @file   eeprom.h
+ * @brief  Host stand-in for avr-libc's EEPROM access.
+ *
+ * The EEPROM is an array erased to 0xFF, and every write finishes at once.
+ * It is 32 KB rather than the ATmega32U2's 1 KB, so input traces recorded
+ * on the host hold whole games of the soak bots, which push something every
+ * tick. Host programs load it from and save it to files with
+ * eeprom_host_load() and eeprom_host_save().
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef EEPROM_H
+#define EEPROM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define E2END 0x7FFF // Address of the last byte of EEPROM
+
+#define eeprom_is_ready() true
+
+/**
+ * @brief  Reads a byte of EEPROM.
+ * @param  address: The EEPROM address.
+ * @return The byte.
+ */
+uint8_t eeprom_read_byte(const uint8_t* address);
+
+/**
+ * @brief Writes a byte of EEPROM.
+ * @param address: The EEPROM address.
+ * @param value: The byte to write.
+ */
+void eeprom_write_byte(uint8_t* address, uint8_t value);
+
+/**
+ * @brief  Erases the EEPROM, then loads the start of it from a file.
+ * @param  path: The file to load, bytes past the end of the EEPROM are ignored.
+ * @return true if the file was read.
+ */
+bool eeprom_host_load(const char* path);
+
+/**
+ * @brief  Saves the start of the EEPROM to a file.
+ * @param  path: The file to write.
+ * @param  size: The number of bytes to save.
+ * @return true if the file was written.
+ */
+bool eeprom_host_save(const char* path, size_t size);
+
+#endif /* EEPROM_H */
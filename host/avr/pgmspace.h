@@ -0,0 +1,23 @@
+/** 
+ * @file   pgmspace.h
+ * @brief  Host stand-in for avr-libc's program memory access.
+ *
+ * The host has a single address space, so program memory is ordinary
+ * constant data and reading it is a plain memory access.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef PGMSPACE_H
+#define PGMSPACE_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+
+#define pgm_read_byte(address) (*(const uint8_t*) (address))
+#define memcpy_P(dest, src, n) memcpy((dest), (src), (n))
+
+#endif /* PGMSPACE_H */
@@ -0,0 +1,637 @@
+/**
+ * @file   board_tournament.c
+ * @brief  Plays self-play games between every pair of predefined boards to rank how hard each is to sink.
+ *
+ * Each game is played with the real board.c logic, every shot is fired with
+ * board_fire() at a board set up by board_init(), so the tournament sinks the
+ * boards exactly as the game does. Player 1 and player 2 take turns to shoot
+ * with the same strategy until both boards are sunk. The player who sinks the
+ * other's board first wins, and the shots it took to sink each board are
+ * counted whoever won.
+ *
+ * The strategies are:
+ *
+ * - random: a cell not yet shot, chosen at random.
+ * - hunt: a random cell of one colour of a checkerboard until a ship is hit,
+ *   then the cells next to each hit until they run out.
+ * - density: the computer opponent's search, see ai.h.
+ *
+ * Every pair of boards under every strategy is split into work items of
+ * TOURNAMENT_CHUNK_GAMES games. Each worker thread owns a deque of items,
+ * taking them from one end, and steals from the other end of another
+ * worker's deque once its own is empty, so the threads stay busy until the
+ * last item. Each item has its own random generator seeded from its index,
+ * so the results do not depend on the number of threads.
+ *
+ * For every strategy, the mean and percentiles of the shots to sink each
+ * board are reported, with -v the full distribution, then the percentage of
+ * games player 1 won for every pair of boards.
+ *
+ * Usage: board_tournament [-n games per pair] [-j threads] [-s seed] [-v]
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+#include "predefined_boards.h"
+#include "ai.h"
+
+#define TOURNAMENT_DEFAULT_GAMES 5000  // Games played for every pair of boards under every strategy
+#define TOURNAMENT_CHUNK_GAMES 500     // Games in one work item
+#define TOURNAMENT_BOARDS_MAX 16       // Most predefined boards the tournament plays
+
+#define TOURNAMENT_CELLS_NUM (BOARD_ROWS_NUM * BOARD_COLS_NUM) // Cells on a board, the most shots a board takes
+
+/**
+ * @enum  TournamentStrategy_t
+ * @brief The ways a player chooses where to shoot.
+ */
+typedef enum
+{
+    STRATEGY_RANDOM,  /**< A cell not yet shot, at random. */
+    STRATEGY_HUNT,    /**< Checkerboard cells at random, then the cells next to each hit. */
+    STRATEGY_DENSITY, /**< The computer opponent's search. */
+    STRATEGIES_NUM,   /**< Number of strategies. */
+} TournamentStrategy_t;
+
+/** @brief Names of the strategies, indexed by TournamentStrategy_t. */
+static const char* const STRATEGY_NAMES[STRATEGIES_NUM] = {"random", "hunt", "density"};
+
+/**
+ * @struct TournamentShooter_t
+ * @brief  What a player knows about the board it shoots at.
+ */
+typedef struct
+{
+    TournamentStrategy_t strategy;         /**< How the player chooses where to shoot. */
+    PredefinedBoard_t shots;               /**< Cells which have been shot. */
+    uint8_t targets[TOURNAMENT_CELLS_NUM]; /**< Cells next to hits still to shoot, for STRATEGY_HUNT. */
+    uint8_t targets_num;                   /**< Number of cells in targets. */
+    AiSearch_t search;                     /**< The search, for STRATEGY_DENSITY, memset clears it for a new game. */
+} TournamentShooter_t;
+
+/**
+ * @struct TournamentResult_t
+ * @brief  Counts of the games played between two boards.
+ */
+typedef struct
+{
+    uint64_t sunk[2][TOURNAMENT_CELLS_NUM + 1]; /**< Games in which player 1's, then player 2's, board took each number of shots to sink. */
+    uint64_t first_wins;                        /**< Games player 1 won. */
+} TournamentResult_t;
+
+/**
+ * @struct TournamentItem_t
+ * @brief  A number of games between two boards under one strategy, the unit of work.
+ */
+typedef struct
+{
+    TournamentStrategy_t strategy; /**< How both players shoot. */
+    uint8_t first;                 /**< Predefined board ID of player 1. */
+    uint8_t second;                /**< Predefined board ID of player 2. */
+    uint32_t games;                /**< Games to play. */
+    uint64_t seed;                 /**< Seed of the item's random generator. */
+    TournamentResult_t result;     /**< The counts of the games played. */
+} TournamentItem_t;
+
+/**
+ * @struct TournamentDeque_t
+ * @brief  The work items a worker owns, the owner takes from the tail and thieves from the head.
+ */
+typedef struct
+{
+    pthread_mutex_t lock; /**< Held while an item is taken. */
+    uint32_t* items;      /**< Indices of the items. */
+    uint32_t head;        /**< Index in items of the next item to steal. */
+    uint32_t tail;        /**< One past the index in items of the owner's next item. */
+} TournamentDeque_t;
+
+/**
+ * @struct TournamentWorker_t
+ * @brief  A worker thread and its deque.
+ */
+typedef struct
+{
+    pthread_t thread;        /**< The thread running the worker. */
+    uint32_t index;          /**< Index of the worker. */
+    TournamentDeque_t deque; /**< The items the worker owns. */
+    uint64_t stolen;         /**< Items the worker stole. */
+} TournamentWorker_t;
+
+/** @brief The layouts of the predefined boards. */
+static PredefinedBoard_t layouts[TOURNAMENT_BOARDS_MAX];
+
+/** @brief Every work item. */
+static TournamentItem_t* items;
+
+/** @brief Every worker. */
+static TournamentWorker_t* workers;
+
+/** @brief Number of workers. */
+static uint32_t workers_num;
+
+/**
+ * @brief Generates the next pseudo random number with splitmix64.
+ *
+ * @param state The generator's state.
+ * @return The next number.
+ */
+static uint64_t tournament_random(uint64_t* state)
+{
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Checks if a cell has been shot.
+ *
+ * @param shooter The player.
+ * @param cell The cell, in row major order.
+ * @return true if the cell has been shot.
+ */
+static bool tournament_shot(const TournamentShooter_t* shooter, uint8_t cell)
+{
+    return shooter->shots[cell / BOARD_COLS_NUM] & BOARD_COL_MASK(cell % BOARD_COLS_NUM);
+}
+
+/**
+ * @brief Chooses a random cell which has not been shot.
+ *
+ * @param shooter The player.
+ * @param random The generator's state.
+ * @param checkerboard true to only choose cells whose row and column add up to an even number, if any are left.
+ * @return The cell, in row major order.
+ */
+static uint8_t tournament_pick_random(const TournamentShooter_t* shooter, uint64_t* random, bool checkerboard)
+{
+    uint8_t cells[TOURNAMENT_CELLS_NUM];
+    uint8_t cells_num = 0;
+
+    for (uint8_t pass = checkerboard ? 0 : 1; pass < 2 && cells_num == 0; pass++)
+    {
+        for (uint8_t cell = 0; cell < TOURNAMENT_CELLS_NUM; cell++)
+        {
+            bool even = (cell / BOARD_COLS_NUM + cell % BOARD_COLS_NUM) % 2 == 0;
+            if (!tournament_shot(shooter, cell) && (pass == 1 || even))
+            {
+                cells[cells_num++] = cell;
+            }
+        }
+    }
+    return cells[tournament_random(random) % cells_num];
+}
+
+/**
+ * @brief Chooses the next cell a player shoots.
+ *
+ * @param shooter The player.
+ * @param random The generator's state.
+ * @return The cell, in row major order.
+ */
+static uint8_t tournament_choose(TournamentShooter_t* shooter, uint64_t* random)
+{
+    switch (shooter->strategy)
+    {
+        case STRATEGY_HUNT:
+            while (shooter->targets_num > 0)
+            {
+                uint8_t cell = shooter->targets[--shooter->targets_num];
+                if (!tournament_shot(shooter, cell))
+                {
+                    return cell;
+                }
+            }
+            return tournament_pick_random(shooter, random, true);
+        case STRATEGY_DENSITY: {
+            uint8_t row = 0;
+            uint8_t col = 0;
+            while (!ai_search_step(&shooter->search))
+            {
+            }
+            ai_search_choose(&shooter->search, (uint16_t) tournament_random(random), &row, &col);
+            return row * BOARD_COLS_NUM + col;
+        }
+        default:
+            return tournament_pick_random(shooter, random, false);
+    }
+}
+
+/**
+ * @brief Tells a player the result of its shot.
+ *
+ * @param shooter The player.
+ * @param cell The cell shot, in row major order.
+ * @param response The result of the shot.
+ */
+static void tournament_record(TournamentShooter_t* shooter, uint8_t cell, BoardResponse_t response)
+{
+    uint8_t row = cell / BOARD_COLS_NUM;
+    uint8_t col = cell % BOARD_COLS_NUM;
+
+    shooter->shots[row] |= BOARD_COL_MASK(col);
+    if (shooter->strategy == STRATEGY_DENSITY)
+    {
+        ai_search_record(&shooter->search, row, col, response);
+    }
+    if (shooter->strategy == STRATEGY_HUNT && response == HIT)
+    {
+        // pushed in reverse so the cell above is tried first
+        if (col > 0)
+        {
+            shooter->targets[shooter->targets_num++] = cell - 1;
+        }
+        if (col < BOARD_COLS_NUM - 1)
+        {
+            shooter->targets[shooter->targets_num++] = cell + 1;
+        }
+        if (row < BOARD_ROWS_NUM - 1)
+        {
+            shooter->targets[shooter->targets_num++] = cell + BOARD_COLS_NUM;
+        }
+        if (row > 0)
+        {
+            shooter->targets[shooter->targets_num++] = cell - BOARD_COLS_NUM;
+        }
+    }
+}
+
+/**
+ * @brief Plays the games of a work item.
+ *
+ * Player 1 shoots at player 2's board first, then they take turns. A player
+ * whose opponent's board is sunk stops shooting while the other carries on.
+ *
+ * @param item The work item, its result is filled in.
+ */
+static void tournament_play(TournamentItem_t* item)
+{
+    uint64_t random = item->seed;
+    Board_t boards[2];
+    TournamentShooter_t shooters[2];
+
+    memset(&item->result, 0, sizeof(item->result));
+    for (uint32_t game = 0; game < item->games; game++)
+    {
+        uint8_t shots[2] = {0, 0};
+        bool sunk[2] = {false, false};
+        int8_t winner = -1;
+
+        board_init(&boards[0], &layouts[item->first]);
+        board_init(&boards[1], &layouts[item->second]);
+        for (uint8_t player = 0; player < 2; player++)
+        {
+            memset(&shooters[player], 0, sizeof(shooters[player]));
+            shooters[player].strategy = item->strategy;
+        }
+
+        for (uint8_t player = 0; !sunk[0] || !sunk[1]; player ^= 1)
+        {
+            // player shoots at the other player's board
+            uint8_t other = player ^ 1;
+            if (sunk[other])
+            {
+                continue;
+            }
+            uint8_t cell = tournament_choose(&shooters[player], &random);
+            BoardResponse_t response = board_fire(&boards[other], cell / BOARD_COLS_NUM, cell % BOARD_COLS_NUM);
+            tournament_record(&shooters[player], cell, response);
+            shots[other]++;
+            if (response == WINNER)
+            {
+                sunk[other] = true;
+                winner = winner < 0 ? player : winner;
+            }
+        }
+
+        item->result.sunk[0][shots[0]]++;
+        item->result.sunk[1][shots[1]]++;
+        item->result.first_wins += winner == 0;
+    }
+}
+
+/**
+ * @brief Takes the next item from a worker's own deque.
+ *
+ * @param deque The worker's deque.
+ * @param item Pointer to store the index of the item.
+ * @return true if an item was taken.
+ */
+static bool tournament_pop(TournamentDeque_t* deque, uint32_t* item)
+{
+    bool taken = false;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->head < deque->tail)
+    {
+        *item = deque->items[--deque->tail];
+        taken = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return taken;
+}
+
+/**
+ * @brief Steals the oldest item from another worker's deque.
+ *
+ * @param deque The other worker's deque.
+ * @param item Pointer to store the index of the item.
+ * @return true if an item was stolen.
+ */
+static bool tournament_steal(TournamentDeque_t* deque, uint32_t* item)
+{
+    bool taken = false;
+
+    pthread_mutex_lock(&deque->lock);
+    if (deque->head < deque->tail)
+    {
+        *item = deque->items[deque->head++];
+        taken = true;
+    }
+    pthread_mutex_unlock(&deque->lock);
+    return taken;
+}
+
+/**
+ * @brief Runs a worker until every deque is empty.
+ *
+ * No items are added once the workers start, so a worker which finds every
+ * other deque empty has nothing left to do.
+ *
+ * @param arg The worker.
+ * @return NULL.
+ */
+static void* tournament_work(void* arg)
+{
+    TournamentWorker_t* worker = arg;
+    uint32_t item;
+
+    for (;;)
+    {
+        if (tournament_pop(&worker->deque, &item))
+        {
+            tournament_play(&items[item]);
+            continue;
+        }
+        bool stolen = false;
+        for (uint32_t offset = 1; offset < workers_num && !stolen; offset++)
+        {
+            stolen = tournament_steal(&workers[(worker->index + offset) % workers_num].deque, &item);
+        }
+        if (!stolen)
+        {
+            return NULL;
+        }
+        worker->stolen++;
+        tournament_play(&items[item]);
+    }
+}
+
+/**
+ * @brief Gets the number of shots below which a fraction of games sank a board.
+ *
+ * @param histogram Games for each number of shots.
+ * @param games Total games.
+ * @param fraction The fraction of games.
+ * @return The smallest number of shots reached by at least the fraction of games.
+ */
+static uint8_t tournament_percentile(const uint64_t* histogram, uint64_t games, double fraction)
+{
+    uint64_t seen = 0;
+
+    for (uint8_t shots = 0; shots <= TOURNAMENT_CELLS_NUM; shots++)
+    {
+        seen += histogram[shots];
+        if (seen >= fraction * games)
+        {
+            return shots;
+        }
+    }
+    return TOURNAMENT_CELLS_NUM;
+}
+
+/**
+ * @brief Prints the results of one strategy.
+ *
+ * @param strategy The strategy.
+ * @param boards Number of boards played.
+ * @param games Games played for every pair of boards.
+ * @param verbose true to print the full distribution of shots to sink each board.
+ */
+static void tournament_report(TournamentStrategy_t strategy, uint8_t boards, uint32_t games, bool verbose)
+{
+    static uint64_t sunk[TOURNAMENT_BOARDS_MAX][TOURNAMENT_CELLS_NUM + 1];
+    static uint64_t first_wins[TOURNAMENT_BOARDS_MAX][TOURNAMENT_BOARDS_MAX];
+    uint32_t items_per_pair = (games + TOURNAMENT_CHUNK_GAMES - 1) / TOURNAMENT_CHUNK_GAMES;
+
+    memset(sunk, 0, sizeof(sunk));
+    memset(first_wins, 0, sizeof(first_wins));
+    for (uint32_t i = 0; i < (uint32_t) boards * boards * items_per_pair; i++)
+    {
+        const TournamentItem_t* item = &items[(strategy * boards * boards * items_per_pair) + i];
+        for (uint8_t shots = 0; shots <= TOURNAMENT_CELLS_NUM; shots++)
+        {
+            sunk[item->first][shots] += item->result.sunk[0][shots];
+            sunk[item->second][shots] += item->result.sunk[1][shots];
+        }
+        first_wins[item->first][item->second] += item->result.first_wins;
+    }
+
+    printf("\n%s: shots to sink each board\n", STRATEGY_NAMES[strategy]);
+    printf("board %10s %6s %4s %4s %4s %4s %4s\n", "games", "mean", "min", "p10", "p50", "p90", "max");
+    for (uint8_t board = 0; board < boards; board++)
+    {
+        uint64_t total = 0;
+        uint64_t played = 0;
+        uint8_t least = TOURNAMENT_CELLS_NUM;
+        uint8_t most = 0;
+        for (uint8_t shots = 0; shots <= TOURNAMENT_CELLS_NUM; shots++)
+        {
+            if (sunk[board][shots])
+            {
+                played += sunk[board][shots];
+                total += (uint64_t) shots * sunk[board][shots];
+                least = shots < least ? shots : least;
+                most = shots;
+            }
+        }
+        printf("%5u %10llu %6.2f %4u %4u %4u %4u %4u\n", board, (unsigned long long) played,
+               played ? (double) total / played : 0.0, least,
+               tournament_percentile(sunk[board], played, 0.1),
+               tournament_percentile(sunk[board], played, 0.5),
+               tournament_percentile(sunk[board], played, 0.9), most);
+        if (verbose)
+        {
+            for (uint8_t shots = least; shots <= most; shots++)
+            {
+                printf("      %2u shots %10llu %5.1f%%\n", shots, (unsigned long long) sunk[board][shots],
+                       100.0 * sunk[board][shots] / played);
+            }
+        }
+    }
+
+    printf("%s: percentage of games won by player 1 (rows) against player 2 (columns)\n", STRATEGY_NAMES[strategy]);
+    printf("     ");
+    for (uint8_t second = 0; second < boards; second++)
+    {
+        printf(" %6u", second);
+    }
+    printf("\n");
+    for (uint8_t first = 0; first < boards; first++)
+    {
+        printf("%5u", first);
+        for (uint8_t second = 0; second < boards; second++)
+        {
+            printf(" %6.1f", 100.0 * first_wins[first][second] / games);
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * @brief Runs the tournament.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv The command line arguments.
+ * @return 0 on success, 2 on a usage error.
+ */
+int main(int argc, char** argv)
+{
+    uint32_t games = TOURNAMENT_DEFAULT_GAMES;
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    uint64_t seed = 1;
+    bool verbose = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:j:s:v")) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                games = strtoul(optarg, NULL, 0);
+                break;
+            case 'j':
+                threads = strtol(optarg, NULL, 0);
+                break;
+            case 's':
+                seed = strtoull(optarg, NULL, 0);
+                break;
+            case 'v':
+                verbose = true;
+                break;
+            default:
+                optind = argc + 1;
+                break;
+        }
+    }
+    if (optind != argc || games == 0)
+    {
+        fprintf(stderr, "usage: %s [-n games per pair] [-j threads] [-s seed] [-v]\n", argv[0]);
+        return 2;
+    }
+
+    uint8_t boards = predefined_board_count();
+    boards = boards < TOURNAMENT_BOARDS_MAX ? boards : TOURNAMENT_BOARDS_MAX;
+    for (uint8_t board = 0; board < boards; board++)
+    {
+        predefined_board_read(board, &layouts[board]);
+    }
+
+    // every pair under every strategy is split into chunks, the last chunk
+    // of a pair taking what is left over
+    uint32_t items_per_pair = (games + TOURNAMENT_CHUNK_GAMES - 1) / TOURNAMENT_CHUNK_GAMES;
+    uint32_t items_num = STRATEGIES_NUM * boards * boards * items_per_pair;
+    items = calloc(items_num, sizeof(*items));
+    workers_num = threads > 0 ? (uint32_t) threads : 1;
+    workers = calloc(workers_num, sizeof(*workers));
+    if (items == NULL || workers == NULL)
+    {
+        perror("board_tournament");
+        return 2;
+    }
+
+    uint32_t index = 0;
+    for (uint8_t strategy = 0; strategy < STRATEGIES_NUM; strategy++)
+    {
+        for (uint8_t first = 0; first < boards; first++)
+        {
+            for (uint8_t second = 0; second < boards; second++)
+            {
+                for (uint32_t chunk = 0; chunk < items_per_pair; chunk++)
+                {
+                    TournamentItem_t* item = &items[index];
+                    uint64_t item_seed = seed ^ ((uint64_t) index << 32);
+                    item->strategy = strategy;
+                    item->first = first;
+                    item->second = second;
+                    item->games = chunk + 1 < items_per_pair ? TOURNAMENT_CHUNK_GAMES
+                                                             : games - chunk * TOURNAMENT_CHUNK_GAMES;
+                    item->seed = tournament_random(&item_seed);
+                    index++;
+                }
+            }
+        }
+    }
+
+    // the items are dealt out in turn so every worker starts with a mix of strategies
+    for (uint32_t worker = 0; worker < workers_num; worker++)
+    {
+        TournamentDeque_t* deque = &workers[worker].deque;
+        workers[worker].index = worker;
+        pthread_mutex_init(&deque->lock, NULL);
+        deque->items = calloc(items_num / workers_num + 1, sizeof(*deque->items));
+        if (deque->items == NULL)
+        {
+            perror("board_tournament");
+            return 2;
+        }
+    }
+    for (uint32_t item = 0; item < items_num; item++)
+    {
+        TournamentDeque_t* deque = &workers[item % workers_num].deque;
+        deque->items[deque->tail++] = item;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t worker = 0; worker < workers_num; worker++)
+    {
+        pthread_create(&workers[worker].thread, NULL, tournament_work, &workers[worker]);
+    }
+    uint64_t stolen = 0;
+    for (uint32_t worker = 0; worker < workers_num; worker++)
+    {
+        pthread_join(workers[worker].thread, NULL);
+        stolen += workers[worker].stolen;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    uint64_t played = (uint64_t) STRATEGIES_NUM * boards * boards * games;
+    printf("%llu games of %u boards in %.2f s on %u threads, %.0f games per second, %llu of %u items stolen\n",
+           (unsigned long long) played, boards, seconds, workers_num, played / seconds,
+           (unsigned long long) stolen, items_num);
+    for (uint8_t strategy = 0; strategy < STRATEGIES_NUM; strategy++)
+    {
+        tournament_report(strategy, boards, games, verbose);
+    }
+
+    for (uint32_t worker = 0; worker < workers_num; worker++)
+    {
+        pthread_mutex_destroy(&workers[worker].deque.lock);
+        free(workers[worker].deque.items);
+    }
+    free(workers);
+    free(items);
+    return 0;
+}
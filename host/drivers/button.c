@@ -0,0 +1,57 @@
+/** 
+ * @file   button.c
+ * @brief  Host stand-in for the UCFK4 button driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "button.h"
+#include "frame_trace.h"
+
+/** @brief Pushes injected since the last update, one bit per button. */
+static uint8_t button_pending = 0;
+
+/** @brief Push events which have not been read yet, one bit per button. */
+static uint8_t button_events = 0;
+
+/**
+ * @brief Initializes the button stand-in, clearing any pending pushes.
+ */
+void button_init(void)
+{
+    button_pending = 0;
+    button_events = 0;
+}
+
+/**
+ * @brief Latches the pushes injected since the last update.
+ */
+void button_update(void)
+{
+    button_events = button_pending;
+    button_pending = 0;
+}
+
+/**
+ * @brief Checks if a button was pushed, clearing the event.
+ *
+ * @param button The button to check.
+ * @return true if the button was pushed since the last update.
+ */
+bool button_push_event_p(uint8_t button)
+{
+    bool pushed = button_events & BIT(button);
+    button_events &= ~BIT(button);
+    return pushed;
+}
+
+/**
+ * @brief Injects a push of a button, seen after the next button_update() and recorded to the frame trace.
+ *
+ * @param button The button to push.
+ */
+void button_host_push(uint8_t button)
+{
+    button_pending |= BIT(button);
+    frame_trace_input(FRAME_TRACE_INPUT_BUTTON | button);
+}
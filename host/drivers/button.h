@@ -0,0 +1,42 @@
+/** 
+ * @file   button.h
+ * @brief  Host stand-in for the UCFK4 button driver.
+ *
+ * Button pushes are injected with button_host_push() and reported by
+ * button_push_event_p() after the next button_update().
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include "system.h"
+
+#define BUTTON1 0 // The only button on the UCFK4
+
+/**
+ * @brief Initializes the button stand-in, clearing any pending pushes.
+ */
+void button_init(void);
+
+/**
+ * @brief Latches the pushes injected since the last update.
+ */
+void button_update(void);
+
+/**
+ * @brief  Checks if a button was pushed, clearing the event.
+ * @param  button: The button to check.
+ * @return true if the button was pushed since the last update.
+ */
+bool button_push_event_p(uint8_t button);
+
+/**
+ * @brief Injects a push of a button, seen after the next button_update().
+ * @param button: The button to push.
+ */
+void button_host_push(uint8_t button);
+
+#endif /* BUTTON_H */
@@ -0,0 +1,142 @@
+/** 
+ * @file   ir_uart.c
+ * @brief  Host stand-in for the UCFK4 IR UART driver.
+ *
+ * Each direction is a ring buffer indexed by free running 8 bit counters,
+ * the oldest bytes are dropped when a queue overflows just like bytes are
+ * lost when the UART is not read in time.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "ir_uart.h"
+
+/**
+ * @struct IrUartHostQueue_t
+ * @brief  A queue of bytes in one direction of the stand-in.
+ */
+typedef struct
+{
+    char data[IR_UART_HOST_QUEUE_SIZE]; /**< The queued bytes. */
+    uint8_t head;                       /**< Index the next byte is written to. */
+    uint8_t tail;                       /**< Index the next byte is read from. */
+} IrUartHostQueue_t;
+
+/** @brief Bytes sent by the game, waiting for the host program. */
+static IrUartHostQueue_t ir_uart_tx;
+
+/** @brief Bytes waiting to be received by the game. */
+static IrUartHostQueue_t ir_uart_rx;
+
+/**
+ * @brief Adds a byte to a queue, dropping the oldest byte if it is full.
+ *
+ * @param queue The queue to add to.
+ * @param ch The byte to add.
+ */
+static void ir_uart_host_queue_put(IrUartHostQueue_t* queue, char ch)
+{
+    queue->data[queue->head++] = ch;
+    if (queue->head == queue->tail)
+    {
+        queue->tail++;
+    }
+}
+
+/**
+ * @brief Takes the oldest byte from a queue.
+ *
+ * @param queue The queue to take from.
+ * @param ch Pointer to store the byte.
+ * @return true if a byte was waiting, false otherwise.
+ */
+static bool ir_uart_host_queue_get(IrUartHostQueue_t* queue, char* ch)
+{
+    if (queue->head == queue->tail)
+    {
+        return false;
+    }
+    *ch = queue->data[queue->tail++];
+    return true;
+}
+
+/**
+ * @brief Initializes the IR UART stand-in, emptying both queues.
+ */
+void ir_uart_init(void)
+{
+    ir_uart_tx.head = ir_uart_tx.tail = 0;
+    ir_uart_rx.head = ir_uart_rx.tail = 0;
+}
+
+/**
+ * @brief Sends a byte, queueing it for the host program.
+ *
+ * @param ch The byte to send.
+ */
+void ir_uart_putc(char ch)
+{
+    ir_uart_host_queue_put(&ir_uart_tx, ch);
+}
+
+/**
+ * @brief  Checks if a byte can be sent without waiting.
+ * @return true, the queue never fills from the game's side.
+ */
+bool ir_uart_write_ready_p(void)
+{
+    return true;
+}
+
+/**
+ * @brief  Checks if every byte sent has left the transmitter.
+ * @return true, bytes leave as soon as they are queued.
+ */
+bool ir_uart_write_finished_p(void)
+{
+    return true;
+}
+
+/**
+ * @brief Checks if a received byte is waiting to be read.
+ *
+ * @return true if ir_uart_getc() will return a received byte.
+ */
+bool ir_uart_read_ready_p(void)
+{
+    return ir_uart_rx.head != ir_uart_rx.tail;
+}
+
+/**
+ * @brief Reads a received byte.
+ *
+ * @return The oldest received byte, or 0 if none is waiting.
+ */
+char ir_uart_getc(void)
+{
+    char ch = 0;
+    ir_uart_host_queue_get(&ir_uart_rx, &ch);
+    return ch;
+}
+
+/**
+ * @brief Queues a byte to be received by the game.
+ *
+ * @param ch The byte the game will receive.
+ */
+void ir_uart_host_receive(char ch)
+{
+    ir_uart_host_queue_put(&ir_uart_rx, ch);
+}
+
+/**
+ * @brief Takes the oldest byte sent by the game.
+ *
+ * @param ch Pointer to store the sent byte.
+ * @return true if a sent byte was waiting, false otherwise.
+ */
+bool ir_uart_host_transmit(char* ch)
+{
+    return ir_uart_host_queue_get(&ir_uart_tx, ch);
+}
@@ -0,0 +1,68 @@
+/** 
+ * @file   ir_uart.h
+ * @brief  Host stand-in for the UCFK4 IR UART driver.
+ *
+ * Bytes sent with ir_uart_putc() are queued until the host program takes
+ * them with ir_uart_host_transmit(), and bytes given to ir_uart_host_receive()
+ * are queued until the game reads them with ir_uart_getc().
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef IR_UART_H
+#define IR_UART_H
+
+#include "system.h"
+
+#define IR_UART_HOST_QUEUE_SIZE 256 // Bytes held by each direction, must match the range of a uint8_t index
+
+/**
+ * @brief Initializes the IR UART stand-in, emptying both queues.
+ */
+void ir_uart_init(void);
+
+/**
+ * @brief Sends a byte, queueing it for the host program.
+ * @param ch: The byte to send.
+ */
+void ir_uart_putc(char ch);
+
+/**
+ * @brief  Checks if a byte can be sent without waiting.
+ * @return true, the queue never fills from the game's side.
+ */
+bool ir_uart_write_ready_p(void);
+
+/**
+ * @brief  Checks if every byte sent has left the transmitter.
+ * @return true, bytes leave as soon as they are queued.
+ */
+bool ir_uart_write_finished_p(void);
+
+/**
+ * @brief  Checks if a received byte is waiting to be read.
+ * @return true if ir_uart_getc() will return a received byte.
+ */
+bool ir_uart_read_ready_p(void);
+
+/**
+ * @brief  Reads a received byte.
+ * @return The oldest received byte, or 0 if none is waiting.
+ */
+char ir_uart_getc(void);
+
+/**
+ * @brief Queues a byte to be received by the game.
+ * @param ch: The byte the game will receive.
+ */
+void ir_uart_host_receive(char ch);
+
+/**
+ * @brief  Takes the oldest byte sent by the game.
+ * @param  ch: Pointer to store the sent byte.
+ * @return true if a sent byte was waiting, false otherwise.
+ */
+bool ir_uart_host_transmit(char* ch);
+
+#endif /* IR_UART_H */
@@ -0,0 +1,48 @@
+/** 
+ * @file   led.c
+ * @brief  Host stand-in for the UCFK4 LED driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "led.h"
+
+/** @brief The state of each LED, one bit per LED. */
+static uint8_t led_states = 0;
+
+/**
+ * @brief Initializes the LED stand-in, turning the LED off.
+ */
+void led_init(void)
+{
+    led_states = 0;
+}
+
+/**
+ * @brief Turns an LED on or off.
+ *
+ * @param led The LED to set.
+ * @param state true to turn the LED on, false to turn it off.
+ */
+void led_set(uint8_t led, bool state)
+{
+    if (state)
+    {
+        led_states |= BIT(led);
+    }
+    else
+    {
+        led_states &= ~BIT(led);
+    }
+}
+
+/**
+ * @brief Gets the last state an LED was set to.
+ *
+ * @param led The LED to read.
+ * @return true if the LED is on.
+ */
+bool led_host_get(uint8_t led)
+{
+    return led_states & BIT(led);
+}
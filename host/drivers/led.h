@@ -0,0 +1,34 @@
+/** 
+ * @file   led.h
+ * @brief  Host stand-in for the UCFK4 LED driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef LED_H
+#define LED_H
+
+#include "system.h"
+
+#define LED1 0 // The blue LED on the UCFK4
+
+/**
+ * @brief Initializes the LED stand-in, turning the LED off.
+ */
+void led_init(void);
+
+/**
+ * @brief Turns an LED on or off.
+ * @param led: The LED to set.
+ * @param state: true to turn the LED on, false to turn it off.
+ */
+void led_set(uint8_t led, bool state);
+
+/**
+ * @brief  Gets the last state an LED was set to.
+ * @param  led: The LED to read.
+ * @return true if the LED is on.
+ */
+bool led_host_get(uint8_t led);
+
+#endif /* LED_H */
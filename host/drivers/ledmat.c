@@ -0,0 +1,96 @@
+/** 
+ * @file   ledmat.c
+ * @brief  Host stand-in for the UCFK4 LED matrix driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <string.h>
+#include "ledmat.h"
+#include "frame_trace.h"
+
+/** @brief Thirds of a column's slot the high plane is shown for, the low plane is shown for the rest. */
+#define LEDMAT_HIGH_THIRDS 2
+
+/** @brief The high plane each column was last driven with. */
+static uint8_t ledmat_high[LEDMAT_COLS_NUM];
+
+/** @brief The low plane each column was last driven with. */
+static uint8_t ledmat_low[LEDMAT_COLS_NUM];
+
+/** @brief The thirds of a slot each LED was lit for, indexed by column then row. */
+static uint32_t ledmat_lit[LEDMAT_COLS_NUM][LEDMAT_ROWS_NUM];
+
+/**
+ * @brief Initializes the LED matrix stand-in, turning every LED off and clearing the counts.
+ */
+void ledmat_init(void)
+{
+    memset(ledmat_high, 0, sizeof(ledmat_high));
+    memset(ledmat_low, 0, sizeof(ledmat_low));
+    memset(ledmat_lit, 0, sizeof(ledmat_lit));
+}
+
+/**
+ * @brief Drives a column of the matrix, turning every other column off.
+ *
+ * The LEDs are lit for the whole of the column's slot, as tinygl drives them.
+ *
+ * @param pattern The LEDs to light, bit n for row n.
+ * @param col The column to drive.
+ */
+void ledmat_display_column(uint8_t pattern, uint8_t col)
+{
+    ledmat_host_display_planes(pattern, pattern, col);
+}
+
+/**
+ * @brief Drives a column of the matrix with its high plane then its low plane, turning every other column off.
+ *
+ * Driving the last column completes a frame, which is recorded to the frame
+ * trace when one is open.
+ *
+ * @param high The LEDs lit for the first two thirds of the column's slot, bit n for row n.
+ * @param low The LEDs lit for the last third.
+ * @param col The column to drive.
+ */
+void ledmat_host_display_planes(uint8_t high, uint8_t low, uint8_t col)
+{
+    if (col >= LEDMAT_COLS_NUM)
+    {
+        return;
+    }
+    ledmat_high[col] = high;
+    ledmat_low[col] = low;
+    for (uint8_t row = 0; row < LEDMAT_ROWS_NUM; row++)
+    {
+        ledmat_lit[col][row] += (high & BIT(row) ? LEDMAT_HIGH_THIRDS : 0) + (low & BIT(row) ? 1 : 0);
+    }
+    if (col == LEDMAT_COLS_NUM - 1)
+    {
+        frame_trace_frame(ledmat_high, ledmat_low);
+    }
+}
+
+/**
+ * @brief Gets the LEDs lit in a column at any point of its last slot.
+ *
+ * @param col The column to read.
+ * @return The pattern, bit n for row n.
+ */
+uint8_t ledmat_host_column(uint8_t col)
+{
+    return col < LEDMAT_COLS_NUM ? ledmat_high[col] | ledmat_low[col] : 0;
+}
+
+/**
+ * @brief Gets the thirds of a slot an LED was lit for since ledmat_init().
+ *
+ * @param col The column of the LED.
+ * @param row The row of the LED.
+ * @return The thirds of its column's slots the LED was lit for.
+ */
+uint32_t ledmat_host_lit(uint8_t col, uint8_t row)
+{
+    return (col < LEDMAT_COLS_NUM && row < LEDMAT_ROWS_NUM) ? ledmat_lit[col][row] : 0;
+}
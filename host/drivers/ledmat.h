@@ -0,0 +1,56 @@
+/** 
+ * @file   ledmat.h
+ * @brief  Host stand-in for the UCFK4 LED matrix driver.
+ *
+ * The matrix is driven one column at a time. The stand-in keeps the high and
+ * low plane each column was last driven with and counts the thirds of a
+ * column's slot each LED was lit for, so a host program can read back the
+ * brightness the game produced. On the UCFK4 the game shows the high plane
+ * for two thirds of the slot and the low plane for the last third, see
+ * screen.c, so a dim LED counts 1, medium 2 and full 3.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef LEDMAT_H
+#define LEDMAT_H
+
+#include "system.h"
+
+/**
+ * @brief Initializes the LED matrix stand-in, turning every LED off and clearing the counts.
+ */
+void ledmat_init(void);
+
+/**
+ * @brief Drives a column of the matrix, turning every other column off.
+ * @param pattern: The LEDs to light, bit n for row n.
+ * @param col: The column to drive.
+ */
+void ledmat_display_column(uint8_t pattern, uint8_t col);
+
+/**
+ * @brief Drives a column of the matrix with its high plane then its low plane, turning every other column off.
+ * @param high: The LEDs lit for the first two thirds of the column's slot, bit n for row n.
+ * @param low: The LEDs lit for the last third.
+ * @param col: The column to drive.
+ */
+void ledmat_host_display_planes(uint8_t high, uint8_t low, uint8_t col);
+
+/**
+ * @brief  Gets the LEDs lit in a column at any point of its last slot.
+ * @param  col: The column to read.
+ * @return The pattern, bit n for row n.
+ */
+uint8_t ledmat_host_column(uint8_t col);
+
+/**
+ * @brief  Gets the thirds of a slot an LED was lit for since ledmat_init().
+ * @param  col: The column of the LED.
+ * @param  row: The row of the LED.
+ * @return The thirds of its column's slots the LED was lit for.
+ */
+uint32_t ledmat_host_lit(uint8_t col, uint8_t row);
+
+#endif /* LEDMAT_H */
@@ -0,0 +1,57 @@
+/** 
+ * @file   navswitch.c
+ * @brief  Host stand-in for the UCFK4 navigation switch driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "navswitch.h"
+#include "frame_trace.h"
+
+/** @brief Pushes injected since the last update, one bit per direction. */
+static uint8_t navswitch_pending = 0;
+
+/** @brief Push events which have not been read yet, one bit per direction. */
+static uint8_t navswitch_events = 0;
+
+/**
+ * @brief Initializes the navigation switch stand-in, clearing any pending pushes.
+ */
+void navswitch_init(void)
+{
+    navswitch_pending = 0;
+    navswitch_events = 0;
+}
+
+/**
+ * @brief Latches the pushes injected since the last update.
+ */
+void navswitch_update(void)
+{
+    navswitch_events = navswitch_pending;
+    navswitch_pending = 0;
+}
+
+/**
+ * @brief Checks if the navigation switch was pushed in a direction, clearing the event.
+ *
+ * @param navswitch The direction to check.
+ * @return true if the direction was pushed since the last update.
+ */
+bool navswitch_push_event_p(uint8_t navswitch)
+{
+    bool pushed = navswitch_events & BIT(navswitch);
+    navswitch_events &= ~BIT(navswitch);
+    return pushed;
+}
+
+/**
+ * @brief Injects a push of the navigation switch, seen after the next navswitch_update() and recorded to the frame trace.
+ *
+ * @param navswitch The direction to push.
+ */
+void navswitch_host_push(uint8_t navswitch)
+{
+    navswitch_pending |= BIT(navswitch);
+    frame_trace_input(navswitch);
+}
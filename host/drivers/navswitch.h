@@ -0,0 +1,45 @@
+/** 
+ * @file   navswitch.h
+ * @brief  Host stand-in for the UCFK4 navigation switch driver.
+ *
+ * Pushes are injected with navswitch_host_push() and reported by
+ * navswitch_push_event_p() after the next navswitch_update().
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef NAVSWITCH_H
+#define NAVSWITCH_H
+
+#include "system.h"
+
+/**
+ * @brief The directions of the navigation switch, in the UCFK4's order.
+ */
+enum {NAVSWITCH_NORTH, NAVSWITCH_EAST, NAVSWITCH_SOUTH, NAVSWITCH_WEST, NAVSWITCH_PUSH};
+
+/**
+ * @brief Initializes the navigation switch stand-in, clearing any pending pushes.
+ */
+void navswitch_init(void);
+
+/**
+ * @brief Latches the pushes injected since the last update.
+ */
+void navswitch_update(void);
+
+/**
+ * @brief  Checks if the navigation switch was pushed in a direction, clearing the event.
+ * @param  navswitch: The direction to check.
+ * @return true if the direction was pushed since the last update.
+ */
+bool navswitch_push_event_p(uint8_t navswitch);
+
+/**
+ * @brief Injects a push of the navigation switch, seen after the next navswitch_update().
+ * @param navswitch: The direction to push.
+ */
+void navswitch_host_push(uint8_t navswitch);
+
+#endif /* NAVSWITCH_H */
@@ -0,0 +1,15 @@
+/** 
+ * @file   system.c
+ * @brief  Host stand-in for the UCFK4 system driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "system.h"
+
+/**
+ * @brief Initializes the system, does nothing on the host.
+ */
+void system_init(void)
+{
+}
@@ -0,0 +1,30 @@
+/** 
+ * @file   system.h
+ * @brief  Host stand-in for the UCFK4 system header.
+ *
+ * Provides the board dimensions and clock of the UCFK4 so the game logic
+ * can be compiled natively on the host.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef SYSTEM_H
+#define SYSTEM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define F_CPU 8000000    // Clock frequency of the UCFK4's ATmega32U2
+
+#define LEDMAT_ROWS_NUM 7 // Number of rows on the UCFK4 LED matrix
+#define LEDMAT_COLS_NUM 5 // Number of columns on the UCFK4 LED matrix
+
+#define BIT(X) (1 << (X))
+
+/**
+ * @brief Initializes the system, does nothing on the host.
+ */
+void system_init(void);
+
+#endif /* SYSTEM_H */
@@ -0,0 +1,38 @@
+/** 
+ * @file   timer.c
+ * @brief  Host stand-in for the UCFK4 timer driver.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "timer.h"
+
+/** @brief The count of the timer. */
+static timer_tick_t timer_now = 0;
+
+/**
+ * @brief Initializes the timer stand-in, leaving the count where it is.
+ */
+void timer_init(void)
+{
+}
+
+/**
+ * @brief Reads the timer.
+ *
+ * @return The current count of the timer.
+ */
+timer_tick_t timer_get(void)
+{
+    return timer_now++;
+}
+
+/**
+ * @brief Sets the count of the timer.
+ *
+ * @param now The count the timer continues from.
+ */
+void timer_host_set(timer_tick_t now)
+{
+    timer_now = now;
+}
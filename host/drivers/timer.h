@@ -0,0 +1,37 @@
+/** 
+ * @file   timer.h
+ * @brief  Host stand-in for the UCFK4 timer driver.
+ *
+ * The timer counts up by one each time it is read, starting from the count
+ * given to timer_host_set(), so two instances can be started as if they
+ * were powered on at different times.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "system.h"
+
+typedef uint16_t timer_tick_t;
+
+/**
+ * @brief Initializes the timer stand-in, leaving the count where it is.
+ */
+void timer_init(void);
+
+/**
+ * @brief  Reads the timer.
+ * @return The current count of the timer.
+ */
+timer_tick_t timer_get(void);
+
+/**
+ * @brief Sets the count of the timer.
+ * @param now: The count the timer continues from.
+ */
+void timer_host_set(timer_tick_t now);
+
+#endif /* TIMER_H */
@@ -0,0 +1,521 @@
+/**
+ * @file   fleet_enumerate.c
+ * @brief  Enumerates every fleet layout, generates the rank tables and checks ranking and unranking against them.
+ *
+ * Every canonical layout is walked in rank order with fleet_layout_first()
+ * and fleet_layout_next(), see fleet_layout.h. The walk finds each pair of
+ * placements of the first two ships with the rank of its first layout, and
+ * for the pairs a reflection leaves as they are, the layouts each placement
+ * of the third ship starts.
+ *
+ * With -t the tables are written to a file, fleet_layout_table.c in the
+ * repository, which must be regenerated whenever the fleet, the board or the
+ * order of the layouts changes. Otherwise the tables compiled into the tool
+ * are checked: the number of layouts and every entry must match the walk.
+ * The first and last layout of each pair and a spread of ranks between are
+ * unranked and must rebuild the board of the layout the walk reached at that
+ * rank. Each reflection of that layout must be put back to it by
+ * fleet_layout_canonicalize(), then ranked back to the same rank. The most
+ * steps any of these took is printed, the job steps the game waits for.
+ *
+ * With -r the board of a rank is printed, and with -b the rank of a
+ * predefined board is found, the first layout whose board is the predefined
+ * board or one of its reflections.
+ *
+ * Usage: fleet_enumerate [-t table file] [-r rank] [-b predefined board id]
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+#include "fleet_layout.h"
+#include "predefined_boards.h"
+
+#define ENUMERATE_PAIRS_MAX 2048 // Most pairs the walk keeps, every pair of placements of two ships of length 3
+#define ENUMERATE_COUNTS_MAX 4096 // Most third ship counts the walk keeps, far more than the fleet needs
+#define ENUMERATE_SAMPLES_MAX 8192 // Most ranks the walk samples
+#define ENUMERATE_SAMPLE_GAP 1024 // Ranks between the samples spread through the layouts, on average
+#define ENUMERATE_RANK_NONE UINT32_MAX // Rank which does not refer to a layout
+
+/**
+ * @struct EnumerateSample_t
+ * @brief  A rank checked against fleet_layout_unrank() and the board the walk reached there.
+ */
+typedef struct
+{
+    uint32_t rank;           /**< The rank. */
+    FleetLayout_t layout;    /**< The layout at that rank. */
+    PredefinedBoard_t board; /**< The board of the layout at that rank. */
+} EnumerateSample_t;
+
+/** @brief Every pair of placements of the first two ships, reached by the walk. */
+static FleetLayoutPair_t pairs[ENUMERATE_PAIRS_MAX];
+
+/** @brief Number of pairs in pairs. */
+static uint16_t pairs_num;
+
+/** @brief The layouts each third placement starts, for the pairs a reflection leaves as they are. */
+static FleetLayoutCount_t counts[ENUMERATE_COUNTS_MAX];
+
+/** @brief Number of entries in counts. */
+static uint16_t counts_num;
+
+/** @brief The ranks checked against the tables, reached by the walk. */
+static EnumerateSample_t samples[ENUMERATE_SAMPLES_MAX];
+
+/** @brief Number of samples in samples. */
+static uint32_t samples_num;
+
+/**
+ * @brief Finds the reflections which leave a pair of placements of the first two ships as it is.
+ *
+ * @param placements The placements of the pair.
+ * @return Bit r set when reflection r leaves the pair as it is.
+ */
+static uint8_t enumerate_pair_reflections(const uint8_t* placements)
+{
+    const uint8_t lengths[FLEET_SHIPS_NUM] = FLEET_LENGTHS;
+    uint8_t reflections = 0;
+
+    for (uint8_t reflection = 1; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+    {
+        uint8_t first = fleet_placement_reflect(lengths[0], placements[0], reflection);
+        uint8_t second = fleet_placement_reflect(lengths[1], placements[1], reflection);
+        // the pair's ships have the same length, so either may come first
+        if ((first == placements[0] && second == placements[1]) || (first == placements[1] && second == placements[0]))
+        {
+            reflections |= (uint8_t) (1 << reflection);
+        }
+    }
+    return reflections;
+}
+
+/**
+ * @brief Keeps a layout the walk reached as a sample.
+ *
+ * @param rank The rank of the layout.
+ * @param layout The layout.
+ */
+static void enumerate_sample(uint32_t rank, const FleetLayout_t* layout)
+{
+    if (samples_num > 0 && samples[samples_num - 1].rank == rank)
+    {
+        return;
+    }
+    if (samples_num == ENUMERATE_SAMPLES_MAX)
+    {
+        fprintf(stderr, "fleet_enumerate: more than %d samples\n", ENUMERATE_SAMPLES_MAX);
+        exit(1);
+    }
+    samples[samples_num].rank = rank;
+    samples[samples_num].layout = *layout;
+    fleet_layout_board(layout, &samples[samples_num].board);
+    samples_num++;
+}
+
+/**
+ * @brief Reflects a board.
+ *
+ * @param board The board.
+ * @param flip_rows true to reflect top to bottom.
+ * @param flip_cols true to reflect left to right.
+ * @param reflected The board to store the reflection in.
+ */
+static void enumerate_reflect_board(const PredefinedBoard_t* board, bool flip_rows, bool flip_cols,
+                                    PredefinedBoard_t* reflected)
+{
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        uint8_t cells = (*board)[flip_rows ? BOARD_ROWS_NUM - 1 - row : row];
+        uint8_t flipped = 0;
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        {
+            if (cells & BOARD_COL_MASK(col))
+            {
+                flipped |= BOARD_COL_MASK(flip_cols ? BOARD_COLS_NUM - 1 - col : col);
+            }
+        }
+        (*reflected)[row] = flipped;
+    }
+}
+
+/**
+ * @brief Prints a board, one row per line.
+ *
+ * @param board The board.
+ */
+static void enumerate_print_board(const PredefinedBoard_t* board)
+{
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        {
+            putchar((*board)[row] & BOARD_COL_MASK(col) ? '#' : '.');
+        }
+        putchar('\n');
+    }
+}
+
+/**
+ * @brief Walks every layout, keeping the pairs, the counts, the samples and the rank of a board.
+ *
+ * @param target The board to find the rank of, or NULL.
+ * @param target_rank Pointer to store the rank of the first layout matching target or one of its reflections.
+ * @return The number of layouts.
+ */
+static uint32_t enumerate_walk(const PredefinedBoard_t* target, uint32_t* target_rank)
+{
+    PredefinedBoard_t reflections[FLEET_LAYOUT_REFLECTIONS_NUM];
+    FleetLayout_t layout;
+    FleetLayout_t previous;
+    uint32_t rank = 0;
+
+    if (target != NULL)
+    {
+        for (uint8_t reflection = 0; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+        {
+            enumerate_reflect_board(target, reflection & 1, reflection & 2, &reflections[reflection]);
+        }
+    }
+    *target_rank = ENUMERATE_RANK_NONE;
+    pairs_num = 0;
+    counts_num = 0;
+    samples_num = 0;
+
+    fleet_layout_first(&layout);
+    do
+    {
+        FleetLayoutPair_t* pair = pairs_num > 0 ? &pairs[pairs_num - 1] : NULL;
+        if (pair == NULL || memcmp(layout.placements, pair->placements, FLEET_PAIR_SHIPS))
+        {
+            if (pairs_num == ENUMERATE_PAIRS_MAX)
+            {
+                fprintf(stderr, "fleet_enumerate: more than %d pairs\n", ENUMERATE_PAIRS_MAX);
+                exit(1);
+            }
+            if (rank > 0)
+            {
+                enumerate_sample(rank - 1, &previous);
+            }
+            pair = &pairs[pairs_num++];
+            memcpy(pair->placements, layout.placements, FLEET_PAIR_SHIPS);
+            pair->reflections = enumerate_pair_reflections(pair->placements);
+            pair->counts = counts_num;
+            pair->first = rank;
+            enumerate_sample(rank, &layout);
+        }
+        if (pair->reflections)
+        {
+            if (counts_num == pair->counts || counts[counts_num - 1].placement != layout.placements[FLEET_PAIR_SHIPS])
+            {
+                if (counts_num == ENUMERATE_COUNTS_MAX)
+                {
+                    fprintf(stderr, "fleet_enumerate: more than %d counts\n", ENUMERATE_COUNTS_MAX);
+                    exit(1);
+                }
+                counts[counts_num].placement = layout.placements[FLEET_PAIR_SHIPS];
+                counts[counts_num++].layouts = 0;
+            }
+            counts[counts_num - 1].layouts++;
+        }
+        if ((uint32_t) (rank * 2654435761u) % ENUMERATE_SAMPLE_GAP == 0)
+        {
+            enumerate_sample(rank, &layout);
+        }
+
+        if (target != NULL)
+        {
+            PredefinedBoard_t board;
+            fleet_layout_board(&layout, &board);
+            for (uint8_t reflection = 0; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+            {
+                if (*target_rank == ENUMERATE_RANK_NONE && !memcmp(board, reflections[reflection], sizeof(board)))
+                {
+                    *target_rank = rank;
+                }
+            }
+        }
+        previous = layout;
+        rank++;
+    } while (fleet_layout_next(&layout));
+    enumerate_sample(rank - 1, &previous);
+    return rank;
+}
+
+/**
+ * @brief Writes the rank tables as C source.
+ *
+ * @param path The file to write.
+ * @param layouts The number of layouts.
+ * @return true if the file was written.
+ */
+static bool enumerate_write_table(const char* path, uint32_t layouts)
+{
+    FILE* file = fopen(path, "w");
+
+    if (file == NULL)
+    {
+        perror(path);
+        return false;
+    }
+    // the generated file keeps the CRLF line endings of the game sources
+    fprintf(file, "/**\r\n");
+    fprintf(file, " * @file   fleet_layout_table.c\r\n");
+    fprintf(file, " * @brief  Rank tables of the fleet layouts, generated by host/fleet_enumerate -t, do not edit.\r\n");
+    fprintf(file, " *\r\n");
+    fprintf(file, " * The %u pairs of placements of the first two ships starting the %lu canonical\r\n", pairs_num,
+            (unsigned long) layouts);
+    fprintf(file, " * layouts, the counts for the third ship of the pairs a reflection leaves as\r\n");
+    fprintf(file, " * they are and the reflections of the short placements, see fleet_layout.h.\r\n");
+    fprintf(file, " *\r\n");
+    fprintf(file, " * @author Corey Hines\r\n");
+    fprintf(file, " * @date   17/10/2024\r\n");
+    fprintf(file, " */\r\n\r\n");
+    fprintf(file, "#include <avr/pgmspace.h>\r\n");
+    fprintf(file, "#include \"fleet_layout.h\"\r\n\r\n");
+    fprintf(file, "const uint32_t FLEET_LAYOUTS_NUM = %luUL;\r\n\r\n", (unsigned long) layouts);
+    fprintf(file, "const uint16_t FLEET_LAYOUT_PAIRS_NUM = %u;\r\n\r\n", pairs_num);
+    fprintf(file, "const FleetLayoutPair_t FLEET_LAYOUT_PAIRS[] PROGMEM = {\r\n");
+    for (uint16_t pair = 0; pair < pairs_num; pair++)
+    {
+        fprintf(file, "    {{%u, %u}, %u, %u, %luUL},\r\n", pairs[pair].placements[0], pairs[pair].placements[1],
+                pairs[pair].reflections, pairs[pair].counts, (unsigned long) pairs[pair].first);
+    }
+    fprintf(file, "};\r\n\r\n");
+    fprintf(file, "const uint16_t FLEET_LAYOUT_COUNTS_NUM = %u;\r\n\r\n", counts_num);
+    fprintf(file, "const FleetLayoutCount_t FLEET_LAYOUT_COUNTS[] PROGMEM = {\r\n");
+    for (uint16_t count = 0; count < counts_num; count++)
+    {
+        fprintf(file, "    {%u, %u},\r\n", counts[count].placement, counts[count].layouts);
+    }
+    fprintf(file, "};\r\n\r\n");
+    fprintf(file, "const uint8_t FLEET_SHORT_REFLECTIONS[FLEET_LAYOUT_REFLECTIONS_NUM - 1][FLEET_SHORT_PLACEMENTS_NUM] PROGMEM = {\r\n");
+    for (uint8_t reflection = 1; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+    {
+        fprintf(file, "    {");
+        for (uint8_t placement = 0; placement < FLEET_SHORT_PLACEMENTS_NUM; placement++)
+        {
+            fprintf(file, "%s%u", placement ? ", " : "",
+                    fleet_placement_reflect(FLEET_SHORT_LENGTH, placement, reflection));
+        }
+        fprintf(file, "},\r\n");
+    }
+    fprintf(file, "};\r\n");
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Runs the steps of a walk to the end, counting them.
+ *
+ * @param step The step function, fleet_layout_rank_step() or fleet_layout_unrank_step().
+ * @param walk The walk, already started.
+ * @return The number of steps.
+ */
+static uint16_t enumerate_steps(bool (*step)(void*), FleetWalk_t* walk)
+{
+    uint16_t steps = 1;
+
+    while (!step(walk))
+    {
+        steps++;
+    }
+    return steps;
+}
+
+/**
+ * @brief Checks the compiled rank tables, fleet_layout_unrank() and fleet_layout_rank_step() against the walk.
+ *
+ * @param layouts The number of layouts.
+ * @return true if everything matched.
+ */
+static bool enumerate_check_table(uint32_t layouts)
+{
+    uint32_t failures = 0;
+    uint16_t steps_most = 0;
+
+    if (FLEET_LAYOUTS_NUM != layouts || FLEET_LAYOUT_PAIRS_NUM != pairs_num || FLEET_LAYOUT_COUNTS_NUM != counts_num)
+    {
+        printf("table has %lu layouts in %u pairs with %u counts, the walk %lu in %u with %u, regenerate it with -t\n",
+               (unsigned long) FLEET_LAYOUTS_NUM, FLEET_LAYOUT_PAIRS_NUM, FLEET_LAYOUT_COUNTS_NUM,
+               (unsigned long) layouts, pairs_num, counts_num);
+        return false;
+    }
+    for (uint16_t pair = 0; pair < pairs_num; pair++)
+    {
+        const FleetLayoutPair_t* table = &FLEET_LAYOUT_PAIRS[pair];
+        if (memcmp(table->placements, pairs[pair].placements, FLEET_PAIR_SHIPS)
+            || table->reflections != pairs[pair].reflections || table->counts != pairs[pair].counts
+            || table->first != pairs[pair].first)
+        {
+            printf("pair %u differs from the walk\n", pair);
+            failures++;
+        }
+    }
+    for (uint16_t count = 0; count < counts_num; count++)
+    {
+        if (FLEET_LAYOUT_COUNTS[count].placement != counts[count].placement
+            || FLEET_LAYOUT_COUNTS[count].layouts != counts[count].layouts)
+        {
+            printf("count %u differs from the walk\n", count);
+            failures++;
+        }
+    }
+    for (uint8_t reflection = 1; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+    {
+        for (uint8_t placement = 0; placement < FLEET_SHORT_PLACEMENTS_NUM; placement++)
+        {
+            if (FLEET_SHORT_REFLECTIONS[reflection - 1][placement]
+                != fleet_placement_reflect(FLEET_SHORT_LENGTH, placement, reflection))
+            {
+                printf("short placement %u reflected %u differs\n", placement, reflection);
+                failures++;
+            }
+        }
+    }
+
+    clock_t start = clock();
+    for (uint32_t sample = 0; sample < samples_num; sample++)
+    {
+        FleetWalk_t walk;
+        PredefinedBoard_t board;
+        fleet_layout_unrank_start(&walk, samples[sample].rank);
+        uint16_t steps = enumerate_steps(fleet_layout_unrank_step, &walk);
+        steps_most = steps > steps_most ? steps : steps_most;
+        fleet_layout_board(&walk.layout, &board);
+        if (memcmp(board, samples[sample].board, sizeof(board)))
+        {
+            printf("rank %lu unranks to the wrong board\n", (unsigned long) samples[sample].rank);
+            failures++;
+        }
+    }
+    double unrank_seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    for (uint32_t sample = 0; sample < samples_num; sample++)
+    {
+        const EnumerateSample_t* checked = &samples[sample];
+        for (uint8_t reflection = 0; reflection < FLEET_LAYOUT_REFLECTIONS_NUM; reflection++)
+        {
+            FleetLayout_t reflected = checked->layout;
+            FleetLayout_t canonical;
+            FleetWalk_t walk;
+            fleet_layout_reflect(&reflected, reflection);
+            canonical = reflected;
+            uint8_t back = fleet_layout_canonicalize(&canonical);
+            fleet_layout_reflect(&canonical, back);
+            if (memcmp(&canonical, &reflected, sizeof(canonical)))
+            {
+                printf("rank %lu reflected %u is not put back\n", (unsigned long) checked->rank, reflection);
+                failures++;
+            }
+            fleet_layout_reflect(&canonical, back);
+            fleet_layout_rank_start(&walk, &canonical);
+            uint16_t steps = enumerate_steps(fleet_layout_rank_step, &walk);
+            steps_most = steps > steps_most ? steps : steps_most;
+            if (walk.rank != checked->rank)
+            {
+                printf("rank %lu reflected %u ranks to %lu\n", (unsigned long) checked->rank, reflection,
+                       (unsigned long) walk.rank);
+                failures++;
+            }
+        }
+    }
+    double rank_seconds = (double) (clock() - start) / CLOCKS_PER_SEC;
+
+    if (steps_most > FLEET_LAYOUT_STEPS_MAX)
+    {
+        printf("a walk took %u steps, more than %d\n", steps_most, FLEET_LAYOUT_STEPS_MAX);
+        failures++;
+    }
+    printf("checked %u pairs, %u counts, %lu unranks and %lu ranks, %.1f us per unrank, %.1f us per rank, "
+           "%u job steps at most\n",
+           pairs_num, counts_num, (unsigned long) samples_num,
+           (unsigned long) (FLEET_LAYOUT_REFLECTIONS_NUM * samples_num),
+           samples_num ? 1e6 * unrank_seconds / samples_num : 0.0,
+           samples_num ? 1e6 * rank_seconds / (FLEET_LAYOUT_REFLECTIONS_NUM * samples_num) : 0.0, steps_most);
+    return failures == 0;
+}
+
+/**
+ * @brief Runs the enumeration.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv The command line arguments.
+ * @return 0 on success, 1 when a check fails, 2 on a usage error.
+ */
+int main(int argc, char** argv)
+{
+    const char* table_path = NULL;
+    uint32_t rank = ENUMERATE_RANK_NONE;
+    int board_id = -1;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:r:b:")) != -1)
+    {
+        switch (option)
+        {
+            case 't':
+                table_path = optarg;
+                break;
+            case 'r':
+                rank = strtoul(optarg, NULL, 0);
+                break;
+            case 'b':
+                board_id = atoi(optarg);
+                break;
+            default:
+                optind = argc + 1;
+                break;
+        }
+    }
+    if (optind != argc)
+    {
+        fprintf(stderr, "usage: %s [-t table file] [-r rank] [-b predefined board id]\n", argv[0]);
+        return 2;
+    }
+
+    if (rank != ENUMERATE_RANK_NONE)
+    {
+        PredefinedBoard_t board;
+        fleet_layout_unrank(rank, &board);
+        printf("rank %lu\n", (unsigned long) (rank % FLEET_LAYOUTS_NUM));
+        enumerate_print_board(&board);
+        return 0;
+    }
+
+    PredefinedBoard_t target;
+    if (board_id >= 0 && !predefined_board_read((uint8_t) board_id, &target))
+    {
+        fprintf(stderr, "fleet_enumerate: no predefined board %d\n", board_id);
+        return 2;
+    }
+
+    uint32_t target_rank;
+    uint32_t layouts = enumerate_walk(board_id >= 0 ? &target : NULL, &target_rank);
+    printf("%lu layouts, %u pairs, %u counts, %d bytes per rank\n", (unsigned long) layouts, pairs_num, counts_num,
+           FLEET_LAYOUT_RANK_BYTES);
+
+    if (board_id >= 0)
+    {
+        if (target_rank == ENUMERATE_RANK_NONE)
+        {
+            printf("predefined board %d is not a layout of the fleet\n", board_id);
+            return 1;
+        }
+        printf("predefined board %d is rank %lu\n", board_id, (unsigned long) target_rank);
+        return 0;
+    }
+    if (table_path != NULL)
+    {
+        return enumerate_write_table(table_path, layouts) ? 0 : 1;
+    }
+    return enumerate_check_table(layouts) ? 0 : 1;
+}
@@ -0,0 +1,19 @@
+/** 
+ * @file   font5x7_1.h
+ * @brief  Host stand-in for the UCFK4 5x7 font.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef FONT5X7_1_H
+#define FONT5X7_1_H
+
+#include "font.h"
+
+#define FONT5X7_1_WIDTH 5
+#define FONT5X7_1_HEIGHT 7
+
+/** @brief The 5x7 font used by the game. */
+static font_t font5x7_1 __attribute__((unused)) = {FONT5X7_1_WIDTH, FONT5X7_1_HEIGHT};
+
+#endif /* FONT5X7_1_H */
@@ -0,0 +1,388 @@
+/**
+ * @file   frame_trace_dump.c
+ * @brief  Turns a frame trace recorded on the host into ASCII, a PPM image or input latencies.
+ *
+ * The trace format is described in host/utils/frame_trace.h. By default every
+ * record is printed as text, frames as rows of '#' for full, '+' for medium,
+ * '-' for dim and '.' for dark LEDs. With -p the frames are drawn side by
+ * side into a PPM contact sheet instead, and with -l the ticks from each
+ * input to the next change shown on the LED matrix are reported, along with
+ * their mean and worst case.
+ *
+ * Usage: frame_trace_dump [-p image.ppm] [-s first frame] [-n frames] [-l] trace
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include "frame_trace.h"
+
+#define DUMP_SHEET_COLUMNS 16   // Frames across each row of the contact sheet
+#define DUMP_LED_PIXELS 6       // Width and height of an LED in the contact sheet
+#define DUMP_LED_GAP 1          // Pixels between LEDs in the contact sheet
+#define DUMP_FRAME_GAP 4        // Pixels between frames in the contact sheet
+#define DUMP_DEFAULT_FRAMES 64  // Frames drawn in the contact sheet by default
+#define DUMP_LEVELS ".-+#"      // Character printed for each brightness, dark to full
+
+/**
+ * @struct DumpRecord_t
+ * @brief  A record read from a trace.
+ */
+typedef struct
+{
+    FrameTraceRecord_t type;                /**< The type of the record. */
+    uint64_t tick;                          /**< Tick the record happened on. */
+    uint8_t high[LEDMAT_COLS_NUM];          /**< The high plane of a frame record. */
+    uint8_t low[LEDMAT_COLS_NUM];           /**< The low plane of a frame record. */
+    char text[FRAME_TRACE_TEXT_MAX + 1];    /**< The text of a text record. */
+    uint8_t input;                          /**< The input of an input record. */
+} DumpRecord_t;
+
+/** @brief Names of the navswitch directions, indexed by direction. */
+static const char* const NAVSWITCH_NAMES[] = {"north", "east", "south", "west", "push"};
+
+/** @brief Red of an LED at each brightness in the contact sheet, dark to full. */
+static const uint8_t DUMP_LEVEL_REDS[] = {40, 110, 180, 255};
+
+/**
+ * @brief Gets the brightness of an LED in a frame.
+ *
+ * @param high The high plane of the frame.
+ * @param low The low plane of the frame.
+ * @param col The column of the LED.
+ * @param row The row of the LED.
+ * @return 0 for dark, 1 for dim, 2 for medium and 3 for full.
+ */
+static uint8_t dump_level(const uint8_t* high, const uint8_t* low, uint8_t col, uint8_t row)
+{
+    return ((high[col] & BIT(row)) ? 2 : 0) + ((low[col] & BIT(row)) ? 1 : 0);
+}
+
+/**
+ * @brief Reads and checks the header of a trace.
+ *
+ * @param file The trace.
+ * @return true if the header is one this tool reads.
+ */
+static bool dump_read_header(FILE* file)
+{
+    uint8_t header[FRAME_TRACE_MAGIC_SIZE + 3];
+
+    if (fread(header, 1, sizeof(header), file) != sizeof(header)
+        || memcmp(header, FRAME_TRACE_MAGIC, FRAME_TRACE_MAGIC_SIZE) != 0)
+    {
+        fprintf(stderr, "frame_trace_dump: not a frame trace\n");
+        return false;
+    }
+    if (header[FRAME_TRACE_MAGIC_SIZE] != FRAME_TRACE_VERSION
+        || header[FRAME_TRACE_MAGIC_SIZE + 1] != LEDMAT_COLS_NUM
+        || header[FRAME_TRACE_MAGIC_SIZE + 2] != LEDMAT_ROWS_NUM)
+    {
+        fprintf(stderr, "frame_trace_dump: unsupported version %u or size %ux%u\n",
+                header[FRAME_TRACE_MAGIC_SIZE], header[FRAME_TRACE_MAGIC_SIZE + 1],
+                header[FRAME_TRACE_MAGIC_SIZE + 2]);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Reads the next record of a trace.
+ *
+ * @param file The trace, positioned at a record.
+ * @param record The record read, its tick continues from the last record.
+ * @return true if a record was read, false at the end of the trace or on a truncated record.
+ */
+static bool dump_read_record(FILE* file, DumpRecord_t* record)
+{
+    int type = fgetc(file);
+    if (type == EOF)
+    {
+        return false;
+    }
+
+    uint64_t delta = 0;
+    for (uint8_t shift = 0; ; shift += 7)
+    {
+        int byte = fgetc(file);
+        if (byte == EOF || shift > 56)
+        {
+            return false;
+        }
+        delta |= (uint64_t) (byte & 0x7F) << shift;
+        if (!(byte & 0x80))
+        {
+            break;
+        }
+    }
+    record->type = type;
+    record->tick += delta;
+
+    switch (type)
+    {
+        case FRAME_TRACE_FRAME:
+            return fread(record->high, 1, LEDMAT_COLS_NUM, file) == LEDMAT_COLS_NUM
+                && fread(record->low, 1, LEDMAT_COLS_NUM, file) == LEDMAT_COLS_NUM;
+        case FRAME_TRACE_TEXT: {
+            int length = fgetc(file);
+            if (length == EOF || fread(record->text, 1, length, file) != (size_t) length)
+            {
+                return false;
+            }
+            record->text[length] = '\0';
+            return true;
+        }
+        case FRAME_TRACE_INPUT: {
+            int input = fgetc(file);
+            record->input = input;
+            return input != EOF;
+        }
+        default:
+            fprintf(stderr, "frame_trace_dump: unknown record type %d\n", type);
+            return false;
+    }
+}
+
+/**
+ * @brief Gets the name of an input.
+ *
+ * @param input The input of an input record.
+ * @return The name, "button" for any button.
+ */
+static const char* dump_input_name(uint8_t input)
+{
+    if (input & FRAME_TRACE_INPUT_BUTTON)
+    {
+        return "button";
+    }
+    return input < sizeof(NAVSWITCH_NAMES) / sizeof(NAVSWITCH_NAMES[0]) ? NAVSWITCH_NAMES[input] : "unknown";
+}
+
+/**
+ * @brief Prints every record of a trace as text.
+ *
+ * @param file The trace, positioned after its header.
+ */
+static void dump_ascii(FILE* file)
+{
+    DumpRecord_t record = {0};
+
+    while (dump_read_record(file, &record))
+    {
+        switch (record.type)
+        {
+            case FRAME_TRACE_FRAME:
+                printf("%10llu frame\n", (unsigned long long) record.tick);
+                for (uint8_t row = 0; row < LEDMAT_ROWS_NUM; row++)
+                {
+                    printf("           ");
+                    for (uint8_t col = 0; col < LEDMAT_COLS_NUM; col++)
+                    {
+                        putchar(DUMP_LEVELS[dump_level(record.high, record.low, col, row)]);
+                    }
+                    putchar('\n');
+                }
+                break;
+            case FRAME_TRACE_TEXT:
+                printf("%10llu text \"%s\"\n", (unsigned long long) record.tick, record.text);
+                break;
+            case FRAME_TRACE_INPUT:
+                printf("%10llu input %s\n", (unsigned long long) record.tick, dump_input_name(record.input));
+                break;
+        }
+    }
+}
+
+/**
+ * @brief Reports the ticks from each input to the next change on the LED matrix.
+ *
+ * A new frame or new text both count as a change. Inputs which arrive while
+ * an earlier one is still waiting are measured to the same change.
+ *
+ * @param file The trace, positioned after its header.
+ */
+static void dump_latency(FILE* file)
+{
+    DumpRecord_t record = {0};
+    uint64_t waiting[64];
+    uint8_t waiting_count = 0;
+    uint64_t measured = 0;
+    uint64_t total = 0;
+    uint64_t worst = 0;
+
+    while (dump_read_record(file, &record))
+    {
+        if (record.type == FRAME_TRACE_INPUT)
+        {
+            if (waiting_count < sizeof(waiting) / sizeof(waiting[0]))
+            {
+                waiting[waiting_count++] = record.tick;
+            }
+            continue;
+        }
+        for (uint8_t input = 0; input < waiting_count; input++)
+        {
+            uint64_t latency = record.tick - waiting[input];
+            printf("%10llu input, changed after %llu ticks\n",
+                   (unsigned long long) waiting[input], (unsigned long long) latency);
+            measured++;
+            total += latency;
+            worst = latency > worst ? latency : worst;
+        }
+        waiting_count = 0;
+    }
+
+    printf("%llu inputs measured, mean %.1f ticks, worst %llu ticks, %u never changed the display\n",
+           (unsigned long long) measured, measured ? (double) total / measured : 0.0,
+           (unsigned long long) worst, waiting_count);
+}
+
+/**
+ * @brief Draws frames of a trace side by side into a PPM contact sheet.
+ *
+ * @param file The trace, positioned after its header.
+ * @param path The image to write.
+ * @param first Index of the first frame drawn.
+ * @param count Most frames drawn.
+ * @return true if the image was written.
+ */
+static bool dump_ppm(FILE* file, const char* path, uint64_t first, uint64_t count)
+{
+    DumpRecord_t record = {0};
+    uint8_t (*frames)[2][LEDMAT_COLS_NUM] = calloc(count ? count : 1, 2 * LEDMAT_COLS_NUM);
+    uint64_t index = 0;
+    uint64_t drawn = 0;
+
+    while (drawn < count && dump_read_record(file, &record))
+    {
+        if (record.type == FRAME_TRACE_FRAME && index++ >= first)
+        {
+            memcpy(frames[drawn][0], record.high, LEDMAT_COLS_NUM);
+            memcpy(frames[drawn++][1], record.low, LEDMAT_COLS_NUM);
+        }
+    }
+    if (drawn == 0)
+    {
+        fprintf(stderr, "frame_trace_dump: no frames to draw\n");
+        free(frames);
+        return false;
+    }
+
+    const unsigned led = DUMP_LED_PIXELS + DUMP_LED_GAP;
+    const unsigned frame_width = LEDMAT_COLS_NUM * led + DUMP_FRAME_GAP;
+    const unsigned frame_height = LEDMAT_ROWS_NUM * led + DUMP_FRAME_GAP;
+    const unsigned across = drawn < DUMP_SHEET_COLUMNS ? drawn : DUMP_SHEET_COLUMNS;
+    const unsigned down = (drawn + DUMP_SHEET_COLUMNS - 1) / DUMP_SHEET_COLUMNS;
+    const unsigned width = across * frame_width;
+    const unsigned height = down * frame_height;
+
+    FILE* image = fopen(path, "wb");
+    if (image == NULL)
+    {
+        perror("frame_trace_dump");
+        free(frames);
+        return false;
+    }
+    fprintf(image, "P6\n%u %u\n255\n", width, height);
+    for (unsigned y = 0; y < height; y++)
+    {
+        for (unsigned x = 0; x < width; x++)
+        {
+            uint64_t frame = (y / frame_height) * DUMP_SHEET_COLUMNS + x / frame_width;
+            unsigned fx = x % frame_width;
+            unsigned fy = y % frame_height;
+            // gaps are black, dark LEDs grey and lit LEDs red like the matrix, brighter the longer they are lit
+            uint8_t rgb[3] = {0, 0, 0};
+            if (frame < drawn && fx < LEDMAT_COLS_NUM * led && fy < LEDMAT_ROWS_NUM * led
+                && fx % led < DUMP_LED_PIXELS && fy % led < DUMP_LED_PIXELS)
+            {
+                uint8_t level = dump_level(frames[frame][0], frames[frame][1], fx / led, fy / led);
+                rgb[0] = DUMP_LEVEL_REDS[level];
+                rgb[1] = level ? 32 : 40;
+                rgb[2] = level ? 32 : 40;
+            }
+            fwrite(rgb, 1, sizeof(rgb), image);
+        }
+    }
+    fclose(image);
+    free(frames);
+    printf("%llu frames drawn to %s\n", (unsigned long long) drawn, path);
+    return true;
+}
+
+/**
+ * @brief Dumps a frame trace.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv The command line arguments.
+ * @return 0 on success, 1 if the trace could not be read or the image written, 2 on a usage error.
+ */
+int main(int argc, char** argv)
+{
+    const char* image = NULL;
+    uint64_t first = 0;
+    uint64_t count = DUMP_DEFAULT_FRAMES;
+    bool latency = false;
+    int option;
+
+    while ((option = getopt(argc, argv, "p:s:n:l")) != -1)
+    {
+        switch (option)
+        {
+            case 'p':
+                image = optarg;
+                break;
+            case 's':
+                first = strtoull(optarg, NULL, 0);
+                break;
+            case 'n':
+                count = strtoull(optarg, NULL, 0);
+                break;
+            case 'l':
+                latency = true;
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-p image.ppm] [-s first frame] [-n frames] [-l] trace\n", argv[0]);
+        return 2;
+    }
+
+    FILE* file = fopen(argv[optind], "rb");
+    if (file == NULL)
+    {
+        perror("frame_trace_dump");
+        return 1;
+    }
+    if (!dump_read_header(file))
+    {
+        fclose(file);
+        return 1;
+    }
+
+    bool ok = true;
+    if (image != NULL)
+    {
+        ok = dump_ppm(file, image, first, count);
+    }
+    else if (latency)
+    {
+        dump_latency(file);
+    }
+    else
+    {
+        dump_ascii(file);
+    }
+    fclose(file);
+    return ok ? 0 : 1;
+}
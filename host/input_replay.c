@@ -0,0 +1,121 @@
+/**
+ * @file   input_replay.c
+ * @brief  Replays an input trace into a host instance of the game.
+ *
+ * The trace, recorded on a UCFK4 built with make INPUT_TRACE=record and read
+ * from its EEPROM, or by ir_link_soak -i, is loaded into the EEPROM stand-in
+ * and the game is started in replay mode, see input_trace.h. The game then
+ * reads every navigation switch push, button push, IR byte and timer read
+ * from the trace on the tick it was recorded, so it plays the recorded game
+ * again exactly.
+ *
+ * Every change of game state is printed with its tick, so replays of the same
+ * trace by two builds can be compared. The replay diverged when a record was
+ * not read on its tick, which means the build reads its inputs differently
+ * from the one which recorded the trace.
+ *
+ * Usage: input_replay [-t max ticks] trace
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include <avr/eeprom.h>
+#include "game.h"
+#include "input_trace.h"
+#include "pacer.h"
+
+#define REPLAY_DEFAULT_MAX_TICKS 500000 // Ticks before the replay is given up on, about 17 minutes
+#define REPLAY_SETTLE_TICKS 1000        // Ticks run after the last record for the game to finish
+
+/** @brief Names of the game states, indexed by GameState_t. */
+static const char* const STATE_NAMES[GAME_STATE_END + 1] = {
+    "TITLE_SCREEN",
+    "SELECT_PLAYER",
+    "CHOOSE_BOARD",
+    "EDIT_BOARD",
+    "AWAIT_BOARD_EXCHANGE",
+    "SELECT_SHOOT_POSITION",
+    "AWAIT_SHOT_RESULT",
+    "THEIR_TURN",
+    "END",
+};
+
+/**
+ * @brief Replays an input trace.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv The command line arguments.
+ * @return 0 if every record was replayed on its tick, 1 if the replay diverged, 2 on error.
+ */
+int main(int argc, char** argv)
+{
+    uint64_t max_ticks = REPLAY_DEFAULT_MAX_TICKS;
+    int option;
+
+    while ((option = getopt(argc, argv, "t:")) != -1)
+    {
+        switch (option)
+        {
+            case 't':
+                max_ticks = strtoull(optarg, NULL, 0);
+                break;
+            default:
+                optind = argc;
+                break;
+        }
+    }
+    if (optind != argc - 1)
+    {
+        fprintf(stderr, "usage: %s [-t max ticks] trace\n", argv[0]);
+        return 2;
+    }
+    if (!eeprom_host_load(argv[optind]))
+    {
+        perror("input_replay");
+        return 2;
+    }
+
+    input_trace_set_mode(INPUT_TRACE_REPLAY);
+    game_init();
+    if (input_trace_get_mode() != INPUT_TRACE_REPLAY)
+    {
+        fprintf(stderr, "input_replay: %s is not an input trace, or it was cut short\n", argv[optind]);
+        return 2;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    GameState_t state = game_get_state();
+    uint64_t settle = 0;
+    uint64_t tick;
+    for (tick = 0; tick < max_ticks && settle < REPLAY_SETTLE_TICKS; tick++)
+    {
+        pacer_wait();
+        game_update();
+        if (game_get_state() != state)
+        {
+            state = game_get_state();
+            printf("%10llu %s\n", (unsigned long long) tick, STATE_NAMES[state]);
+        }
+        if (input_trace_replayed())
+        {
+            settle = state == GAME_STATE_END ? REPLAY_SETTLE_TICKS : settle + 1;
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("%llu ticks in %.3f s, %.0f ns per tick, ended in %s\n", (unsigned long long) tick,
+           seconds, tick ? seconds * 1e9 / tick : 0.0, STATE_NAMES[state]);
+    printf("skipped %u records%s\n", input_trace_skipped(),
+           input_trace_replayed() ? "" : ", gave up before the last record");
+
+    return (input_trace_skipped() || !input_trace_replayed()) ? 1 : 0;
+}
@@ -0,0 +1,711 @@
+/**
+ * @file   ir_link_soak.c
+ * @brief  Plays complete games between two host instances of the game over a simulated IR link.
+ *
+ * Two independent instances of the game are loaded from host/build/libgame.so,
+ * each in its own link namespace so every static variable, board and driver
+ * stand-in is private to its instance, exactly like two UCFK4s. Every game is
+ * played in a forked child, so it starts from untouched copies of both
+ * instances, the same as powering both boards on, and a crash only loses the
+ * one game.
+ *
+ * The instances run in lock step, one pacer tick at a time. Bytes one instance
+ * sends with ir_uart_putc() cross a simulated channel to the other instance,
+ * which can delay, drop, corrupt and echo them back to the sender. A bot on each
+ * instance pushes its navigation switch and button to play the game: picking
+ * its player number and a board, one of the predefined boards 1 to 5, a
+ * random board revealed as its seed or an edited board revealed as its fleet layout
+ * code, then shooting at random cells it has not shot. In the board editor the
+ * bot places every ship where it starts, at the first place it fits.
+ *
+ * A game completes when both instances reach GAME_STATE_END and have checked
+ * the board the other revealed, see commit.h, and is counted as hung when it
+ * does not complete within a tick limit, together with the states both
+ * instances were stuck in. Neither bot cheats, so a game where either
+ * instance found the other's board did not match counts as failed: a
+ * corrupted frame got past the link and into the game.
+ *
+ * With -w the bots wait for scrolling messages to finish before pushing
+ * anything, like a person reading them would. With -f, what player 1 shows
+ * on its LED matrix during the first game is recorded to a frame trace, see
+ * host/utils/frame_trace.h. With -i, the inputs player 1 reads during the
+ * first game are recorded to an input trace, see input_trace.h, which
+ * host/input_replay plays back.
+ *
+ * Usage: ir_link_soak [-n games] [-l latency] [-p loss] [-c corruption]
+ *                     [-e echo] [-t max ticks] [-s seed] [-w] [-f trace]
+ *                     [-i trace] [library]
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "game_state.h"
+#include "navswitch.h"
+#include "button.h"
+#include "input_trace.h"
+#include "commit.h"
+
+#define SOAK_DEFAULT_LIBRARY "host/build/libgame.so" // Library the instances are loaded from
+#define SOAK_DEFAULT_GAMES 1000                      // Games to play
+#define SOAK_DEFAULT_LATENCY 2                       // Ticks a byte takes to cross, about one byte at 2400 baud
+#define SOAK_DEFAULT_MAX_TICKS 500000                // Ticks before a game counts as hung, about 17 minutes
+
+#define SOAK_NODES_NUM 2                  // Number of instances of the game
+#define SOAK_STATES_NUM (GAME_STATE_END + 1) // Number of game states
+#define SOAK_ROWS_NUM 7                   // Rows on the board
+#define SOAK_COLS_NUM 5                   // Columns on the board
+#define SOAK_CELLS_NUM (SOAK_ROWS_NUM * SOAK_COLS_NUM) // Cells on the board
+#define SOAK_CHANNEL_SIZE 256             // Bytes in flight to each instance, must match the range of a uint8_t index
+#define SOAK_SAVE_TICKS 1000              // Most ticks run after a game for the input trace to reach EEPROM
+
+/**
+ * @struct SoakNode_t
+ * @brief  An instance of the game, the entry points used to drive it and the bot playing it.
+ */
+typedef struct
+{
+    void* handle;                                /**< The loaded instance. */
+    void (*game_init)(void);                     /**< Entry points of the instance. */
+    void (*game_update)(void);
+    GameState_t (*game_get_state)(void);
+    CommitResult_t (*commit_get_result)(void);
+    bool (*screen_scrolling_message_active)(void);
+    void (*pacer_wait)(void);
+    void (*navswitch_host_push)(uint8_t navswitch);
+    void (*button_host_push)(uint8_t button);
+    void (*ir_uart_host_receive)(char ch);
+    bool (*ir_uart_host_transmit)(char* ch);
+    void (*timer_host_set)(uint16_t now);
+    bool (*frame_trace_open)(const char* path);
+    void (*frame_trace_close)(void);
+    void (*input_trace_set_mode)(InputTraceMode_t mode);
+    bool (*input_trace_saved)(void);
+    uint16_t (*input_trace_saved_size)(void);
+    bool (*input_trace_truncated)(void);
+    bool (*eeprom_host_save)(const char* path, size_t size);
+
+    uint8_t player;        /**< The player number the bot picks. */
+    bool player_chosen;    /**< True once the bot has moved to its player number. */
+    uint8_t board_moves;   /**< Pushes left before the bot confirms its board. */
+    int8_t cursor_row;     /**< Row of the game's cursor, tracked from the bot's pushes. */
+    int8_t cursor_col;     /**< Column of the game's cursor, tracked from the bot's pushes. */
+    int8_t target;         /**< The cell the bot is walking to, -1 when it has none. */
+    uint64_t shot;         /**< Bit n is set once the bot has shot cell n. */
+} SoakNode_t;
+
+/**
+ * @struct SoakByte_t
+ * @brief  A byte crossing the channel.
+ */
+typedef struct
+{
+    uint64_t tick; /**< Tick the byte arrives on. */
+    char ch;       /**< The byte. */
+} SoakByte_t;
+
+/**
+ * @struct SoakChannel_t
+ * @brief  Bytes in flight to one instance, in order of arrival.
+ */
+typedef struct
+{
+    SoakByte_t bytes[SOAK_CHANNEL_SIZE]; /**< The bytes in flight. */
+    uint8_t head;                        /**< Index the next byte is written to. */
+    uint8_t tail;                        /**< Index the next byte arrives from. */
+} SoakChannel_t;
+
+/**
+ * @struct SoakConfig_t
+ * @brief  How the channel treats each byte, how the bots play and where the game is recorded.
+ */
+typedef struct
+{
+    uint32_t latency;   /**< Ticks a byte takes to cross. */
+    double loss;        /**< Probability a byte is dropped. */
+    double corruption;  /**< Probability a byte has one bit flipped. */
+    double echo;        /**< Probability a byte is also received by its sender. */
+    bool wait;          /**< True if the bots wait for scrolling messages to finish. */
+    const char* trace;  /**< Frame trace player 1 is recorded to, NULL for none. */
+    const char* inputs; /**< Input trace player 1 is recorded to, NULL for none. */
+} SoakConfig_t;
+
+/**
+ * @struct SoakCounts_t
+ * @brief  What happened over every game.
+ */
+typedef struct
+{
+    uint64_t completed; /**< Games where both instances reached the end state and checked the other's board. */
+    uint64_t mismatched; /**< Completed games where either instance found the other's board did not match. */
+    uint64_t hung;      /**< Games which did not complete within the tick limit. */
+    uint64_t crashed;   /**< Games where the process playing them died. */
+    uint64_t ticks;     /**< Ticks of every completed game. */
+    uint64_t sent;      /**< Bytes sent by both instances. */
+    uint64_t lost;      /**< Bytes dropped by the channel. */
+    uint64_t corrupted; /**< Bytes corrupted by the channel. */
+    uint64_t echoed;    /**< Bytes echoed back to their sender. */
+    uint64_t stuck[SOAK_STATES_NUM][SOAK_STATES_NUM]; /**< Hung games by the state of each instance. */
+} SoakCounts_t;
+
+/** @brief Names of the game states, indexed by GameState_t. */
+static const char* const STATE_NAMES[SOAK_STATES_NUM] = {
+    "TITLE_SCREEN",
+    "SELECT_PLAYER",
+    "CHOOSE_BOARD",
+    "EDIT_BOARD",
+    "AWAIT_BOARD_EXCHANGE",
+    "SELECT_SHOOT_POSITION",
+    "AWAIT_SHOT_RESULT",
+    "THEIR_TURN",
+    "END",
+};
+
+/** @brief State of the pseudo random number generator. */
+static uint64_t random_state = 0x9E3779B97F4A7C15ULL;
+
+/**
+ * @brief Generates a pseudo random number with xorshift64.
+ *
+ * @return The next number in the sequence.
+ */
+static uint64_t soak_random(void)
+{
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+/**
+ * @brief Decides if an event with a given probability happens.
+ *
+ * @param probability The probability of the event, between 0 and 1.
+ * @return true if the event happens.
+ */
+static bool soak_chance(double probability)
+{
+    return probability > 0 && (soak_random() >> 11) * (1.0 / (1ULL << 53)) < probability;
+}
+
+/**
+ * @brief Looks up an entry point of an instance, exiting if it is missing.
+ *
+ * @param node The instance.
+ * @param name The name of the entry point.
+ * @return The address of the entry point.
+ */
+static void* soak_symbol(SoakNode_t* node, const char* name)
+{
+    void* symbol = dlsym(node->handle, name);
+    if (symbol == NULL)
+    {
+        fprintf(stderr, "ir_link_soak: %s\n", dlerror());
+        exit(2);
+    }
+    return symbol;
+}
+
+/**
+ * @brief Loads an instance of the game into its own link namespace.
+ *
+ * @param node The instance to load.
+ * @param library Path of the game library.
+ */
+static void soak_node_load(SoakNode_t* node, const char* library)
+{
+    memset(node, 0, sizeof(*node));
+    node->handle = dlmopen(LM_ID_NEWLM, library, RTLD_NOW | RTLD_LOCAL);
+    if (node->handle == NULL)
+    {
+        fprintf(stderr, "ir_link_soak: %s\n", dlerror());
+        exit(2);
+    }
+
+    node->game_init = soak_symbol(node, "game_init");
+    node->game_update = soak_symbol(node, "game_update");
+    node->game_get_state = soak_symbol(node, "game_get_state");
+    node->commit_get_result = soak_symbol(node, "commit_get_result");
+    node->screen_scrolling_message_active = soak_symbol(node, "screen_scrolling_message_active");
+    node->pacer_wait = soak_symbol(node, "pacer_wait");
+    node->navswitch_host_push = soak_symbol(node, "navswitch_host_push");
+    node->button_host_push = soak_symbol(node, "button_host_push");
+    node->ir_uart_host_receive = soak_symbol(node, "ir_uart_host_receive");
+    node->ir_uart_host_transmit = soak_symbol(node, "ir_uart_host_transmit");
+    node->timer_host_set = soak_symbol(node, "timer_host_set");
+    node->frame_trace_open = soak_symbol(node, "frame_trace_open");
+    node->frame_trace_close = soak_symbol(node, "frame_trace_close");
+    node->input_trace_set_mode = soak_symbol(node, "input_trace_set_mode");
+    node->input_trace_saved = soak_symbol(node, "input_trace_saved");
+    node->input_trace_saved_size = soak_symbol(node, "input_trace_saved_size");
+    node->input_trace_truncated = soak_symbol(node, "input_trace_truncated");
+    node->eeprom_host_save = soak_symbol(node, "eeprom_host_save");
+}
+
+/**
+ * @brief Starts the game on an instance and resets its bot.
+ *
+ * @param node The instance to start.
+ * @param player The player number the bot picks.
+ */
+static void soak_node_start(SoakNode_t* node, uint8_t player)
+{
+    // the cursor starts in the middle of the board, see update_select_shoot_position()
+    node->player = player;
+    node->player_chosen = false;
+    // 1 to 5 pushes choose a predefined board, 6 the random board after them and 7 the board editor
+    node->board_moves = 1 + soak_random() % 7;
+    node->cursor_row = 3;
+    node->cursor_col = 2;
+    node->target = -1;
+    node->shot = 0;
+
+    // the boards were powered on at different times
+    node->timer_host_set(soak_random());
+    node->game_init();
+}
+
+/**
+ * @brief Picks a random cell the bot has not shot.
+ *
+ * @param node The instance the bot plays.
+ * @return The index of the cell, in row major order.
+ */
+static int8_t soak_pick_target(SoakNode_t* node)
+{
+    uint8_t remaining = SOAK_CELLS_NUM - __builtin_popcountll(node->shot);
+    uint8_t skip = soak_random() % remaining;
+    for (int8_t cell = 0; cell < SOAK_CELLS_NUM; cell++)
+    {
+        if (!(node->shot & (1ULL << cell)) && skip-- == 0)
+        {
+            return cell;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Plays one tick of the game as the bot, pushing at most one input.
+ *
+ * The game reads input underneath scrolling messages, so the bot only waits
+ * for them to finish when asked to.
+ *
+ * @param node The instance the bot plays.
+ * @param wait True if the bot waits while a message scrolls.
+ */
+static void soak_bot_play(SoakNode_t* node, bool wait)
+{
+    if (wait && node->screen_scrolling_message_active())
+    {
+        return;
+    }
+
+    switch (node->game_get_state())
+    {
+        case GAME_STATE_SELECT_PLAYER:
+            if (node->player == 2 && !node->player_chosen)
+            {
+                node->navswitch_host_push(NAVSWITCH_EAST);
+                node->player_chosen = true;
+            }
+            else
+            {
+                node->button_host_push(BUTTON1);
+            }
+            break;
+        case GAME_STATE_CHOOSE_BOARD:
+            if (node->board_moves > 0)
+            {
+                node->navswitch_host_push(NAVSWITCH_WEST);
+                node->board_moves--;
+            }
+            else
+            {
+                node->button_host_push(BUTTON1);
+            }
+            break;
+        case GAME_STATE_EDIT_BOARD:
+            node->button_host_push(BUTTON1);
+            break;
+        case GAME_STATE_SELECT_SHOOT_POSITION: {
+            if (node->target < 0)
+            {
+                node->target = soak_pick_target(node);
+            }
+            int8_t target_row = node->target / SOAK_COLS_NUM;
+            int8_t target_col = node->target % SOAK_COLS_NUM;
+            if (node->cursor_row < target_row)
+            {
+                node->cursor_row++;
+                node->navswitch_host_push(NAVSWITCH_SOUTH);
+            }
+            else if (node->cursor_row > target_row)
+            {
+                node->cursor_row--;
+                node->navswitch_host_push(NAVSWITCH_NORTH);
+            }
+            else if (node->cursor_col < target_col)
+            {
+                node->cursor_col++;
+                node->navswitch_host_push(NAVSWITCH_EAST);
+            }
+            else if (node->cursor_col > target_col)
+            {
+                node->cursor_col--;
+                node->navswitch_host_push(NAVSWITCH_WEST);
+            }
+            else
+            {
+                node->shot |= 1ULL << node->target;
+                node->target = -1;
+                node->navswitch_host_push(NAVSWITCH_PUSH);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Puts a byte in flight to an instance.
+ *
+ * @param channel The channel to the instance.
+ * @param tick The tick the byte arrives on.
+ * @param ch The byte.
+ */
+static void soak_channel_put(SoakChannel_t* channel, uint64_t tick, char ch)
+{
+    channel->bytes[channel->head].tick = tick;
+    channel->bytes[channel->head].ch = ch;
+    channel->head++;
+}
+
+/**
+ * @brief Sends every byte an instance transmitted this tick across the channel.
+ *
+ * @param config How the channel treats each byte.
+ * @param counts Counts of what happened to each byte.
+ * @param channels The channels to both instances.
+ * @param sender Index of the transmitting instance.
+ * @param tick The current tick.
+ */
+static void soak_channel_send(const SoakConfig_t* config, SoakCounts_t* counts,
+                              SoakChannel_t* channels, SoakNode_t* nodes, uint8_t sender, uint64_t tick)
+{
+    char ch;
+    while (nodes[sender].ir_uart_host_transmit(&ch))
+    {
+        counts->sent++;
+        if (soak_chance(config->echo))
+        {
+            counts->echoed++;
+            soak_channel_put(&channels[sender], tick + config->latency, ch);
+        }
+        if (soak_chance(config->loss))
+        {
+            counts->lost++;
+            continue;
+        }
+        if (soak_chance(config->corruption))
+        {
+            counts->corrupted++;
+            ch ^= 1 << (soak_random() % 8);
+        }
+        soak_channel_put(&channels[!sender], tick + config->latency, ch);
+    }
+}
+
+/**
+ * @brief Delivers every byte which has arrived at an instance.
+ *
+ * Bytes arrive in the order they were sent, an echo can hold up the bytes
+ * behind it by up to the latency.
+ *
+ * @param channel The channel to the instance.
+ * @param node The receiving instance.
+ * @param tick The current tick.
+ */
+static void soak_channel_deliver(SoakChannel_t* channel, SoakNode_t* node, uint64_t tick)
+{
+    while (channel->tail != channel->head && channel->bytes[channel->tail].tick <= tick)
+    {
+        node->ir_uart_host_receive(channel->bytes[channel->tail].ch);
+        channel->tail++;
+    }
+}
+
+/**
+ * @brief Saves the input trace an instance recorded to a file.
+ *
+ * The instance is run on alone until the trace has been written to its
+ * EEPROM, which takes a tick a byte.
+ *
+ * @param node The recording instance.
+ * @param path The file to write.
+ */
+static void soak_save_inputs(SoakNode_t* node, const char* path)
+{
+    for (uint16_t tick = 0; tick < SOAK_SAVE_TICKS && !node->input_trace_saved(); tick++)
+    {
+        node->pacer_wait();
+        node->game_update();
+    }
+    if (node->input_trace_truncated())
+    {
+        fprintf(stderr, "ir_link_soak: input trace cut short, the EEPROM or the bytes waiting for it filled up, replay refuses it\n");
+    }
+    if (!node->eeprom_host_save(path, node->input_trace_saved_size()))
+    {
+        perror("ir_link_soak: input trace");
+    }
+}
+
+/**
+ * @brief Plays one game between two instances, in the calling process.
+ *
+ * @param nodes The instances, which must not have run before.
+ * @param config How the channel treats each byte, and where the game is recorded.
+ * @param max_ticks Ticks before the game counts as hung.
+ * @param counts Counts of what happened in this game.
+ */
+static void soak_play(SoakNode_t* nodes, const SoakConfig_t* config, uint64_t max_ticks, SoakCounts_t* counts)
+{
+    static SoakChannel_t channels[SOAK_NODES_NUM];
+
+    if (config->trace != NULL && !nodes[0].frame_trace_open(config->trace))
+    {
+        perror("ir_link_soak: frame trace");
+    }
+    if (config->inputs != NULL)
+    {
+        nodes[0].input_trace_set_mode(INPUT_TRACE_RECORD);
+    }
+    for (uint8_t node = 0; node < SOAK_NODES_NUM; node++)
+    {
+        soak_node_start(&nodes[node], node + 1);
+    }
+
+    uint64_t tick;
+    for (tick = 0; tick < max_ticks; tick++)
+    {
+        bool ended = true;
+        for (uint8_t node = 0; node < SOAK_NODES_NUM; node++)
+        {
+            soak_channel_deliver(&channels[node], &nodes[node], tick);
+            nodes[node].pacer_wait();
+            nodes[node].game_update();
+            soak_bot_play(&nodes[node], config->wait);
+            ended = ended && nodes[node].game_get_state() == GAME_STATE_END
+                          && nodes[node].commit_get_result() != COMMIT_PENDING;
+        }
+        for (uint8_t node = 0; node < SOAK_NODES_NUM; node++)
+        {
+            soak_channel_send(config, counts, channels, nodes, node, tick);
+        }
+        if (ended)
+        {
+            break;
+        }
+    }
+
+    nodes[0].frame_trace_close();
+    if (config->inputs != NULL)
+    {
+        soak_save_inputs(&nodes[0], config->inputs);
+    }
+
+    if (tick < max_ticks)
+    {
+        counts->completed++;
+        counts->ticks += tick + 1;
+        for (uint8_t node = 0; node < SOAK_NODES_NUM; node++)
+        {
+            if (nodes[node].commit_get_result() == COMMIT_MISMATCH)
+            {
+                counts->mismatched++;
+                break;
+            }
+        }
+    }
+    else
+    {
+        counts->hung++;
+        counts->stuck[nodes[0].game_get_state()][nodes[1].game_get_state()]++;
+    }
+}
+
+/**
+ * @brief Plays one game in a forked child and adds what happened to the counts.
+ *
+ * The instances are never run by this process, so each child starts from
+ * untouched copies of them.
+ *
+ * @param nodes The loaded instances.
+ * @param config How the channel treats each byte.
+ * @param max_ticks Ticks before the game counts as hung.
+ * @param counts Counts of what happened, updated with this game.
+ */
+static void soak_play_game(SoakNode_t* nodes, const SoakConfig_t* config, uint64_t max_ticks, SoakCounts_t* counts)
+{
+    SoakCounts_t game;
+    uint64_t seed = soak_random();
+    int pipe_fds[2];
+
+    if (pipe(pipe_fds) != 0)
+    {
+        perror("ir_link_soak: pipe");
+        exit(2);
+    }
+
+    pid_t child = fork();
+    if (child < 0)
+    {
+        perror("ir_link_soak: fork");
+        exit(2);
+    }
+    if (child == 0)
+    {
+        close(pipe_fds[0]);
+        memset(&game, 0, sizeof(game));
+        random_state = seed;
+        soak_play(nodes, config, max_ticks, &game);
+        _exit(write(pipe_fds[1], &game, sizeof(game)) == sizeof(game) ? 0 : 1);
+    }
+
+    close(pipe_fds[1]);
+    ssize_t received = read(pipe_fds[0], &game, sizeof(game));
+    close(pipe_fds[0]);
+    waitpid(child, NULL, 0);
+
+    if (received != sizeof(game))
+    {
+        counts->crashed++;
+        return;
+    }
+
+    uint64_t* total = (uint64_t*) counts;
+    const uint64_t* add = (const uint64_t*) &game;
+    for (size_t count = 0; count < sizeof(game) / sizeof(uint64_t); count++)
+    {
+        total[count] += add[count];
+    }
+}
+
+/**
+ * @brief Runs the soak test.
+ *
+ * @param argc Number of command line arguments.
+ * @param argv The command line arguments.
+ * @return 0 if every game completed, 1 if any hung, crashed or mismatched, 2 on error.
+ */
+int main(int argc, char** argv)
+{
+    SoakConfig_t config = {SOAK_DEFAULT_LATENCY, 0, 0, 0, false, NULL, NULL};
+    SoakCounts_t counts;
+    uint64_t games = SOAK_DEFAULT_GAMES;
+    uint64_t max_ticks = SOAK_DEFAULT_MAX_TICKS;
+    const char* library = SOAK_DEFAULT_LIBRARY;
+    int option;
+
+    while ((option = getopt(argc, argv, "n:l:p:c:e:t:s:wf:i:")) != -1)
+    {
+        switch (option)
+        {
+            case 'n':
+                games = strtoull(optarg, NULL, 0);
+                break;
+            case 'l':
+                config.latency = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                config.loss = strtod(optarg, NULL);
+                break;
+            case 'c':
+                config.corruption = strtod(optarg, NULL);
+                break;
+            case 'e':
+                config.echo = strtod(optarg, NULL);
+                break;
+            case 't':
+                max_ticks = strtoull(optarg, NULL, 0);
+                break;
+            case 's':
+                // xorshift must not start from zero
+                random_state = strtoull(optarg, NULL, 0) ^ 0x9E3779B97F4A7C15ULL;
+                break;
+            case 'w':
+                config.wait = true;
+                break;
+            case 'f':
+                config.trace = optarg;
+                break;
+            case 'i':
+                config.inputs = optarg;
+                break;
+            default:
+                fprintf(stderr, "usage: %s [-n games] [-l latency] [-p loss] [-c corruption] "
+                        "[-e echo] [-t max ticks] [-s seed] [-w] [-f trace] [-i trace] [library]\n", argv[0]);
+                return 2;
+        }
+    }
+    if (optind < argc)
+    {
+        library = argv[optind];
+    }
+
+    static SoakNode_t nodes[SOAK_NODES_NUM];
+    for (uint8_t node = 0; node < SOAK_NODES_NUM; node++)
+    {
+        soak_node_load(&nodes[node], library);
+    }
+
+    memset(&counts, 0, sizeof(counts));
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint64_t game = 0; game < games; game++)
+    {
+        soak_play_game(nodes, &config, max_ticks, &counts);
+        // only the first game is recorded
+        config.trace = NULL;
+        config.inputs = NULL;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+    printf("latency %u ticks, loss %g, corruption %g, echo %g\n",
+           config.latency, config.loss, config.corruption, config.echo);
+    printf("%llu games in %.2f s, %.1f games per second\n",
+           (unsigned long long) games, seconds, games / seconds);
+    printf("completed %llu, mean %.0f ticks per game\n", (unsigned long long) counts.completed,
+           counts.completed ? (double) counts.ticks / counts.completed : 0.0);
+    printf("bytes sent %llu, lost %llu, corrupted %llu, echoed %llu\n",
+           (unsigned long long) counts.sent, (unsigned long long) counts.lost,
+           (unsigned long long) counts.corrupted, (unsigned long long) counts.echoed);
+    printf("hung %llu, crashed %llu, mismatched %llu\n", (unsigned long long) counts.hung,
+           (unsigned long long) counts.crashed, (unsigned long long) counts.mismatched);
+    for (uint8_t first = 0; first < SOAK_STATES_NUM; first++)
+    {
+        for (uint8_t second = 0; second < SOAK_STATES_NUM; second++)
+        {
+            if (counts.stuck[first][second])
+            {
+                printf("  %8llu  player 1 %-22s player 2 %s\n", (unsigned long long) counts.stuck[first][second],
+                       STATE_NAMES[first], STATE_NAMES[second]);
+            }
+        }
+    }
+
+    return (counts.hung || counts.crashed || counts.mismatched) ? 1 : 0;
+}
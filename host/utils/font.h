@@ -0,0 +1,23 @@
+/** 
+ * @file   font.h
+ * @brief  Host stand-in for the UCFK4 font definition.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef FONT_H
+#define FONT_H
+
+#include "system.h"
+
+/**
+ * @struct font_t
+ * @brief  Describes a font, glyphs are not drawn on the host.
+ */
+typedef struct
+{
+    uint8_t width;  /**< Width of a character in pixels. */
+    uint8_t height; /**< Height of a character in pixels. */
+} font_t;
+
+#endif /* FONT_H */
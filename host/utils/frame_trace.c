@@ -0,0 +1,136 @@
+/** 
+ * @file   frame_trace.c
+ * @brief  Records what the LED matrix shows on the host to a compact binary trace.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "frame_trace.h"
+#include "pacer.h"
+
+/** @brief The open trace, NULL when not recording. */
+static FILE* frame_trace_file = NULL;
+
+/** @brief Tick of the last record written. */
+static uint32_t frame_trace_tick = 0;
+
+/** @brief The high and low plane of the last frame recorded. */
+static uint8_t frame_trace_last[2][LEDMAT_COLS_NUM];
+
+/**
+ * @brief Writes the header of a record, its type and the ticks since the last record.
+ *
+ * @param type The type of the record.
+ */
+static void frame_trace_record(FrameTraceRecord_t type)
+{
+    uint32_t now = pacer_host_ticks();
+    uint32_t delta = now - frame_trace_tick;
+
+    frame_trace_tick = now;
+    fputc(type, frame_trace_file);
+    while (delta >= 0x80)
+    {
+        fputc((delta & 0x7F) | 0x80, frame_trace_file);
+        delta >>= 7;
+    }
+    fputc(delta, frame_trace_file);
+}
+
+/**
+ * @brief Starts recording to a trace, replacing the file.
+ *
+ * The matrix starts dark, so the first frame recorded is the first one lit.
+ *
+ * @param path The file to write.
+ * @return true if the file was opened.
+ */
+bool frame_trace_open(const char* path)
+{
+    frame_trace_close();
+    frame_trace_file = fopen(path, "wb");
+    if (frame_trace_file == NULL)
+    {
+        return false;
+    }
+
+    fwrite(FRAME_TRACE_MAGIC, 1, FRAME_TRACE_MAGIC_SIZE, frame_trace_file);
+    fputc(FRAME_TRACE_VERSION, frame_trace_file);
+    fputc(LEDMAT_COLS_NUM, frame_trace_file);
+    fputc(LEDMAT_ROWS_NUM, frame_trace_file);
+    frame_trace_tick = pacer_host_ticks();
+    memset(frame_trace_last, 0, sizeof(frame_trace_last));
+    return true;
+}
+
+/**
+ * @brief Stops recording, flushing and closing the trace.
+ */
+void frame_trace_close(void)
+{
+    if (frame_trace_file != NULL)
+    {
+        fclose(frame_trace_file);
+        frame_trace_file = NULL;
+    }
+}
+
+/**
+ * @brief Records a frame if it differs from the last one recorded.
+ *
+ * @param high The high plane of each column, bit n for row n.
+ * @param low The low plane of each column.
+ */
+void frame_trace_frame(const uint8_t high[LEDMAT_COLS_NUM], const uint8_t low[LEDMAT_COLS_NUM])
+{
+    if (frame_trace_file == NULL
+        || (memcmp(high, frame_trace_last[1], LEDMAT_COLS_NUM) == 0
+            && memcmp(low, frame_trace_last[0], LEDMAT_COLS_NUM) == 0))
+    {
+        return;
+    }
+    memcpy(frame_trace_last[1], high, LEDMAT_COLS_NUM);
+    memcpy(frame_trace_last[0], low, LEDMAT_COLS_NUM);
+    frame_trace_record(FRAME_TRACE_FRAME);
+    fwrite(high, 1, LEDMAT_COLS_NUM, frame_trace_file);
+    fwrite(low, 1, LEDMAT_COLS_NUM, frame_trace_file);
+}
+
+/**
+ * @brief Records text given to tinygl.
+ *
+ * @param text The text, empty when it is cleared. Text longer than
+ *             FRAME_TRACE_TEXT_MAX is cut short.
+ */
+void frame_trace_text(const char* text)
+{
+    if (frame_trace_file == NULL)
+    {
+        return;
+    }
+    size_t length = strlen(text);
+    if (length > FRAME_TRACE_TEXT_MAX)
+    {
+        length = FRAME_TRACE_TEXT_MAX;
+    }
+    frame_trace_record(FRAME_TRACE_TEXT);
+    fputc(length, frame_trace_file);
+    fwrite(text, 1, length, frame_trace_file);
+}
+
+/**
+ * @brief Records a button or navswitch push.
+ *
+ * @param input FRAME_TRACE_INPUT_BUTTON or'ed with the button, or the navswitch direction.
+ */
+void frame_trace_input(uint8_t input)
+{
+    if (frame_trace_file == NULL)
+    {
+        return;
+    }
+    frame_trace_record(FRAME_TRACE_INPUT);
+    fputc(input, frame_trace_file);
+}
@@ -0,0 +1,83 @@
+/** 
+ * @file   frame_trace.h
+ * @brief  Records what the LED matrix shows on the host to a compact binary trace.
+ *
+ * While a trace is open, the LED matrix stand-in records every frame which
+ * differs from the one before it, the tinygl stand-in records the text it is
+ * given to scroll, and the button and navswitch stand-ins record the pushes
+ * injected into them, each with the pacer tick it happened on.
+ *
+ * A trace starts with FRAME_TRACE_MAGIC, the version and the matrix size,
+ * one byte each. Each record that follows is its FrameTraceRecord_t type,
+ * the ticks since the record before it as a little endian base 128 number,
+ * then its payload:
+ *
+ * - FRAME_TRACE_FRAME: the high plane then the low plane, one byte per
+ *   column each, bit n for row n. An LED in only the low plane is dim, in
+ *   only the high plane medium and in both full, see host/drivers/ledmat.h.
+ * - FRAME_TRACE_TEXT: the length of the text then its characters, an empty
+ *   text when the text is cleared.
+ * - FRAME_TRACE_INPUT: FRAME_TRACE_INPUT_BUTTON or'ed with the button, or
+ *   the navswitch direction.
+ *
+ * host/frame_trace_dump turns a trace into ASCII, a PPM image or a report
+ * of the ticks from each input to the next change on the LED matrix.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef FRAME_TRACE_H
+#define FRAME_TRACE_H
+
+#include "system.h"
+
+#define FRAME_TRACE_MAGIC "LEDT"       // First bytes of every trace
+#define FRAME_TRACE_MAGIC_SIZE 4       // Bytes in the magic
+#define FRAME_TRACE_VERSION 2          // Version of the trace format
+#define FRAME_TRACE_INPUT_BUTTON 0x80  // Or'ed with the button in a button input record
+#define FRAME_TRACE_TEXT_MAX 255       // Longest text a record holds
+
+/**
+ * @enum  FrameTraceRecord_t
+ * @brief The types of record in a trace.
+ */
+typedef enum
+{
+    FRAME_TRACE_FRAME = 1, /**< A frame shown on the LED matrix. */
+    FRAME_TRACE_TEXT,      /**< Text given to tinygl to show. */
+    FRAME_TRACE_INPUT,     /**< A button or navswitch push. */
+} FrameTraceRecord_t;
+
+/**
+ * @brief  Starts recording to a trace, replacing the file.
+ * @param  path: The file to write.
+ * @return true if the file was opened.
+ */
+bool frame_trace_open(const char* path);
+
+/**
+ * @brief Stops recording, flushing and closing the trace.
+ */
+void frame_trace_close(void);
+
+/**
+ * @brief Records a frame if it differs from the last one recorded.
+ * @param high: The high plane of each column, bit n for row n.
+ * @param low: The low plane of each column.
+ */
+void frame_trace_frame(const uint8_t high[LEDMAT_COLS_NUM], const uint8_t low[LEDMAT_COLS_NUM]);
+
+/**
+ * @brief Records text given to tinygl.
+ * @param text: The text, empty when it is cleared.
+ */
+void frame_trace_text(const char* text);
+
+/**
+ * @brief Records a button or navswitch push.
+ * @param input: FRAME_TRACE_INPUT_BUTTON or'ed with the button, or the navswitch direction.
+ */
+void frame_trace_input(uint8_t input);
+
+#endif /* FRAME_TRACE_H */
@@ -0,0 +1,40 @@
+/** 
+ * @file   pacer.c
+ * @brief  Host stand-in for the UCFK4 pacer.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include "pacer.h"
+
+/** @brief Ticks counted since pacer_init(). */
+static uint32_t pacer_ticks = 0;
+
+/**
+ * @brief Initializes the pacer stand-in, resetting the tick count.
+ *
+ * @param pacer_rate The tick rate the game expects, in ticks per second.
+ */
+void pacer_init(uint16_t pacer_rate)
+{
+    (void) pacer_rate;
+    pacer_ticks = 0;
+}
+
+/**
+ * @brief Counts a tick without waiting.
+ */
+void pacer_wait(void)
+{
+    pacer_ticks++;
+}
+
+/**
+ * @brief Gets the number of ticks counted since pacer_init().
+ *
+ * @return The tick count.
+ */
+uint32_t pacer_host_ticks(void)
+{
+    return pacer_ticks;
+}
@@ -0,0 +1,34 @@
+/** 
+ * @file   pacer.h
+ * @brief  Host stand-in for the UCFK4 pacer.
+ *
+ * The host runs as fast as possible, so pacer_wait() does not wait and
+ * only counts ticks for the host program.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef PACER_H
+#define PACER_H
+
+#include "system.h"
+
+/**
+ * @brief Initializes the pacer stand-in, resetting the tick count.
+ * @param pacer_rate: The tick rate the game expects, in ticks per second.
+ */
+void pacer_init(uint16_t pacer_rate);
+
+/**
+ * @brief Counts a tick without waiting.
+ */
+void pacer_wait(void);
+
+/**
+ * @brief  Gets the number of ticks counted since pacer_init().
+ * @return The tick count.
+ */
+uint32_t pacer_host_ticks(void);
+
+#endif /* PACER_H */
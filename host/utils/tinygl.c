@@ -0,0 +1,176 @@
+/** 
+ * @file   tinygl.c
+ * @brief  Host stand-in for the UCFK4 tiny graphics library.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#include <string.h>
+#include "tinygl.h"
+#include "frame_trace.h"
+
+#define TINYGL_HOST_TEXT_SIZE 32 // Longest text kept, including the terminator
+
+/** @brief The display, one byte per row with bit n for column n. */
+static uint8_t tinygl_frame[TINYGL_HEIGHT];
+
+/** @brief The text last shown on the display. */
+static char tinygl_text_shown[TINYGL_HOST_TEXT_SIZE];
+
+/** @brief True while text given to tinygl_text() is recorded as shown in the frame trace. */
+static bool tinygl_text_traced = false;
+
+/** @brief The font set by tinygl_font_set(), used to step past drawn characters. */
+static font_t* tinygl_font = NULL;
+
+/** @brief Number of times tinygl_update() was called since tinygl_init(). */
+static uint32_t tinygl_updates = 0;
+
+/**
+ * @brief Initializes the stand-in, clearing the display and any text.
+ *
+ * @param update_rate The rate tinygl_update() will be called at, in updates per second.
+ */
+void tinygl_init(uint16_t update_rate)
+{
+    (void) update_rate;
+    tinygl_clear();
+    tinygl_updates = 0;
+}
+
+/**
+ * @brief Sets the font used for text, only its width is used on the host.
+ *
+ * @param font The font to use.
+ */
+void tinygl_font_set(font_t* font)
+{
+    tinygl_font = font;
+}
+
+/**
+ * @brief Sets the speed text scrolls at, ignored on the host.
+ *
+ * @param speed The speed in characters per 10 seconds.
+ */
+void tinygl_text_speed_set(uint8_t speed)
+{
+    (void) speed;
+}
+
+/**
+ * @brief Sets how text is shown, ignored on the host.
+ *
+ * @param mode The text mode to use.
+ */
+void tinygl_text_mode_set(tinygl_text_mode_t mode)
+{
+    (void) mode;
+}
+
+/**
+ * @brief Shows text on the display, recording it to the frame trace.
+ *
+ * @param string The text to show, it is copied.
+ */
+void tinygl_text(const char* string)
+{
+    frame_trace_text(string);
+    tinygl_text_traced = true;
+    strncpy(tinygl_text_shown, string, TINYGL_HOST_TEXT_SIZE - 1);
+    tinygl_text_shown[TINYGL_HOST_TEXT_SIZE - 1] = '\0';
+}
+
+/**
+ * @brief Draws a character on the display, the host has no glyphs so it is kept as the text shown.
+ *
+ * @param ch The character to draw.
+ * @param pos The position of the character's top left pixel.
+ * @return The position just after the character.
+ */
+tinygl_point_t tinygl_draw_char(char ch, tinygl_point_t pos)
+{
+    tinygl_text_shown[0] = ch;
+    tinygl_text_shown[1] = '\0';
+    return tinygl_point(pos.x + (tinygl_font ? tinygl_font->width + 1 : 0), pos.y);
+}
+
+/**
+ * @brief Sets a pixel on the display, pixels off the display are ignored.
+ *
+ * @param point The position of the pixel.
+ * @param pixel_value The value of the pixel.
+ */
+void tinygl_pixel_set(tinygl_point_t point, tinygl_pixel_value_t pixel_value)
+{
+    if (point.x < 0 || point.x >= TINYGL_WIDTH || point.y < 0 || point.y >= TINYGL_HEIGHT)
+    {
+        return;
+    }
+    if (pixel_value)
+    {
+        tinygl_frame[point.y] |= BIT(point.x);
+    }
+    else
+    {
+        tinygl_frame[point.y] &= ~BIT(point.x);
+    }
+}
+
+/**
+ * @brief Gets a pixel on the display.
+ *
+ * @param point The position of the pixel.
+ * @return The value of the pixel, 0 for pixels off the display.
+ */
+tinygl_pixel_value_t tinygl_pixel_get(tinygl_point_t point)
+{
+    if (point.x < 0 || point.x >= TINYGL_WIDTH || point.y < 0 || point.y >= TINYGL_HEIGHT)
+    {
+        return 0;
+    }
+    return (tinygl_frame[point.y] >> point.x) & 1;
+}
+
+/**
+ * @brief Clears the display and any text, recording cleared text to the frame trace.
+ */
+void tinygl_clear(void)
+{
+    // drawn characters reach the trace as frames, so only text is cleared there
+    if (tinygl_text_traced)
+    {
+        frame_trace_text("");
+        tinygl_text_traced = false;
+    }
+    memset(tinygl_frame, 0, sizeof(tinygl_frame));
+    tinygl_text_shown[0] = '\0';
+}
+
+/**
+ * @brief Refreshes the display, counting the update.
+ */
+void tinygl_update(void)
+{
+    tinygl_updates++;
+}
+
+/**
+ * @brief Gets the text last shown on the display.
+ *
+ * @return The text, empty when the display was cleared since.
+ */
+const char* tinygl_host_text(void)
+{
+    return tinygl_text_shown;
+}
+
+/**
+ * @brief Gets the number of times tinygl_update() was called since tinygl_init().
+ *
+ * @return The update count.
+ */
+uint32_t tinygl_host_updates(void)
+{
+    return tinygl_updates;
+}
@@ -0,0 +1,132 @@
+/** 
+ * @file   tinygl.h
+ * @brief  Host stand-in for the UCFK4 tiny graphics library.
+ *
+ * Pixels are kept in a frame buffer the host program can read back with
+ * tinygl_pixel_get(). Text is not drawn, the last text given to tinygl_text()
+ * or character given to tinygl_draw_char() can be read back with
+ * tinygl_host_text() instead.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef TINYGL_H
+#define TINYGL_H
+
+#include "system.h"
+#include "font.h"
+
+#define TINYGL_WIDTH LEDMAT_COLS_NUM  // Width of the display in pixels
+#define TINYGL_HEIGHT LEDMAT_ROWS_NUM // Height of the display in pixels
+
+typedef int8_t tinygl_coord_t;
+typedef uint8_t tinygl_pixel_value_t;
+
+/**
+ * @struct tinygl_point_t
+ * @brief  A position on the display.
+ */
+typedef struct
+{
+    tinygl_coord_t x; /**< The column. */
+    tinygl_coord_t y; /**< The row. */
+} tinygl_point_t;
+
+/**
+ * @brief  Makes a position on the display.
+ * @param  x: The column.
+ * @param  y: The row.
+ * @return The position.
+ */
+static inline tinygl_point_t tinygl_point(tinygl_coord_t x, tinygl_coord_t y)
+{
+    tinygl_point_t point = {x, y};
+    return point;
+}
+
+/**
+ * @enum  tinygl_text_mode_t
+ * @brief The ways text can be shown on the display.
+ */
+typedef enum
+{
+    TINYGL_TEXT_MODE_STEP,   /**< Show one character at a time. */
+    TINYGL_TEXT_MODE_SCROLL, /**< Scroll the text across the display. */
+} tinygl_text_mode_t;
+
+/**
+ * @brief Initializes the stand-in, clearing the display and any text.
+ * @param update_rate: The rate tinygl_update() will be called at, in updates per second.
+ */
+void tinygl_init(uint16_t update_rate);
+
+/**
+ * @brief Sets the font used for text.
+ * @param font: The font to use.
+ */
+void tinygl_font_set(font_t* font);
+
+/**
+ * @brief Sets the speed text scrolls at.
+ * @param speed: The speed in characters per 10 seconds.
+ */
+void tinygl_text_speed_set(uint8_t speed);
+
+/**
+ * @brief Sets how text is shown.
+ * @param mode: The text mode to use.
+ */
+void tinygl_text_mode_set(tinygl_text_mode_t mode);
+
+/**
+ * @brief Shows text on the display.
+ * @param string: The text to show, it is copied.
+ */
+void tinygl_text(const char* string);
+
+/**
+ * @brief  Draws a character on the display.
+ * @param  ch: The character to draw.
+ * @param  pos: The position of the character's top left pixel.
+ * @return The position just after the character.
+ */
+tinygl_point_t tinygl_draw_char(char ch, tinygl_point_t pos);
+
+/**
+ * @brief Sets a pixel on the display.
+ * @param point: The position of the pixel.
+ * @param pixel_value: The value of the pixel.
+ */
+void tinygl_pixel_set(tinygl_point_t point, tinygl_pixel_value_t pixel_value);
+
+/**
+ * @brief  Gets a pixel on the display.
+ * @param  point: The position of the pixel.
+ * @return The value of the pixel.
+ */
+tinygl_pixel_value_t tinygl_pixel_get(tinygl_point_t point);
+
+/**
+ * @brief Clears the display and any text.
+ */
+void tinygl_clear(void);
+
+/**
+ * @brief Refreshes the display, counting the update.
+ */
+void tinygl_update(void);
+
+/**
+ * @brief  Gets the text last shown on the display.
+ * @return The text, empty when the display was cleared since.
+ */
+const char* tinygl_host_text(void);
+
+/**
+ * @brief  Gets the number of times tinygl_update() was called since tinygl_init().
+ * @return The update count.
+ */
+uint32_t tinygl_host_updates(void);
+
+#endif /* TINYGL_H */
@@ -0,0 +1,546 @@
+/**
+ * @file   input_trace.c
+ * @brief  Implementation of the input trace recording and replay for the Battleship game.
+ *
+ * Records are packed into a small FIFO as the game reads its inputs, and
+ * input_trace_update() writes one byte of them to EEPROM each tick the
+ * EEPROM is ready, so recording never waits for a write to finish. The
+ * length in the header is only brought up to date while the FIFO is empty,
+ * so it always ends on a whole record and a board switched off part way
+ * through a game leaves a trace of the game so far. Once a record is dropped
+ * the bytes still waiting are dropped too and the header is marked with
+ * INPUT_TRACE_TRUNCATED, as the rest of the game could not be replayed.
+ *
+ * Replay decodes one record ahead, and hands it to the first read of its
+ * kind on its tick. A record the game does not read on its tick means the
+ * replay has diverged from the recording, it is skipped and counted.
+ *
+ * Host builds write to the EEPROM stand-in in host/avr, which host programs
+ * save to and load from files.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#ifdef INPUT_TRACE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <avr/eeprom.h>
+#include "input_trace.h"
+#include "scheduler.h"
+
+/**
+ * @brief Bytes of EEPROM the trace can fill.
+ */
+#define INPUT_TRACE_EEPROM_SIZE (E2END + 1)
+
+/**
+ * @brief Mask wrapping an index into the FIFO.
+ */
+#define INPUT_TRACE_FIFO_MASK (INPUT_TRACE_FIFO_SIZE - 1)
+
+/**
+ * @brief Longest record, the record byte, 5 bytes of ticks and a timer count.
+ */
+#define INPUT_TRACE_RECORD_MAX 8
+
+/** @brief What the trace does with the inputs the game reads. */
+static InputTraceMode_t trace_mode = INPUT_TRACE;
+
+/** @brief Tick of the last record recorded or replayed. */
+static uint32_t trace_tick;
+
+/** @brief Records waiting to be written to EEPROM. */
+static uint8_t trace_fifo[INPUT_TRACE_FIFO_SIZE];
+
+/** @brief Index the next record byte is added at. */
+static uint8_t trace_fifo_head;
+
+/** @brief Index the next byte is written to EEPROM from. */
+static uint8_t trace_fifo_tail;
+
+/** @brief Bytes of records recorded, written or waiting. */
+static uint16_t trace_length;
+
+/** @brief Bytes of records written to EEPROM. */
+static uint16_t trace_written;
+
+/** @brief Flag indicating the header in EEPROM may not match the records written. */
+static bool trace_header_dirty;
+
+/** @brief Flag indicating records were dropped and recording stopped. */
+static bool trace_truncated;
+
+/** @brief EEPROM address of the next byte to replay. */
+static uint16_t trace_read;
+
+/** @brief EEPROM address just after the last record to replay. */
+static uint16_t trace_end;
+
+/** @brief Flag indicating the next record has been decoded and waits to be replayed. */
+static bool next_valid;
+
+/** @brief Tick of the next record to replay. */
+static uint32_t next_tick;
+
+/** @brief Kind of the next record to replay. */
+static InputTraceKind_t next_kind;
+
+/** @brief Payload of the next record to replay. */
+static uint16_t next_payload;
+
+/** @brief Number of records skipped because the game did not read them on their tick. */
+static uint16_t trace_skipped;
+
+/**
+ * @brief Reads a byte of EEPROM.
+ *
+ * @param address The EEPROM address.
+ * @return The byte.
+ */
+static uint8_t input_trace_eeprom_read(uint16_t address)
+{
+    return eeprom_read_byte((const uint8_t*) (uintptr_t) address);
+}
+
+/**
+ * @brief Reads the length of the records of the trace saved in EEPROM.
+ *
+ * A trace recorded into a larger EEPROM, such as the host's, is cut short
+ * to the records which fit in this one.
+ *
+ * @param truncated Set to true if the recording was cut short.
+ * @return The bytes of records, 0 when no trace has been saved.
+ */
+static uint16_t input_trace_read_length(bool* truncated)
+{
+    const uint16_t length_max = INPUT_TRACE_EEPROM_SIZE - INPUT_TRACE_HEADER_SIZE;
+    uint16_t magic = input_trace_eeprom_read(0) | (uint16_t) input_trace_eeprom_read(1) << 8;
+    uint16_t length = input_trace_eeprom_read(2) | (uint16_t) input_trace_eeprom_read(3) << 8;
+
+    *truncated = false;
+    if (magic != INPUT_TRACE_MAGIC)
+    {
+        return 0;
+    }
+    *truncated = (length & INPUT_TRACE_TRUNCATED) != 0;
+    length &= ~INPUT_TRACE_TRUNCATED;
+    return length < length_max ? length : length_max;
+}
+
+/**
+ * @brief Adds a record for an input read this tick to the FIFO.
+ *
+ * Once a record does not fit recording stops, later records would replay
+ * against a game which never saw the dropped one. The bytes still waiting
+ * are dropped and the header is marked as cut short, so replay refuses it.
+ *
+ * @param kind The kind of record.
+ * @param payload The received byte or timer count, ignored by other kinds.
+ */
+static void input_trace_append(InputTraceKind_t kind, uint16_t payload)
+{
+    uint8_t record[INPUT_TRACE_RECORD_MAX];
+    uint8_t size = 0;
+    uint32_t now = scheduler_ticks();
+    uint32_t ticks = now - trace_tick;
+
+    if (trace_truncated)
+    {
+        return;
+    }
+
+    record[size++] = (kind << 5) | (ticks < INPUT_TRACE_TICKS_LONG ? ticks : INPUT_TRACE_TICKS_LONG);
+    if (ticks >= INPUT_TRACE_TICKS_LONG)
+    {
+        ticks -= INPUT_TRACE_TICKS_LONG;
+        while (ticks >= 0x80)
+        {
+            record[size++] = (ticks & 0x7F) | 0x80;
+            ticks >>= 7;
+        }
+        record[size++] = ticks;
+    }
+    if (kind == INPUT_TRACE_IR || kind == INPUT_TRACE_TIMER)
+    {
+        record[size++] = payload & 0xFF;
+    }
+    if (kind == INPUT_TRACE_TIMER)
+    {
+        record[size++] = payload >> 8;
+    }
+
+    uint8_t waiting = (trace_fifo_head - trace_fifo_tail) & INPUT_TRACE_FIFO_MASK;
+    if (waiting + size >= INPUT_TRACE_FIFO_SIZE
+        || INPUT_TRACE_HEADER_SIZE + trace_length + size > INPUT_TRACE_EEPROM_SIZE)
+    {
+        trace_truncated = true;
+        trace_fifo_tail = trace_fifo_head;
+        trace_length = trace_written;
+        trace_header_dirty = true;
+        return;
+    }
+    for (uint8_t i = 0; i < size; i++)
+    {
+        trace_fifo[trace_fifo_head] = record[i];
+        trace_fifo_head = (trace_fifo_head + 1) & INPUT_TRACE_FIFO_MASK;
+    }
+    trace_length += size;
+    trace_tick = now;
+    trace_header_dirty = true;
+}
+
+/**
+ * @brief Decodes the next record to replay, if there is one left.
+ */
+static void input_trace_next(void)
+{
+    next_valid = false;
+    if (trace_read >= trace_end)
+    {
+        return;
+    }
+
+    uint8_t byte = input_trace_eeprom_read(trace_read++);
+    uint32_t ticks = byte & 0x1F;
+    next_kind = byte >> 5;
+    if (ticks >= INPUT_TRACE_TICKS_LONG)
+    {
+        for (uint8_t shift = 0; trace_read < trace_end && shift < 32; shift += 7)
+        {
+            byte = input_trace_eeprom_read(trace_read++);
+            ticks += (uint32_t) (byte & 0x7F) << shift;
+            if (!(byte & 0x80))
+            {
+                break;
+            }
+        }
+    }
+    next_payload = 0;
+    if (next_kind == INPUT_TRACE_IR || next_kind == INPUT_TRACE_TIMER)
+    {
+        next_payload = input_trace_eeprom_read(trace_read++);
+    }
+    if (next_kind == INPUT_TRACE_TIMER)
+    {
+        next_payload |= (uint16_t) input_trace_eeprom_read(trace_read++) << 8;
+    }
+    if (trace_read > trace_end)
+    {
+        return;
+    }
+
+    trace_tick += ticks;
+    next_tick = trace_tick;
+    next_valid = true;
+}
+
+/**
+ * @brief Takes the next record to replay if it is one of the given kinds and due this tick.
+ *
+ * Records left behind by earlier ticks are skipped first.
+ *
+ * @param first The first kind taken.
+ * @param last The last kind taken.
+ * @param kind The kind of the record taken.
+ * @param payload The payload of the record taken.
+ * @return true if a record was taken.
+ */
+static bool input_trace_take(InputTraceKind_t first, InputTraceKind_t last, InputTraceKind_t* kind, uint16_t* payload)
+{
+    uint32_t now = scheduler_ticks();
+
+    while (next_valid && next_tick < now)
+    {
+        if (trace_skipped != UINT16_MAX)
+        {
+            trace_skipped++;
+        }
+        input_trace_next();
+    }
+    if (!next_valid || next_tick != now || next_kind < first || next_kind > last)
+    {
+        return false;
+    }
+    *kind = next_kind;
+    *payload = next_payload;
+    input_trace_next();
+    return true;
+}
+
+/**
+ * @brief Starts the trace from the first tick, called by game_init().
+ *
+ * Recording starts a new trace, replay starts from the first record of the
+ * trace in EEPROM and turns replay off if there is no trace there or it
+ * was cut short.
+ */
+void input_trace_init(void)
+{
+    trace_tick = 0;
+    trace_fifo_head = 0;
+    trace_fifo_tail = 0;
+    trace_length = 0;
+    trace_written = 0;
+    trace_header_dirty = trace_mode == INPUT_TRACE_RECORD;
+    trace_truncated = false;
+    trace_skipped = 0;
+    next_valid = false;
+
+    if (trace_mode == INPUT_TRACE_REPLAY)
+    {
+        bool truncated;
+        uint16_t length = input_trace_read_length(&truncated);
+        if (length == 0 || truncated)
+        {
+            trace_mode = INPUT_TRACE_OFF;
+            return;
+        }
+        trace_read = INPUT_TRACE_HEADER_SIZE;
+        trace_end = INPUT_TRACE_HEADER_SIZE + length;
+        input_trace_next();
+    }
+}
+
+/**
+ * @brief Sets what the trace does from the next input_trace_init().
+ *
+ * @param mode The new mode.
+ */
+void input_trace_set_mode(InputTraceMode_t mode)
+{
+    trace_mode = mode;
+}
+
+/**
+ * @brief Gets what the trace is doing.
+ *
+ * @return The current mode.
+ */
+InputTraceMode_t input_trace_get_mode(void)
+{
+    return trace_mode;
+}
+
+/**
+ * @brief Writes the first byte of the header in EEPROM which differs from the trace recorded.
+ *
+ * @return true if a byte was written, false if the header is up to date.
+ */
+static bool input_trace_write_header(void)
+{
+    uint16_t length = trace_written | (trace_truncated ? INPUT_TRACE_TRUNCATED : 0);
+    const uint8_t header[INPUT_TRACE_HEADER_SIZE] = {
+        INPUT_TRACE_MAGIC & 0xFF, INPUT_TRACE_MAGIC >> 8, length & 0xFF, length >> 8,
+    };
+
+    for (uint8_t i = 0; i < INPUT_TRACE_HEADER_SIZE; i++)
+    {
+        if (input_trace_eeprom_read(i) != header[i])
+        {
+            eeprom_write_byte((uint8_t*) (uintptr_t) i, header[i]);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Writes the waiting bytes of the trace to EEPROM, run every tick by the scheduler.
+ *
+ * The header is written first, marking the trace as empty before any
+ * record of the old trace is overwritten, then again whenever the FIFO
+ * empties. A write leaves the EEPROM busy for 3.4 ms, so the UCFK4 writes
+ * one byte a tick, the host stand-in is always ready and writes them all.
+ */
+void input_trace_update(void)
+{
+    if (trace_mode != INPUT_TRACE_RECORD)
+    {
+        return;
+    }
+
+    while (eeprom_is_ready())
+    {
+        bool fifo_empty = trace_fifo_head == trace_fifo_tail;
+        if (trace_header_dirty && (fifo_empty || trace_written == 0))
+        {
+            if (input_trace_write_header())
+            {
+                continue;
+            }
+            trace_header_dirty = false;
+        }
+        if (fifo_empty)
+        {
+            return;
+        }
+        eeprom_write_byte((uint8_t*) (uintptr_t) (INPUT_TRACE_HEADER_SIZE + trace_written), trace_fifo[trace_fifo_tail]);
+        trace_fifo_tail = (trace_fifo_tail + 1) & INPUT_TRACE_FIFO_MASK;
+        trace_written++;
+        trace_header_dirty = true;
+    }
+}
+
+/**
+ * @brief Gets the size of the trace saved in EEPROM, including the header.
+ *
+ * @return The bytes saved, 0 when no trace has been saved.
+ */
+uint16_t input_trace_saved_size(void)
+{
+    bool truncated;
+    uint16_t length = input_trace_read_length(&truncated);
+    return (length || truncated) ? INPUT_TRACE_HEADER_SIZE + length : 0;
+}
+
+/**
+ * @brief Checks if the trace has been fully written to EEPROM.
+ *
+ * @return true if no record is waiting to be written.
+ */
+bool input_trace_saved(void)
+{
+    return trace_fifo_head == trace_fifo_tail && !trace_header_dirty;
+}
+
+/**
+ * @brief Checks if the recording was cut short because the EEPROM or the waiting bytes filled up.
+ *
+ * @return true if records were dropped.
+ */
+bool input_trace_truncated(void)
+{
+    return trace_truncated;
+}
+
+/**
+ * @brief Gets the number of records replay skipped because the game did not read them on their tick.
+ *
+ * @return The number of records skipped, non zero when the replay diverged from the recording.
+ */
+uint16_t input_trace_skipped(void)
+{
+    return trace_skipped;
+}
+
+/**
+ * @brief Checks if replay has used every record in the trace.
+ *
+ * @return true once every record has been replayed or skipped.
+ */
+bool input_trace_replayed(void)
+{
+    return !next_valid;
+}
+
+/**
+ * @brief Passes the navigation switch direction read this tick through the trace.
+ *
+ * @param direction The direction read from the navigation switch.
+ * @return The direction the game acts on.
+ */
+Direction_t input_trace_navswitch(Direction_t direction)
+{
+    InputTraceKind_t kind;
+    uint16_t payload;
+
+    if (direction != DIR_NONE)
+    {
+        commit_stir((uint16_t) direction << 8);
+    }
+    if (trace_mode == INPUT_TRACE_REPLAY)
+    {
+        return input_trace_take(INPUT_TRACE_NORTH, INPUT_TRACE_PUSHED, &kind, &payload) ? (Direction_t) kind : DIR_NONE;
+    }
+    if (trace_mode == INPUT_TRACE_RECORD && direction != DIR_NONE)
+    {
+        input_trace_append((InputTraceKind_t) direction, 0);
+    }
+    return direction;
+}
+
+/**
+ * @brief Passes a check of the button for a push through the trace.
+ *
+ * @param pushed true if the button was pushed.
+ * @return true if the game acts on a push.
+ */
+bool input_trace_button(bool pushed)
+{
+    InputTraceKind_t kind;
+    uint16_t payload;
+
+    if (pushed)
+    {
+        commit_stir((uint16_t) INPUT_TRACE_BUTTON << 8);
+    }
+    if (trace_mode == INPUT_TRACE_REPLAY)
+    {
+        return input_trace_take(INPUT_TRACE_BUTTON, INPUT_TRACE_BUTTON, &kind, &payload);
+    }
+    if (trace_mode == INPUT_TRACE_RECORD && pushed)
+    {
+        input_trace_append(INPUT_TRACE_BUTTON, 0);
+    }
+    return pushed;
+}
+
+/**
+ * @brief Passes an attempt to take a byte received over IR through the trace.
+ *
+ * When replaying, bytes received from the hardware are dropped.
+ *
+ * @param data The byte taken, replaced when replaying.
+ * @param received true if a byte was taken.
+ * @return true if the game acts on a byte in data.
+ */
+bool input_trace_ir(uint8_t* data, bool received)
+{
+    InputTraceKind_t kind;
+    uint16_t payload;
+
+    if (received)
+    {
+        commit_stir(((uint16_t) INPUT_TRACE_IR << 8) | *data);
+    }
+    if (trace_mode == INPUT_TRACE_REPLAY)
+    {
+        if (!input_trace_take(INPUT_TRACE_IR, INPUT_TRACE_IR, &kind, &payload))
+        {
+            return false;
+        }
+        *data = payload;
+        return true;
+    }
+    if (trace_mode == INPUT_TRACE_RECORD && received)
+    {
+        input_trace_append(INPUT_TRACE_IR, *data);
+    }
+    return received;
+}
+
+/**
+ * @brief Passes a read of the timer through the trace.
+ *
+ * @param now The count read from the timer.
+ * @return The count the game acts on.
+ */
+uint16_t input_trace_timer(uint16_t now)
+{
+    InputTraceKind_t kind;
+    uint16_t payload;
+
+    if (trace_mode == INPUT_TRACE_REPLAY)
+    {
+        return input_trace_take(INPUT_TRACE_TIMER, INPUT_TRACE_TIMER, &kind, &payload) ? payload : now;
+    }
+    if (trace_mode == INPUT_TRACE_RECORD)
+    {
+        input_trace_append(INPUT_TRACE_TIMER, now);
+    }
+    return now;
+}
+
+#endif /* INPUT_TRACE */
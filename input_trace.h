@@ -0,0 +1,216 @@
+/**
+ * @file   input_trace.h
+ * @brief  Header of the input trace recording and replay for the Battleship game.
+ *
+ * Every input the game reads passes through this module: the direction from
+ * navigation_switch_get(), button pushes, bytes received over IR and the
+ * timer reads the IR link seeds its random numbers from. When recording,
+ * each input is written to EEPROM with the tick it was read on. When
+ * replaying, the inputs read from the hardware are replaced by the recorded
+ * ones, so a board plays the recorded game again tick for tick.
+ *
+ * A trace starts with INPUT_TRACE_MAGIC and the number of bytes of records
+ * which follow, both little endian 16 bit numbers, the length with
+ * INPUT_TRACE_TRUNCATED set if records were dropped. Each record is one byte,
+ * its InputTraceKind_t in the top 3 bits and the ticks since the record
+ * before it in the bottom 5, followed by its payload:
+ *
+ * - INPUT_TRACE_IR: the received byte.
+ * - INPUT_TRACE_TIMER: the timer count, little endian.
+ * - Every other kind has no payload.
+ *
+ * Ticks of INPUT_TRACE_TICKS_LONG or more store INPUT_TRACE_TICKS_LONG in
+ * the record, then the remaining ticks 7 bits at a time, least significant
+ * first, with the top bit set on every byte but the last.
+ *
+ * Recording and replay are built in with INPUT_TRACE defined to the
+ * InputTraceMode_t to start in (make INPUT_TRACE=record or replay), every
+ * other build passes inputs straight through. Host builds start with
+ * recording off and are switched with input_trace_set_mode().
+ *
+ * Whatever the mode, every push and every byte received from the hardware
+ * is stirred into the pool board salts are drawn from, see commit_stir().
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef INPUT_TRACE_H
+#define INPUT_TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "navigation_switch.h"
+#include "commit.h"
+
+/**
+ * @brief First two bytes of a trace, "IT" read as a little endian number.
+ */
+#define INPUT_TRACE_MAGIC 0x5449
+
+/**
+ * @brief Bytes before the first record, the magic and the length.
+ */
+#define INPUT_TRACE_HEADER_SIZE 4
+
+/**
+ * @brief Bit of the length in the header marking a trace which was cut short, replay refuses it.
+ */
+#define INPUT_TRACE_TRUNCATED 0x8000
+
+/**
+ * @brief Ticks from which a record stores its ticks after the record byte.
+ */
+#define INPUT_TRACE_TICKS_LONG 30
+
+/**
+ * @brief Bytes of records waiting to be written to EEPROM.
+ *
+ * An EEPROM write takes 3.4 ms, almost two ticks, so bytes received over IR
+ * arrive faster than they are written and wait here until the frame ends.
+ */
+#define INPUT_TRACE_FIFO_SIZE 64
+
+/**
+ * @enum  InputTraceMode_t
+ * @brief What the trace does with the inputs the game reads.
+ */
+typedef enum
+{
+    INPUT_TRACE_OFF,    /**< Inputs pass straight through. */
+    INPUT_TRACE_RECORD, /**< Inputs pass through and are written to the trace. */
+    INPUT_TRACE_REPLAY, /**< Inputs are replaced by those in the trace. */
+} InputTraceMode_t;
+
+/**
+ * @enum  InputTraceKind_t
+ * @brief The kinds of record in a trace, the navigation switch directions match Direction_t.
+ */
+typedef enum
+{
+    INPUT_TRACE_IR,                     /**< A byte received over IR. */
+    INPUT_TRACE_NORTH = DIR_NORTH,      /**< The navigation switch pushed north. */
+    INPUT_TRACE_EAST = DIR_EAST,        /**< The navigation switch pushed east. */
+    INPUT_TRACE_SOUTH = DIR_SOUTH,      /**< The navigation switch pushed south. */
+    INPUT_TRACE_WEST = DIR_WEST,        /**< The navigation switch pushed west. */
+    INPUT_TRACE_PUSHED = DIR_PUSHED,    /**< The navigation switch pushed down. */
+    INPUT_TRACE_BUTTON,                 /**< The button pushed. */
+    INPUT_TRACE_TIMER,                  /**< A read of the timer. */
+} InputTraceKind_t;
+
+#ifdef INPUT_TRACE
+/**
+ * @brief Starts the trace from the first tick, called by game_init().
+ *
+ * Recording starts a new trace, replay starts from the first record of the
+ * trace in EEPROM and turns replay off if there is no trace there or it
+ * was cut short.
+ */
+void input_trace_init(void);
+
+/**
+ * @brief Sets what the trace does from the next input_trace_init().
+ * @param mode The new mode.
+ */
+void input_trace_set_mode(InputTraceMode_t mode);
+
+/**
+ * @brief Gets what the trace is doing.
+ * @return The current mode.
+ */
+InputTraceMode_t input_trace_get_mode(void);
+
+/**
+ * @brief Writes the waiting bytes of the trace to EEPROM, run every tick by the scheduler.
+ */
+void input_trace_update(void);
+
+/**
+ * @brief Gets the size of the trace saved in EEPROM, including the header.
+ * @return The bytes saved, 0 when no trace has been saved.
+ */
+uint16_t input_trace_saved_size(void);
+
+/**
+ * @brief Checks if the trace has been fully written to EEPROM.
+ * @return true if no record is waiting to be written.
+ */
+bool input_trace_saved(void);
+
+/**
+ * @brief Checks if the recording was cut short because the EEPROM or the waiting bytes filled up.
+ * @return true if records were dropped.
+ */
+bool input_trace_truncated(void);
+
+/**
+ * @brief Gets the number of records replay skipped because the game did not read them on their tick.
+ * @return The number of records skipped, non zero when the replay diverged from the recording.
+ */
+uint16_t input_trace_skipped(void);
+
+/**
+ * @brief Checks if replay has used every record in the trace.
+ * @return true once every record has been replayed or skipped.
+ */
+bool input_trace_replayed(void);
+
+/**
+ * @brief Passes the navigation switch direction read this tick through the trace.
+ * @param direction The direction read from the navigation switch.
+ * @return The direction the game acts on.
+ */
+Direction_t input_trace_navswitch(Direction_t direction);
+
+/**
+ * @brief Passes a check of the button for a push through the trace.
+ * @param pushed true if the button was pushed.
+ * @return true if the game acts on a push.
+ */
+bool input_trace_button(bool pushed);
+
+/**
+ * @brief Passes an attempt to take a byte received over IR through the trace.
+ * @param data The byte taken, replaced when replaying.
+ * @param received true if a byte was taken.
+ * @return true if the game acts on a byte in data.
+ */
+bool input_trace_ir(uint8_t* data, bool received);
+
+/**
+ * @brief Passes a read of the timer through the trace.
+ * @param now The count read from the timer.
+ * @return The count the game acts on.
+ */
+uint16_t input_trace_timer(uint16_t now);
+#else
+static inline void input_trace_init(void) {}
+static inline void input_trace_update(void) {}
+static inline Direction_t input_trace_navswitch(Direction_t direction)
+{
+    if (direction != DIR_NONE)
+    {
+        commit_stir((uint16_t) direction << 8);
+    }
+    return direction;
+}
+static inline bool input_trace_button(bool pushed)
+{
+    if (pushed)
+    {
+        commit_stir((uint16_t) INPUT_TRACE_BUTTON << 8);
+    }
+    return pushed;
+}
+static inline bool input_trace_ir(uint8_t* data, bool received)
+{
+    if (received)
+    {
+        commit_stir(((uint16_t) INPUT_TRACE_IR << 8) | *data);
+    }
+    return received;
+}
+static inline uint16_t input_trace_timer(uint16_t now) { return now; }
+#endif /* INPUT_TRACE */
+
+#endif /* INPUT_TRACE_H */
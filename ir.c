@@ -1,88 +1,1041 @@
-/** 
+/**
  * @file   ir.c
  * @brief  Implementation of IR communication functions for the Battleship game.
  *
  * This file contains the implementation of functions for handling IR communication
- * in the Battleship game. It includes functions for sending and receiving predefined
- * board IDs and turn states via IR communication, using specific prefixes to identify
- * the type of data being transmitted.
+ * in the Battleship game. It includes functions for sending and receiving board
+ * commitments, shots and their answers, then the salts, predefined board IDs,
+ * seeds of random boards and codes of edited boards which reveal the boards.
+ *
+ * Each message is sent as a frame protected by a CRC-16 and carrying a sequence
+ * number. The receiver acknowledges every valid frame and drops frames it has
+ * already seen, while the sender keeps sending a frame until it is acknowledged,
+ * so a lost or corrupted byte costs one retry rather than hanging both boards.
+ * Frames are sent one at a time in the order they were queued.
+ *
+ * The IR receiver also sees our own transmitter, so every frame carries the
+ * sender's session nonce and the receiver drops frames carrying its own. The
+ * opponent's reply can then be read as soon as it arrives.
  *
  * @date   17/10/2024
  * @author Corey Hines
  */
 
 #include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
 #include "ir_uart.h"
+#include "timer.h"
 #include "ir.h"
+#include "ir_rx.h"
+#include "predefined_boards.h"
+#include "random_board.h"
+#include "fleet_layout.h"
+#include "commit.h"
+#include "input_trace.h"
+
+/**
+ * @brief Builds a frame header from a frame type and sequence number.
+ */
+#define IR_FRAME_HEADER(type, seq) ((uint8_t) (((type) << 4) | ((seq) & 0x0F)))
+
+/**
+ * @brief Extracts the frame type from a frame header.
+ */
+#define IR_FRAME_GET_TYPE(header) ((header) >> 4)
+
+/**
+ * @brief Extracts the sequence number from a frame header.
+ */
+#define IR_FRAME_GET_SEQ(header) ((header) & 0x0F)
+
+/**
+ * @brief Sequence number which no frame carries, used before any frame is received.
+ */
+#define IR_SEQ_NONE 0xFF
+
+/**
+ * @brief Session nonce which no board uses, marking that ours has not been chosen yet.
+ */
+#define IR_NONCE_NONE 0
+
+/**
+ * @brief Payload length of a frame type which does not exist.
+ */
+#define IR_FRAME_TYPE_INVALID 0xFF
+
+/**
+ * @struct IrFrame_t
+ * @brief  A frame waiting to be sent or acknowledged.
+ */
+typedef struct
+{
+    uint8_t header;                        /**< Frame type and sequence number. */
+    uint8_t length;                        /**< Number of payload bytes. */
+    uint8_t payload[IR_FRAME_PAYLOAD_MAX]; /**< The payload. */
+} IrFrame_t;
+
+/**
+ * @struct IrMessageHandler_t
+ * @brief  How the frames of one type are checked and delivered.
+ */
+typedef struct
+{
+    uint8_t length;                          /**< Payload length every frame of the type carries. */
+    bool (*valid)(const uint8_t* payload);   /**< Checks the payload, NULL if every payload is valid. */
+    void (*deliver)(const uint8_t* payload); /**< Delivers the payload, NULL for frames handled by the link. */
+} IrMessageHandler_t;
+
+/**
+ * @enum  IrRxState_t
+ * @brief The part of a frame the receiver expects next.
+ */
+typedef enum {
+    IR_RX_SYNC,     /**< Waiting for the sync byte which starts a frame. */
+    IR_RX_NONCE,    /**< Waiting for the sender's session nonce. */
+    IR_RX_HEADER,   /**< Waiting for the frame header. */
+    IR_RX_LENGTH,   /**< Waiting for the payload length. */
+    IR_RX_PAYLOAD,  /**< Receiving the payload. */
+    IR_RX_CRC_HIGH, /**< Waiting for the high byte of the CRC. */
+    IR_RX_CRC_LOW,  /**< Waiting for the low byte of the CRC. */
+} IrRxState_t;
+
+/** @brief Frames waiting to be acknowledged, the oldest is the one being sent. */
+static IrFrame_t tx_queue[IR_TX_QUEUE_SIZE];
+
+/** @brief Index of the oldest frame in the queue. */
+static uint8_t tx_queue_head;
+
+/** @brief Number of frames in the queue. */
+static uint8_t tx_queue_count;
+
+/** @brief Sequence number of the next frame queued. */
+static uint8_t tx_seq;
+
+/** @brief Ticks since the oldest frame was last sent. */
+static uint8_t tx_ticks;
+
+/** @brief Ticks to wait for an acknowledgement of the oldest frame before sending it again. */
+static uint8_t tx_timeout;
+
+/** @brief State of the generator choosing the random part of each retransmit wait. */
+static uint16_t tx_random = 1;
+
+/** @brief Number of times the oldest frame has been sent. */
+static uint8_t tx_retries;
+
+/** @brief Bytes of the frame being transmitted. */
+static uint8_t tx_bytes[IR_FRAME_OVERHEAD + IR_FRAME_PAYLOAD_MAX];
+
+/** @brief Number of bytes of the frame being transmitted. */
+static uint8_t tx_bytes_length;
+
+/** @brief Index of the next byte of the frame to transmit. */
+static uint8_t tx_bytes_index;
+
+/** @brief Flag indicating if a received frame still needs acknowledging. */
+static bool ack_pending;
+
+/** @brief Sequence number of the frame to acknowledge. */
+static uint8_t ack_seq;
+
+/** @brief Our session nonce, carried by every frame we send. */
+static uint8_t session_nonce;
+
+/** @brief The part of a frame the receiver expects next. */
+static IrRxState_t rx_state;
+
+/** @brief The frame being received. */
+static IrFrame_t rx_frame;
+
+/** @brief Session nonce of the sender of the frame being received. */
+static uint8_t rx_nonce;
+
+/** @brief Number of payload bytes of the frame received so far. */
+static uint8_t rx_index;
+
+/** @brief CRC of the frame received so far. */
+static uint16_t rx_crc;
+
+/** @brief Whether a frame was given up on without being acknowledged. */
+static bool link_lost;
+
+/** @brief Sequence number of the last frame delivered, so a resent frame is only delivered once. */
+static uint8_t rx_last_seq;
+
+/** @brief The opponent's predefined board ID, valid when rx_board_id_ready is set. */
+static uint8_t rx_board_id;
+
+/** @brief Flag indicating if a board ID has been received and not yet retrieved. */
+static bool rx_board_id_ready;
+
+/** @brief The seed and fleet of the opponent's random board, valid when rx_random_board_ready is set. */
+static RandomBoard_t rx_random_board;
+
+/** @brief Flag indicating if a random board has been received and not yet retrieved. */
+static bool rx_random_board_ready;
+
+/** @brief The fleet layout code of the opponent's edited board, valid when rx_board_code_ready is set. */
+static uint32_t rx_board_code;
+
+/** @brief Flag indicating if an edited board has been received and not yet retrieved. */
+static bool rx_board_code_ready;
+
+/** @brief The tag committing to the opponent's board, valid when rx_commitment_ready is set. */
+static CommitTag_t rx_commitment;
+
+/** @brief Flag indicating if a tag has been received and not yet retrieved. */
+static bool rx_commitment_ready;
+
+/** @brief The salt of the opponent's board, valid when rx_salt_ready is set. */
+static CommitSalt_t rx_salt;
+
+/** @brief Flag indicating if a salt has been received and not yet retrieved. */
+static bool rx_salt_ready;
+
+/** @brief The cell of the opponent's shot, valid when rx_shot_ready is set. */
+static uint8_t rx_shot;
+
+/** @brief Flag indicating if a shot has been received and not yet retrieved. */
+static bool rx_shot_ready;
+
+/** @brief The opponent's turn state, valid when rx_turn_state_ready is set. */
+static BoardResponse_t rx_turn_state;
+
+/** @brief Flag indicating if a turn state has been received and not yet retrieved. */
+static bool rx_turn_state_ready;
+
+/**
+ * @brief Adds a byte to a CRC-16/CCITT (polynomial 0x1021), started from IR_CRC_INIT.
+ *
+ * A lost byte shifts the rest of a frame, and a CRC-8 still passed about 1 in
+ * 256 of those frames, letting wrong shots and answers into the game.
+ *
+ * @param crc The CRC of the bytes so far.
+ * @param data The byte to add.
+ * @return The CRC including the byte.
+ */
+static uint16_t ir_crc16_update(uint16_t crc, uint8_t data)
+{
+    crc ^= (uint16_t) data << 8;
+    for (uint8_t bit = 0; bit < 8; bit++)
+    {
+        crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+    }
+    return crc;
+}
+
+/**
+ * @brief Generates the next pseudo random number for retransmit waits with xorshift.
+ *
+ * @return The next number in the sequence.
+ */
+static uint16_t ir_random(void)
+{
+    tx_random ^= tx_random << 7;
+    tx_random ^= tx_random >> 9;
+    tx_random ^= tx_random << 8;
+    return tx_random;
+}
+
+/**
+ * @brief Mixes the timer into the generator for retransmit waits and nonces.
+ *
+ * The generator is stepped after each mix, so two reads of the timer close
+ * together do not cancel each other out.
+ */
+static void ir_random_mix(void)
+{
+    // replay needs the same timer reads to choose the same nonce
+    tx_random ^= input_trace_timer(timer_get());
+    if (tx_random == 0)
+    {
+        tx_random = 1;
+    }
+    ir_random();
+}
+
+/**
+ * @brief Gets our session nonce, choosing it the first time a frame is sent.
+ *
+ * The timer holds the same count after every reset, so the nonce is chosen
+ * when the first frame is sent, which depends on when a player pushed a button.
+ *
+ * @return Our session nonce.
+ */
+static uint8_t ir_session_nonce(void)
+{
+    if (session_nonce == IR_NONCE_NONE)
+    {
+        ir_random_mix();
+        while (session_nonce == IR_NONCE_NONE)
+        {
+            session_nonce = (uint8_t) ir_random();
+        }
+    }
+    return session_nonce;
+}
+
+/**
+ * @brief Checks a board ID refers to a board in the catalogue.
+ *
+ * A corrupted frame can still pass the CRC, though far more rarely than the
+ * 1 in 256 of a CRC-8, so this is checked before the frame is acknowledged,
+ * then the real frame is sent again.
+ *
+ * @param payload The payload of a board ID frame.
+ * @return true if the board ID is valid.
+ */
+static bool ir_valid_board_id(const uint8_t* payload)
+{
+    return payload[0] < predefined_board_count();
+}
+
+/**
+ * @brief Delivers the opponent's predefined board ID.
+ *
+ * @param payload The payload of a board ID frame.
+ */
+static void ir_deliver_board_id(const uint8_t* payload)
+{
+    rx_board_id = payload[0];
+    rx_board_id_ready = true;
+}
+
+/**
+ * @brief Reads the seed and fleet of a random board out of a payload.
+ *
+ * @param payload The payload of a board seed frame.
+ * @param random_board The seed and fleet to set.
+ */
+static void ir_read_random_board(const uint8_t* payload, RandomBoard_t* random_board)
+{
+    random_board->seed = (uint16_t) (payload[0] | (payload[1] << 8));
+    random_board->fleet = payload[2];
+}
+
+/**
+ * @brief Checks the fleet of a random board is the one the player chooses from.
+ *
+ * Only the fleet byte is checked, generating the board is left to the end of
+ * the game, where a seed which does not generate is turned away by the board
+ * check, see commit.h, and stays out of the receive path.
+ *
+ * @param payload The payload of a board seed frame.
+ * @return true if the fleet is RANDOM_BOARD_FLEET.
+ */
+static bool ir_valid_random_board(const uint8_t* payload)
+{
+    RandomBoard_t random_board;
+
+    ir_read_random_board(payload, &random_board);
+    return random_board.fleet == RANDOM_BOARD_FLEET;
+}
+
+/**
+ * @brief Delivers the seed and fleet of the opponent's random board.
+ *
+ * @param payload The payload of a board seed frame.
+ */
+static void ir_deliver_random_board(const uint8_t* payload)
+{
+    ir_read_random_board(payload, &rx_random_board);
+    rx_random_board_ready = true;
+}
+
+/**
+ * @brief Reads a fleet layout code out of a payload.
+ *
+ * @param payload The payload of a board code frame.
+ * @return The code.
+ */
+static uint32_t ir_read_board_code(const uint8_t* payload)
+{
+    return payload[0] | ((uint32_t) payload[1] << 8) | ((uint32_t) payload[2] << 16);
+}
+
+/**
+ * @brief Checks a fleet layout code gives a layout which exists.
+ *
+ * @param payload The payload of a board code frame.
+ * @return true if the rank is below FLEET_LAYOUTS_NUM and the reflection below FLEET_LAYOUT_REFLECTIONS_NUM.
+ */
+static bool ir_valid_board_code(const uint8_t* payload)
+{
+    uint32_t code = ir_read_board_code(payload);
+
+    // the reflection has the 3 bits above the rank, of which only values 0 to 3 are reflections
+    return FLEET_LAYOUT_CODE_RANK(code) < FLEET_LAYOUTS_NUM
+        && FLEET_LAYOUT_CODE_REFLECTION(code) < FLEET_LAYOUT_REFLECTIONS_NUM;
+}
+
+/**
+ * @brief Delivers the fleet layout code of the opponent's edited board.
+ *
+ * @param payload The payload of a board code frame.
+ */
+static void ir_deliver_board_code(const uint8_t* payload)
+{
+    rx_board_code = ir_read_board_code(payload);
+    rx_board_code_ready = true;
+}
+
+/**
+ * @brief Delivers the tag committing to the opponent's board.
+ *
+ * @param payload The payload of a commit frame.
+ */
+static void ir_deliver_commitment(const uint8_t* payload)
+{
+    memcpy(rx_commitment, payload, COMMIT_TAG_BYTES);
+    rx_commitment_ready = true;
+}
+
+/**
+ * @brief Delivers the salt of the opponent's board.
+ *
+ * @param payload The payload of a salt frame.
+ */
+static void ir_deliver_salt(const uint8_t* payload)
+{
+    memcpy(rx_salt, payload, COMMIT_SALT_BYTES);
+    rx_salt_ready = true;
+}
+
+/**
+ * @brief Checks a shot is at a cell on the board.
+ *
+ * @param payload The payload of a shot frame.
+ * @return true if the cell is on the board.
+ */
+static bool ir_valid_shot(const uint8_t* payload)
+{
+    return payload[0] < BOARD_ROWS_NUM * BOARD_COLS_NUM;
+}
+
+/**
+ * @brief Delivers the cell of the opponent's shot.
+ *
+ * @param payload The payload of a shot frame.
+ */
+static void ir_deliver_shot(const uint8_t* payload)
+{
+    rx_shot = payload[0];
+    rx_shot_ready = true;
+}
+
+/**
+ * @brief Checks a turn state is one a board sends.
+ *
+ * @param payload The payload of a turn state frame.
+ * @return true if the turn state is valid.
+ */
+static bool ir_valid_turn_state(const uint8_t* payload)
+{
+    return payload[0] >= MISS && payload[0] <= LOSER;
+}
+
+/**
+ * @brief Delivers the opponent's turn state.
+ *
+ * @param payload The payload of a turn state frame.
+ */
+static void ir_deliver_turn_state(const uint8_t* payload)
+{
+    rx_turn_state = (BoardResponse_t) payload[0];
+    rx_turn_state_ready = true;
+}
+
+/** @brief How the frames of each type are checked and delivered, indexed by IrFrameType_t. */
+static const IrMessageHandler_t IR_MESSAGE_HANDLERS[IR_FRAME_TYPES_NUM] = {
+    [IR_FRAME_ACK] = {0, NULL, NULL},
+    [IR_FRAME_BOARD_ID] = {1, ir_valid_board_id, ir_deliver_board_id},
+    [IR_FRAME_TURN_STATE] = {1, ir_valid_turn_state, ir_deliver_turn_state},
+    [IR_FRAME_BOARD_SEED] = {3, ir_valid_random_board, ir_deliver_random_board},
+    [IR_FRAME_BOARD_CODE] = {FLEET_LAYOUT_RANK_BYTES, ir_valid_board_code, ir_deliver_board_code},
+    [IR_FRAME_COMMIT] = {COMMIT_TAG_BYTES, NULL, ir_deliver_commitment},
+    [IR_FRAME_SHOT] = {1, ir_valid_shot, ir_deliver_shot},
+    [IR_FRAME_SALT] = {COMMIT_SALT_BYTES, NULL, ir_deliver_salt},
+};
+
+/**
+ * @brief Gets the payload length every frame of a type carries.
+ *
+ * Checking the length before the CRC stops a corrupted length byte from
+ * pulling the next frame's bytes into this one.
+ *
+ * @param type The frame type.
+ * @return The payload length, or IR_FRAME_TYPE_INVALID if no frame has the type.
+ */
+static uint8_t ir_frame_length(uint8_t type)
+{
+    return type < IR_FRAME_TYPES_NUM ? IR_MESSAGE_HANDLERS[type].length : IR_FRAME_TYPE_INVALID;
+}
+
+/**
+ * @brief Encodes a frame into the transmit buffer.
+ *
+ * @param header The frame header.
+ * @param length The number of payload bytes.
+ * @param payload The payload.
+ */
+static void ir_encode_frame(uint8_t header, uint8_t length, const uint8_t* payload)
+{
+    uint8_t nonce = ir_session_nonce();
+    uint16_t crc = ir_crc16_update(ir_crc16_update(ir_crc16_update(IR_CRC_INIT, nonce), header), length);
+
+    tx_bytes[0] = IR_FRAME_SYNC;
+    tx_bytes[1] = nonce;
+    tx_bytes[2] = header;
+    tx_bytes[3] = length;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        tx_bytes[4 + i] = payload[i];
+        crc = ir_crc16_update(crc, payload[i]);
+    }
+    tx_bytes[4 + length] = (uint8_t) (crc >> 8);
+    tx_bytes[5 + length] = (uint8_t) crc;
+    tx_bytes_length = IR_FRAME_OVERHEAD + length;
+    tx_bytes_index = 0;
+}
+
+/**
+ * @brief Queues a frame to be sent until it is acknowledged.
+ *
+ * The frame is dropped if the queue is full, which only happens when the
+ * opponent has stopped acknowledging frames.
+ *
+ * @param type The frame type.
+ * @param length The number of payload bytes.
+ * @param payload The payload.
+ */
+static void ir_queue_frame(IrFrameType_t type, uint8_t length, const uint8_t* payload)
+{
+    if (tx_queue_count == IR_TX_QUEUE_SIZE)
+    {
+        return;
+    }
+
+    // the time a frame is queued depends on the player, so mixing it in
+    // gives each board its own sequence of retransmit waits
+    ir_random_mix();
+
+    IrFrame_t* frame = &tx_queue[(tx_queue_head + tx_queue_count) % IR_TX_QUEUE_SIZE];
+    frame->header = IR_FRAME_HEADER(type, tx_seq++);
+    frame->length = length;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        frame->payload[i] = payload[i];
+    }
+
+    if (tx_queue_count++ == 0)
+    {
+        tx_retries = 0;
+    }
+}
+
+/**
+ * @brief Removes the oldest frame from the queue, so the next is sent straight away.
+ */
+static void ir_dequeue_frame(void)
+{
+    tx_queue_head = (tx_queue_head + 1) % IR_TX_QUEUE_SIZE;
+    tx_queue_count--;
+    tx_retries = 0;
+}
+
+/**
+ * @brief Handles a complete frame with a valid CRC.
+ *
+ * A frame carrying our session nonce is our own echo and is dropped.
+ *
+ * An acknowledgement of the oldest queued frame removes it from the queue.
+ * Any other frame is checked by the handler for its type, acknowledged, then
+ * delivered by the handler unless it is a resend of the last frame delivered.
+ */
+static void ir_receive_frame(void)
+{
+    uint8_t type = IR_FRAME_GET_TYPE(rx_frame.header);
+    uint8_t seq = IR_FRAME_GET_SEQ(rx_frame.header);
+
+    if (rx_nonce == session_nonce)
+    {
+        return;
+    }
+
+    if (type == IR_FRAME_ACK)
+    {
+        if (tx_queue_count != 0 && tx_retries != 0 && IR_FRAME_GET_SEQ(tx_queue[tx_queue_head].header) == seq)
+        {
+            ir_dequeue_frame();
+        }
+        return;
+    }
+
+    const IrMessageHandler_t* handler = &IR_MESSAGE_HANDLERS[type];
+    if (handler->valid != NULL && !handler->valid(rx_frame.payload))
+    {
+        return;
+    }
+
+    ack_pending = true;
+    ack_seq = seq;
+    if (seq == rx_last_seq)
+    {
+        return;
+    }
+    rx_last_seq = seq;
+    handler->deliver(rx_frame.payload);
+}
+
+/**
+ * @brief Waits for the next frame, starting it straight away if the byte is a sync byte.
+ *
+ * A payload can hold the sync byte, so a receiver which lost its place can
+ * start a frame partway through another. The byte which shows that frame is
+ * wrong may then be the sync byte of the resent frame, and dropping it too
+ * would lose the same frame on every resend.
+ *
+ * @param data The received byte.
+ */
+static void ir_receive_sync(uint8_t data)
+{
+    if (data == IR_FRAME_SYNC)
+    {
+        rx_crc = IR_CRC_INIT;
+        rx_state = IR_RX_NONCE;
+    }
+    else
+    {
+        rx_state = IR_RX_SYNC;
+    }
+}
+
+/**
+ * @brief Passes a received byte to the frame receiver.
+ *
+ * A frame with the wrong length for its type or a bad CRC is dropped and the
+ * receiver waits for the next sync byte, the sender will send the frame again.
+ *
+ * @param data The received byte.
+ */
+static void ir_receive_byte(uint8_t data)
+{
+    switch (rx_state)
+    {
+        case IR_RX_SYNC:
+            ir_receive_sync(data);
+            break;
+        case IR_RX_NONCE:
+            rx_nonce = data;
+            rx_crc = ir_crc16_update(rx_crc, data);
+            rx_state = IR_RX_HEADER;
+            break;
+        case IR_RX_HEADER:
+            rx_frame.header = data;
+            rx_crc = ir_crc16_update(rx_crc, data);
+            rx_state = IR_RX_LENGTH;
+            break;
+        case IR_RX_LENGTH:
+            if (data != ir_frame_length(IR_FRAME_GET_TYPE(rx_frame.header)))
+            {
+                ir_receive_sync(data);
+                break;
+            }
+            rx_frame.length = data;
+            rx_index = 0;
+            rx_crc = ir_crc16_update(rx_crc, data);
+            rx_state = data == 0 ? IR_RX_CRC_HIGH : IR_RX_PAYLOAD;
+            break;
+        case IR_RX_PAYLOAD:
+            rx_frame.payload[rx_index++] = data;
+            rx_crc = ir_crc16_update(rx_crc, data);
+            if (rx_index == rx_frame.length)
+            {
+                rx_state = IR_RX_CRC_HIGH;
+            }
+            break;
+        case IR_RX_CRC_HIGH:
+            if (data == (uint8_t) (rx_crc >> 8))
+            {
+                rx_state = IR_RX_CRC_LOW;
+            }
+            else
+            {
+                ir_receive_sync(data);
+            }
+            break;
+        case IR_RX_CRC_LOW:
+            if (data == (uint8_t) rx_crc)
+            {
+                ir_receive_frame();
+                rx_state = IR_RX_SYNC;
+            }
+            else
+            {
+                ir_receive_sync(data);
+            }
+            break;
+        default:
+            rx_state = IR_RX_SYNC;
+            break;
+    }
+}
+
+/**
+ * @brief Initializes IR communication, emptying the frame queue and forgetting received frames.
+ */
+void ir_init(void)
+{
+    ir_uart_init();
+    ir_rx_init();
+
+    tx_queue_head = 0;
+    tx_queue_count = 0;
+    tx_seq = 0;
+    tx_ticks = 0;
+    tx_timeout = IR_RETRANSMIT_TICKS;
+    tx_retries = 0;
+    tx_bytes_length = 0;
+    tx_bytes_index = 0;
+    ack_pending = false;
+    session_nonce = IR_NONCE_NONE;
+    link_lost = false;
+
+    rx_state = IR_RX_SYNC;
+    rx_last_seq = IR_SEQ_NONE;
+    rx_board_id_ready = false;
+    rx_random_board_ready = false;
+    rx_board_code_ready = false;
+    rx_commitment_ready = false;
+    rx_salt_ready = false;
+    rx_shot_ready = false;
+    rx_turn_state_ready = false;
+}
+
+/**
+ * @brief Runs IR communication for a single tick.
+ *
+ * Every received byte is passed to the frame receiver. Once the last frame has
+ * been transmitted, a pending acknowledgement is sent first, then the oldest
+ * queued frame is sent again if it has not been acknowledged in time.
+ */
+void ir_update(void)
+{
+    uint8_t data;
+    while (ir_rx_get(&data))
+    {
+        ir_receive_byte(data);
+    }
+
+    if (tx_bytes_index == tx_bytes_length)
+    {
+        if (ack_pending)
+        {
+            ir_encode_frame(IR_FRAME_HEADER(IR_FRAME_ACK, ack_seq), 0, 0);
+            ack_pending = false;
+        }
+        else if (tx_queue_count != 0 && (tx_retries == 0 || tx_ticks >= tx_timeout))
+        {
+            if (tx_retries == IR_RETRIES_MAX)
+            {
+                // the opponent has gone, give up on this frame and report
+                // it, as the game is waiting for a reply which cannot come
+                link_lost = true;
+                ir_dequeue_frame();
+            }
+            else
+            {
+                // if both boards chose the same nonce they drop each other's
+                // frames, so choose another once a frame has gone unanswered
+                // long enough that none of our echoes are still arriving
+                if (tx_retries != 0 && tx_retries % IR_NONCE_RETRIES == 0)
+                {
+                    session_nonce = IR_NONCE_NONE;
+                }
+                const IrFrame_t* frame = &tx_queue[tx_queue_head];
+                ir_encode_frame(frame->header, frame->length, frame->payload);
+                tx_retries++;
+                tx_ticks = 0;
+                tx_timeout = IR_RETRANSMIT_TICKS + (ir_random() & (IR_RETRANSMIT_JITTER_TICKS - 1));
+            }
+        }
+    }
+
+    while (tx_bytes_index != tx_bytes_length && ir_uart_write_ready_p())
+    {
+        ir_uart_putc(tx_bytes[tx_bytes_index++]);
+    }
+
+    if (tx_ticks != UINT8_MAX)
+    {
+        tx_ticks++;
+    }
+}
+
+/**
+ * @brief Checks if the IR link has nothing left to do until another frame arrives.
+ *
+ * @return true if the link is idle.
+ */
+bool ir_idle(void)
+{
+    return tx_queue_count == 0 && !ack_pending && tx_bytes_index == tx_bytes_length
+        && ir_uart_write_finished_p() && rx_state == IR_RX_SYNC && ir_rx_empty()
+        && !rx_board_id_ready && !rx_random_board_ready && !rx_board_code_ready && !rx_commitment_ready
+        && !rx_salt_ready && !rx_shot_ready && !rx_turn_state_ready;
+}
+
+/**
+ * @brief Checks if the opponent has stopped answering.
+ *
+ * A frame is given up on once it has been sent IR_RETRIES_MAX times without
+ * being acknowledged, the game can then not go on.
+ *
+ * @return true once a frame has been given up on, until ir_init() is called.
+ */
+bool ir_link_lost(void)
+{
+    return link_lost;
+}
 
 /**
  * @brief Retrieves the opponent's predefined board ID via IR communication.
  *
- * This function checks if there is data ready to be read from the IR receiver.
- * If the data has the correct prefix, it extracts the predefined board ID and
- * stores it in the provided pointer.
+ * This function checks if a board ID frame has been received since the last
+ * call and, if so, stores the board ID in the provided pointer.
  *
  * @param id Pointer to store the received predefined board ID.
  * @return true if a valid board ID was received, false otherwise.
  */
 bool ir_get_their_predefined_board_id(uint8_t* id)
 {
-    if (ir_uart_read_ready_p()) {
-        uint8_t received = (uint8_t) ir_uart_getc();
-        if ((received & 0xF0) == BOARD_ID_PREFIX) { 
-            *id = GET_BOARD_ID(received);
-            return true;
-        }
+    if (!rx_board_id_ready)
+    {
+        return false;
     }
-    return false;
+    *id = rx_board_id;
+    rx_board_id_ready = false;
+    return true;
 }
 
 /**
  * @brief Sends our predefined board ID via IR communication.
  *
- * This function sends our predefined board ID to the opponent via IR communication.
- * The board ID is prefixed with a specific identifier to indicate its type.
+ * This function queues our predefined board ID to be sent to the opponent,
+ * it is sent by ir_update() until the opponent acknowledges it.
  *
  * @param id The predefined board ID to send.
  */
 void ir_send_our_predefined_board_id(uint8_t id)
 {
-    char prefixed_id = BOARD_ID_PREFIX | (id & 0x0F);
-    ir_uart_putc(prefixed_id);
+    ir_queue_frame(IR_FRAME_BOARD_ID, 1, &id);
+}
+
+/**
+ * @brief Retrieves the seed and fleet of the opponent's random board via IR communication.
+ *
+ * This function checks if a board seed frame has been received since the
+ * last call and, if so, stores the seed and fleet in the provided pointer.
+ *
+ * @param random_board Pointer to store the received seed and fleet.
+ * @return true if a random board which generates was received, false otherwise.
+ */
+bool ir_get_their_random_board(RandomBoard_t* random_board)
+{
+    if (!rx_random_board_ready)
+    {
+        return false;
+    }
+    *random_board = rx_random_board;
+    rx_random_board_ready = false;
+    return true;
+}
+
+/**
+ * @brief Sends the seed and fleet of our random board via IR communication.
+ *
+ * This function queues the seed and fleet to be sent to the opponent, who
+ * generates the same board from them. It is sent by ir_update() until the
+ * opponent acknowledges it.
+ *
+ * @param random_board The seed and fleet to send.
+ */
+void ir_send_our_random_board(const RandomBoard_t* random_board)
+{
+    uint8_t payload[3] = {(uint8_t) random_board->seed, (uint8_t) (random_board->seed >> 8), random_board->fleet};
+    ir_queue_frame(IR_FRAME_BOARD_SEED, sizeof(payload), payload);
+}
+
+/**
+ * @brief Retrieves the fleet layout code of the opponent's edited board via IR communication.
+ *
+ * This function checks if a board code frame has been received since the
+ * last call and, if so, stores the code in the provided pointer.
+ *
+ * @param code Pointer to store the received code.
+ * @return true if a code of a layout which exists was received, false otherwise.
+ */
+bool ir_get_their_edited_board(uint32_t* code)
+{
+    if (!rx_board_code_ready)
+    {
+        return false;
+    }
+    *code = rx_board_code;
+    rx_board_code_ready = false;
+    return true;
+}
+
+/**
+ * @brief Sends the fleet layout code of our edited board via IR communication.
+ *
+ * This function queues the code to be sent to the opponent, who rebuilds the
+ * board from it. It is sent by ir_update() until the opponent acknowledges it.
+ *
+ * @param code The code to send.
+ */
+void ir_send_our_edited_board(uint32_t code)
+{
+    uint8_t payload[FLEET_LAYOUT_RANK_BYTES] = {(uint8_t) code, (uint8_t) (code >> 8), (uint8_t) (code >> 16)};
+    ir_queue_frame(IR_FRAME_BOARD_CODE, sizeof(payload), payload);
+}
+
+/**
+ * @brief Retrieves the tag committing to the opponent's board via IR communication.
+ *
+ * This function checks if a commit frame has been received since the last
+ * call and, if so, stores the tag in the provided pointer.
+ *
+ * @param tag Pointer to store the received tag.
+ * @return true if a tag was received, false otherwise.
+ */
+bool ir_get_their_commitment(CommitTag_t* tag)
+{
+    if (!rx_commitment_ready)
+    {
+        return false;
+    }
+    memcpy(*tag, rx_commitment, COMMIT_TAG_BYTES);
+    rx_commitment_ready = false;
+    return true;
+}
+
+/**
+ * @brief Sends the tag committing to our board via IR communication.
+ *
+ * This function queues the tag to be sent to the opponent, it is sent by
+ * ir_update() until the opponent acknowledges it.
+ *
+ * @param tag The tag to send.
+ */
+void ir_send_our_commitment(const CommitTag_t* tag)
+{
+    ir_queue_frame(IR_FRAME_COMMIT, COMMIT_TAG_BYTES, *tag);
+}
+
+/**
+ * @brief Retrieves the salt of the opponent's board via IR communication.
+ *
+ * This function checks if a salt frame has been received since the last
+ * call and, if so, stores the salt in the provided pointer.
+ *
+ * @param salt Pointer to store the received salt.
+ * @return true if a salt was received, false otherwise.
+ */
+bool ir_get_their_salt(CommitSalt_t* salt)
+{
+    if (!rx_salt_ready)
+    {
+        return false;
+    }
+    memcpy(*salt, rx_salt, COMMIT_SALT_BYTES);
+    rx_salt_ready = false;
+    return true;
+}
+
+/**
+ * @brief Sends the salt of our board via IR communication.
+ *
+ * This function queues the salt to be sent to the opponent, it is sent by
+ * ir_update() until the opponent acknowledges it.
+ *
+ * @param salt The salt to send.
+ */
+void ir_send_our_salt(const CommitSalt_t* salt)
+{
+    ir_queue_frame(IR_FRAME_SALT, COMMIT_SALT_BYTES, *salt);
+}
+
+/**
+ * @brief Retrieves the cell of the opponent's shot via IR communication.
+ *
+ * This function checks if a shot frame has been received since the last
+ * call and, if so, stores the cell in the provided pointers.
+ *
+ * @param row Pointer to store the row index of the cell.
+ * @param col Pointer to store the column index of the cell.
+ * @return true if a shot at a cell on the board was received, false otherwise.
+ */
+bool ir_get_their_shot(uint8_t* row, uint8_t* col)
+{
+    if (!rx_shot_ready)
+    {
+        return false;
+    }
+    *row = rx_shot / BOARD_COLS_NUM;
+    *col = rx_shot % BOARD_COLS_NUM;
+    rx_shot_ready = false;
+    return true;
+}
+
+/**
+ * @brief Sends the cell of our shot via IR communication.
+ *
+ * This function queues the cell to be sent to the opponent, who answers
+ * with a turn state. It is sent by ir_update() until the opponent
+ * acknowledges it.
+ *
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ */
+void ir_send_our_shot(uint8_t row, uint8_t col)
+{
+    uint8_t cell = row * BOARD_COLS_NUM + col;
+    ir_queue_frame(IR_FRAME_SHOT, 1, &cell);
 }
 
 /**
  * @brief Retrieves the opponent's turn state via IR communication.
  *
- * This function checks if there is data ready to be read from the IR receiver.
- * If the data has the correct prefix, it extracts the turn state and stores it
- * in the provided pointer.
+ * This function checks if a turn state frame has been received since the
+ * last call and, if so, stores the turn state in the provided pointer.
  *
  * @param response Pointer to store the received turn state.
  * @return true if a valid response was received, false otherwise.
  */
 bool ir_get_their_turn_state(BoardResponse_t* response)
 {
-    if (ir_uart_read_ready_p()) {
-        uint8_t received = (uint8_t) ir_uart_getc();
-        if ((received & 0xF0) == BOARD_RESPONSE_PREFIX) { 
-            *response = (BoardResponse_t) GET_BOARD_RESPONSE(received);
-            return true;
-        }
+    if (!rx_turn_state_ready)
+    {
+        return false;
     }
-    return false;
+    *response = rx_turn_state;
+    rx_turn_state_ready = false;
+    return true;
 }
 
 /**
  * @brief Sends our turn state via IR communication.
  *
- * This function sends our turn state to the opponent via IR communication.
- * The turn state is prefixed with a specific identifier to indicate its type.
+ * This function queues our turn state to be sent to the opponent, it is sent
+ * by ir_update() until the opponent acknowledges it.
  *
  * @param response The board response to send.
  */
 void ir_send_our_turn_state(BoardResponse_t response)
 {
-    char prefixed_response = BOARD_RESPONSE_PREFIX | (response & 0x0F);
-    ir_uart_putc(prefixed_response);
-}
\ No newline at end of file
+    uint8_t payload = (uint8_t) response;
+    ir_queue_frame(IR_FRAME_TURN_STATE, 1, &payload);
+}
@@ -1,4 +1,4 @@
-/** 
+/**
  * @file   ir.h
  * @brief  Header of IR communication functions for the Battleship game.
  * @author Corey Hines
@@ -11,30 +11,117 @@
 #include <stdint.h>
 #include "ir_uart.h"
 #include "board.h"
+#include "random_board.h"
+#include "commit.h"
+
+/**
+ * @brief Byte marking the start of every frame sent over IR communication.
+ *
+ * A frame is the sync byte, the sender's session nonce, a header holding the
+ * frame type in its high nibble and a sequence number in its low nibble, the
+ * payload length, the payload, then a CRC-16 of everything after the sync
+ * byte, high byte first.
+ */
+#define IR_FRAME_SYNC 0x7E
+
+/**
+ * @brief Value the CRC-16/CCITT of every frame starts from.
+ */
+#define IR_CRC_INIT 0xFFFF
+
+/**
+ * @brief Largest payload a frame can carry, in bytes.
+ */
+#define IR_FRAME_PAYLOAD_MAX 8
+
+/**
+ * @brief Bytes a frame adds around its payload: sync, nonce, header, length and CRC.
+ */
+#define IR_FRAME_OVERHEAD 6
+
+/**
+ * @brief Ticks to wait for an acknowledgement before sending a frame again.
+ *
+ * A frame and its acknowledgement take about 55 ms to cross at 2400 baud.
+ */
+#define IR_RETRANSMIT_TICKS 50
+
+/**
+ * @brief Largest random extra wait before sending a frame again, must be a power of two.
+ *
+ * Two boards which send at the same time garble each other's frames, the
+ * random wait stops them colliding again on every retry.
+ */
+#define IR_RETRANSMIT_JITTER_TICKS 32
+
+/**
+ * @brief Number of times a frame is sent before it is given up on, about 10 to 16 seconds, see ir_link_lost().
+ *
+ * Each send waits IR_RETRANSMIT_TICKS plus up to IR_RETRANSMIT_JITTER_TICKS - 1
+ * ticks of 2 ms for its acknowledgement, 100 to 162 ms.
+ */
+#define IR_RETRIES_MAX 100
+
+/**
+ * @brief Number of times a frame is sent unacknowledged before we choose a new session nonce.
+ *
+ * Frames carrying our own nonce are dropped as echoes. If the opponent chose
+ * the same nonce we drop each other's frames too, even when both send the
+ * same frame, so the only sign is that nothing is acknowledged. By this many
+ * sends none of our echoes are still arriving to be mistaken for theirs.
+ */
+#define IR_NONCE_RETRIES 16
+
+/**
+ * @brief Number of frames which can wait to be acknowledged.
+ */
+#define IR_TX_QUEUE_SIZE 4
+
+/**
+ * @enum  IrFrameType_t
+ * @brief The types of frame sent over IR communication.
+ */
+typedef enum {
+    IR_FRAME_ACK,        /**< Acknowledges the frame with the same sequence number, has no payload. */
+    IR_FRAME_BOARD_ID,   /**< Carries our predefined board ID, revealed once the game ends. */
+    IR_FRAME_TURN_STATE, /**< Carries the BoardResponse_t answering the opponent's shot. */
+    IR_FRAME_BOARD_SEED, /**< Carries the seed, low byte first, and fleet of our random board. */
+    IR_FRAME_BOARD_CODE, /**< Carries the fleet layout code, low byte first, of our edited board. */
+    IR_FRAME_COMMIT,     /**< Carries the tag committing to our board, see commit.h. */
+    IR_FRAME_SHOT,       /**< Carries the cell of our shot, its row times BOARD_COLS_NUM plus its column. */
+    IR_FRAME_SALT,       /**< Carries the salt of our board's tag, revealed once the game ends. */
+    IR_FRAME_TYPES_NUM,  /**< Number of frame types. */
+} IrFrameType_t;
 
 /**
- * @brief Prefix for sending predefined board IDs over IR communication.
+ * @brief Initializes IR communication, emptying the frame queue and forgetting received frames.
  */
-#define BOARD_ID_PREFIX 0xA0
+void ir_init(void);
 
 /**
- * @brief Prefix for sending board response states over IR communication.
+ * @brief Runs IR communication for a single tick.
+ *
+ * Received bytes are assembled into frames and acknowledged, unacknowledged
+ * frames are sent again and queued bytes are transmitted. This must be
+ * called every tick, including while a scrolling message is shown.
  */
-#define BOARD_RESPONSE_PREFIX 0xB0
+void ir_update(void);
 
 /**
- * @brief Macro to extract the predefined board ID from received data.
- * @param data The data received over IR communication.
- * @return The predefined board ID (last 4 bits of the data).
+ * @brief Checks if the IR link has nothing left to do until another frame arrives.
+ *
+ * The link is idle when nothing is queued or being transmitted, no frame is
+ * partly received and every received message has been read.
+ *
+ * @return true if the link is idle.
  */
-#define GET_BOARD_ID(data) ((data) & 0x0F)
+bool ir_idle(void);
 
 /**
- * @brief Macro to extract the board response from received data.
- * @param data The data received over IR communication.
- * @return The board response (last 4 bits of the data).
+ * @brief  Checks if the opponent has stopped answering.
+ * @return true once a frame has been sent IR_RETRIES_MAX times without being acknowledged.
  */
-#define GET_BOARD_RESPONSE(data) ((data) & 0x0F)
+bool ir_link_lost(void);
 
 /**
  * @brief Retrieves the opponent's predefined board ID via IR communication.
@@ -49,6 +136,73 @@ bool ir_get_their_predefined_board_id(uint8_t* id);
  */
 void ir_send_our_predefined_board_id(uint8_t id);
 
+/**
+ * @brief Retrieves the seed and fleet of the opponent's random board via IR communication.
+ * @param random_board Pointer to store the received seed and fleet.
+ * @return true if a random board which generates was received, false otherwise.
+ */
+bool ir_get_their_random_board(RandomBoard_t* random_board);
+
+/**
+ * @brief Sends the seed and fleet of our random board via IR communication.
+ * @param random_board The seed and fleet to send.
+ */
+void ir_send_our_random_board(const RandomBoard_t* random_board);
+
+/**
+ * @brief Retrieves the fleet layout code of the opponent's edited board via IR communication.
+ * @param code Pointer to store the received code.
+ * @return true if a code of a layout which exists was received, false otherwise.
+ */
+bool ir_get_their_edited_board(uint32_t* code);
+
+/**
+ * @brief Sends the fleet layout code of our edited board via IR communication.
+ * @param code The code to send.
+ */
+void ir_send_our_edited_board(uint32_t code);
+
+/**
+ * @brief Retrieves the tag committing to the opponent's board via IR communication.
+ * @param tag Pointer to store the received tag.
+ * @return true if a tag was received, false otherwise.
+ */
+bool ir_get_their_commitment(CommitTag_t* tag);
+
+/**
+ * @brief Sends the tag committing to our board via IR communication.
+ * @param tag The tag to send.
+ */
+void ir_send_our_commitment(const CommitTag_t* tag);
+
+/**
+ * @brief Retrieves the salt of the opponent's board via IR communication.
+ * @param salt Pointer to store the received salt.
+ * @return true if a salt was received, false otherwise.
+ */
+bool ir_get_their_salt(CommitSalt_t* salt);
+
+/**
+ * @brief Sends the salt of our board via IR communication.
+ * @param salt The salt to send.
+ */
+void ir_send_our_salt(const CommitSalt_t* salt);
+
+/**
+ * @brief Retrieves the cell of the opponent's shot via IR communication.
+ * @param row Pointer to store the row index of the cell.
+ * @param col Pointer to store the column index of the cell.
+ * @return true if a shot at a cell on the board was received, false otherwise.
+ */
+bool ir_get_their_shot(uint8_t* row, uint8_t* col);
+
+/**
+ * @brief Sends the cell of our shot via IR communication.
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ */
+void ir_send_our_shot(uint8_t row, uint8_t col);
+
 /**
  * @brief Retrieves the opponent's turn state via IR communication.
  * @param response Pointer to store the received turn state.
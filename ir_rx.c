@@ -0,0 +1,159 @@
+/** 
+ * @file   ir_rx.c
+ * @brief  Implementation of the IR receive buffer for the Battleship game.
+ *
+ * The USART1 receive interrupt moves every byte out of the UART as soon as it
+ * arrives into a ring buffer, which the game loop empties through ir_rx_get().
+ * The USART1 only holds two bytes, so without the interrupt any tick which ran
+ * long could lose bytes.
+ *
+ * The interrupt only writes the head and the game loop only writes the tail,
+ * and both are single bytes, so neither side needs to disable interrupts.
+ *
+ * Host builds have no interrupts, so the buffer is filled from the IR UART
+ * stand-in whenever the game loop asks for a byte.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+#include "ir_uart.h"
+#include "ir_rx.h"
+#include "input_trace.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#endif
+
+/**
+ * @brief Mask wrapping an index into the buffer.
+ */
+#define IR_RX_INDEX_MASK (IR_RX_BUFFER_SIZE - 1)
+
+/** @brief The received bytes. */
+static volatile uint8_t rx_buffer[IR_RX_BUFFER_SIZE];
+
+/** @brief Index the next received byte is written to, only written by the interrupt. */
+static volatile uint8_t rx_head;
+
+/** @brief Index the next byte is taken from, only written by the game loop. */
+static volatile uint8_t rx_tail;
+
+/** @brief Number of bytes lost because the buffer was full. */
+static volatile uint8_t rx_overruns;
+
+/**
+ * @brief Adds a received byte to the buffer, counting it as lost if the buffer is full.
+ *
+ * @param data The received byte.
+ */
+static void ir_rx_put(uint8_t data)
+{
+    uint8_t next = (rx_head + 1) & IR_RX_INDEX_MASK;
+    if (next == rx_tail)
+    {
+        if (rx_overruns != UINT8_MAX)
+        {
+            rx_overruns++;
+        }
+        return;
+    }
+    rx_buffer[rx_head] = data;
+    rx_head = next;
+}
+
+#ifdef __AVR__
+/**
+ * @brief USART1 receive interrupt, moves the received byte into the buffer.
+ */
+ISR(USART1_RX_vect)
+{
+    ir_rx_put(UDR1);
+}
+#endif
+
+/**
+ * @brief Initializes the receive buffer, emptying it and enabling the USART1 receive interrupt.
+ *
+ * This must be called after ir_uart_init(), which sets up the USART1.
+ */
+void ir_rx_init(void)
+{
+    rx_head = 0;
+    rx_tail = 0;
+    rx_overruns = 0;
+
+#ifdef __AVR__
+    UCSR1B |= BIT(RXCIE1);
+    sei();
+#endif
+}
+
+/**
+ * @brief Takes the oldest received byte from the buffer.
+ *
+ * @param data Pointer to store the received byte.
+ * @return true if a byte was taken, false if the buffer is empty.
+ */
+static bool ir_rx_take(uint8_t* data)
+{
+#ifndef __AVR__
+    if (rx_tail == rx_head && ir_uart_read_ready_p())
+    {
+        ir_rx_put((uint8_t) ir_uart_getc());
+    }
+#endif
+
+    uint8_t tail = rx_tail;
+    if (tail == rx_head)
+    {
+        return false;
+    }
+    *data = rx_buffer[tail];
+    rx_tail = (tail + 1) & IR_RX_INDEX_MASK;
+    return true;
+}
+
+/**
+ * @brief Takes the oldest received byte, passing it through the input trace.
+ *
+ * When the input trace is replaying, the bytes it holds are returned in
+ * place of the buffer's.
+ *
+ * @param data Pointer to store the received byte.
+ * @return true if a byte was taken, false if there is none this tick.
+ */
+bool ir_rx_get(uint8_t* data)
+{
+    return input_trace_ir(data, ir_rx_take(data));
+}
+
+/**
+ * @brief Checks if the buffer is empty.
+ *
+ * @return true if no received byte is waiting to be taken.
+ */
+bool ir_rx_empty(void)
+{
+#ifndef __AVR__
+    if (ir_uart_read_ready_p())
+    {
+        return false;
+    }
+#endif
+    return rx_tail == rx_head;
+}
+
+/**
+ * @brief Gets the number of bytes lost because the buffer was full.
+ *
+ * @return The number of bytes lost since ir_rx_init().
+ */
+uint8_t ir_rx_overruns(void)
+{
+    return rx_overruns;
+}
@@ -0,0 +1,45 @@
+/** 
+ * @file   ir_rx.h
+ * @brief  Header of the IR receive buffer for the Battleship game.
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef IR_RX_H
+#define IR_RX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of received bytes the buffer holds, must be a power of two.
+ *
+ * The longest frame is 13 bytes, so the buffer holds two whole frames.
+ */
+#define IR_RX_BUFFER_SIZE 32
+
+/**
+ * @brief Initializes the receive buffer, emptying it and enabling the USART1 receive interrupt.
+ */
+void ir_rx_init(void);
+
+/**
+ * @brief Takes the oldest received byte from the buffer, or from the input trace when it is replaying.
+ * @param data Pointer to store the received byte.
+ * @return true if a byte was taken, false if there is none this tick.
+ */
+bool ir_rx_get(uint8_t* data);
+
+/**
+ * @brief Checks if the buffer is empty.
+ * @return true if no received byte is waiting to be taken.
+ */
+bool ir_rx_empty(void);
+
+/**
+ * @brief Gets the number of bytes lost because the buffer was full.
+ * @return The number of bytes lost since ir_rx_init().
+ */
+uint8_t ir_rx_overruns(void);
+
+#endif /* IR_RX_H */
@@ -0,0 +1,86 @@
+/** 
+ * @file   memory.c
+ * @brief  Implementation of the SRAM usage measurement for the Battleship game.
+ *
+ * The paint is applied from the .init1 section, which runs before the stack
+ * pointer and the zero register are set up, so it is written in assembly
+ * using only the registers the C runtime sets up after it. The game never
+ * uses the heap, so the free SRAM is all between _end and __stack.
+ *
+ * Host builds have no painted SRAM and report nothing.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include "memory.h"
+
+#ifdef __AVR__
+/** @brief The first byte after the static data, set by the linker. */
+extern uint8_t _end;
+
+/** @brief The top of the stack, set by the linker. */
+extern uint8_t __stack;
+
+/**
+ * @brief Paints the free SRAM with MEMORY_PAINT before the C runtime starts.
+ */
+void memory_paint(void) __attribute__((naked, used, section(".init1")));
+
+void memory_paint(void)
+{
+    __asm volatile (
+        "    ldi r30, lo8(_end)\n"
+        "    ldi r31, hi8(_end)\n"
+        "    ldi r24, %0\n"
+        "    ldi r25, hi8(__stack)\n"
+        "    rjmp 2f\n"
+        "1:  st Z+, r24\n"
+        "2:  cpi r30, lo8(__stack)\n"
+        "    cpc r31, r25\n"
+        "    brlo 1b\n"
+        "    breq 1b\n"
+        :
+        : "i" (MEMORY_PAINT));
+}
+#endif /* __AVR__ */
+
+/**
+ * @brief Gets the least free SRAM there has been since reset.
+ *
+ * The paint is counted up from the end of the static data until the first
+ * byte the stack has written.
+ *
+ * @return The number of bytes never reached by the stack, 0 on the host.
+ */
+uint16_t memory_free_min(void)
+{
+#ifdef __AVR__
+    const uint8_t* p = &_end;
+    uint16_t free = 0;
+
+    while (p <= &__stack && *p == MEMORY_PAINT)
+    {
+        p++;
+        free++;
+    }
+    return free;
+#else
+    return 0;
+#endif
+}
+
+/**
+ * @brief Gets the deepest the stack has been since reset.
+ *
+ * @return The number of bytes of the deepest stack, 0 on the host.
+ */
+uint16_t memory_stack_peak(void)
+{
+#ifdef __AVR__
+    return (uint16_t) (&__stack - &_end + 1) - memory_free_min();
+#else
+    return 0;
+#endif
+}
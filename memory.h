@@ -0,0 +1,36 @@
+/** 
+ * @file   memory.h
+ * @brief  Header of the SRAM usage measurement for the Battleship game.
+ *
+ * Before the C runtime starts, the SRAM between the end of the static data
+ * and the top of the stack is painted with MEMORY_PAINT. The stack only
+ * overwrites the paint as it grows, so the paint left untouched is the
+ * least free memory there has been since reset.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+#include <stdint.h>
+
+/**
+ * @brief Byte the free SRAM is painted with, unlikely to be pushed on the stack.
+ */
+#define MEMORY_PAINT 0xC5
+
+/**
+ * @brief Gets the least free SRAM there has been since reset.
+ * @return The number of bytes never reached by the stack, 0 on the host.
+ */
+uint16_t memory_free_min(void);
+
+/**
+ * @brief Gets the deepest the stack has been since reset.
+ * @return The number of bytes of the deepest stack, 0 on the host.
+ */
+uint16_t memory_stack_peak(void);
+
+#endif /* MEMORY_H */
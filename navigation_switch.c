@@ -12,6 +12,8 @@
 
 #include "navigation_switch.h"
 #include "navswitch.h"
+#include "input_trace.h"
+#include "bench.h"
 
 /**
  * @brief Get the current direction of the navigation switch.
@@ -19,31 +21,37 @@
  * This function updates the state of the navigation switch and returns the current
  * direction or state based on the input events. It checks if the navigation switch
  * is pushed in any direction or pressed, and returns the corresponding direction enum.
+ * The direction passes through the input trace, which records or replays it.
  *
  * @return Direction_t The current direction of the navigation switch.
  */
 Direction_t navigation_switch_get(void)
 {
+    Direction_t direction = DIR_NONE;
+
+    BENCH_BEGIN(BENCH_NAVIGATION_SWITCH);
     navswitch_update();
-    if (navswitch_push_event_p(NAVSWITCH_NORTH))      /* up */
+    if (navswitch_push_event_p(NAVSWITCH_NORTH) || BENCH_INPUT_TAKE(BENCH_INPUT_NORTH))      /* up */
     {
-        return DIR_NORTH;
+        direction = DIR_NORTH;
     }
-    else if (navswitch_push_event_p(NAVSWITCH_SOUTH)) /* down */
+    else if (navswitch_push_event_p(NAVSWITCH_SOUTH) || BENCH_INPUT_TAKE(BENCH_INPUT_SOUTH)) /* down */
     {
-        return DIR_SOUTH;
+        direction = DIR_SOUTH;
     }
-    else if (navswitch_push_event_p(NAVSWITCH_WEST))  /* left */
+    else if (navswitch_push_event_p(NAVSWITCH_WEST) || BENCH_INPUT_TAKE(BENCH_INPUT_WEST))   /* left */
     {
-        return DIR_WEST;
+        direction = DIR_WEST;
     }
-    else if (navswitch_push_event_p(NAVSWITCH_EAST))  /* right */
+    else if (navswitch_push_event_p(NAVSWITCH_EAST) || BENCH_INPUT_TAKE(BENCH_INPUT_EAST))   /* right */
     {
-        return DIR_EAST;
+        direction = DIR_EAST;
     }
-    else if (navswitch_push_event_p(NAVSWITCH_PUSH))  /* down */
+    else if (navswitch_push_event_p(NAVSWITCH_PUSH) || BENCH_INPUT_TAKE(BENCH_INPUT_PUSH))   /* down */
     {
-        return DIR_PUSHED;
+        direction = DIR_PUSHED;
     }
-    return DIR_NONE;
+    direction = input_trace_navswitch(direction);
+    BENCH_END(BENCH_NAVIGATION_SWITCH);
+    return direction;
 }
\ No newline at end of file
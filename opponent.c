@@ -0,0 +1,307 @@
+/**
+ * @file   opponent.c
+ * @brief  Implementation of the opponent the Battleship game plays against.
+ *
+ * Each function passes the call on to the IR link or the computer opponent,
+ * whichever was selected. A switch is used rather than a table of function
+ * pointers so nothing is copied into SRAM.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include "opponent.h"
+#include "ir.h"
+#include "ai.h"
+
+/** @brief Who the game is played against. */
+static Opponent_t opponent = OPPONENT_IR;
+
+/**
+ * @brief Selects who the game is played against.
+ *
+ * The computer forgets any game it was playing, so it is also stopped when a
+ * game over IR is selected.
+ *
+ * @param new_opponent The opponent to play against.
+ */
+void opponent_select(Opponent_t new_opponent)
+{
+    opponent = new_opponent;
+    ai_init();
+}
+
+/**
+ * @brief Gets who the game is played against.
+ *
+ * @return The selected opponent.
+ */
+Opponent_t opponent_get(void)
+{
+    return opponent;
+}
+
+/**
+ * @brief Checks if the opponent has stopped answering.
+ *
+ * @return true once the IR link has given up on a frame, the computer always answers.
+ */
+bool opponent_link_lost(void)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            return false;
+        default:
+            return ir_link_lost();
+    }
+}
+
+/**
+ * @brief Retrieves the tag committing to the opponent's board.
+ *
+ * @param tag Pointer to store the tag.
+ * @return true if a tag was received, false otherwise.
+ */
+bool opponent_get_their_commitment(CommitTag_t* tag)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            return ai_get_their_commitment(tag);
+        default:
+            return ir_get_their_commitment(tag);
+    }
+}
+
+/**
+ * @brief Sends the tag committing to our board to the opponent.
+ *
+ * @param tag The tag to send.
+ */
+void opponent_send_our_commitment(const CommitTag_t* tag)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            ai_send_our_commitment(tag);
+            break;
+        default:
+            ir_send_our_commitment(tag);
+            break;
+    }
+}
+
+/**
+ * @brief Retrieves the salt of the opponent's board.
+ *
+ * @param salt Pointer to store the salt.
+ * @return true if a salt was received, false otherwise.
+ */
+bool opponent_get_their_salt(CommitSalt_t* salt)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            return ai_get_their_salt(salt);
+        default:
+            return ir_get_their_salt(salt);
+    }
+}
+
+/**
+ * @brief Reveals the salt of our board to the opponent.
+ *
+ * @param salt The salt to send.
+ */
+void opponent_send_our_salt(const CommitSalt_t* salt)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            ai_send_our_salt(salt);
+            break;
+        default:
+            ir_send_our_salt(salt);
+            break;
+    }
+}
+
+/**
+ * @brief Retrieves the cell of the opponent's shot at our board.
+ *
+ * @param row Pointer to store the row index of the cell.
+ * @param col Pointer to store the column index of the cell.
+ * @return true if a shot was received, false otherwise.
+ */
+bool opponent_get_their_shot(uint8_t* row, uint8_t* col)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            return ai_get_their_shot(row, col);
+        default:
+            return ir_get_their_shot(row, col);
+    }
+}
+
+/**
+ * @brief Sends the cell of our shot to the opponent.
+ *
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ */
+void opponent_send_our_shot(uint8_t row, uint8_t col)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            ai_send_our_shot(row, col);
+            break;
+        default:
+            ir_send_our_shot(row, col);
+            break;
+    }
+}
+
+/**
+ * @brief Retrieves the opponent's predefined board ID, revealed once the game ends.
+ *
+ * @param id Pointer to store the board ID.
+ * @return true if a board ID was received, false otherwise.
+ */
+bool opponent_get_their_predefined_board_id(uint8_t* id)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            return ai_get_their_predefined_board_id(id);
+        default:
+            return ir_get_their_predefined_board_id(id);
+    }
+}
+
+/**
+ * @brief Reveals our predefined board ID to the opponent.
+ *
+ * @param id The predefined board ID to send.
+ */
+void opponent_send_our_predefined_board_id(uint8_t id)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            // the computer does not check our board
+            break;
+        default:
+            ir_send_our_predefined_board_id(id);
+            break;
+    }
+}
+
+/**
+ * @brief Retrieves the seed and fleet of the opponent's random board, revealed once the game ends.
+ *
+ * @param random_board Pointer to store the seed and fleet.
+ * @return true if a random board was received, false otherwise.
+ */
+bool opponent_get_their_random_board(RandomBoard_t* random_board)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            // the computer only chooses predefined boards
+            return false;
+        default:
+            return ir_get_their_random_board(random_board);
+    }
+}
+
+/**
+ * @brief Reveals the seed and fleet of our random board to the opponent.
+ *
+ * @param random_board The seed and fleet to send.
+ */
+void opponent_send_our_random_board(const RandomBoard_t* random_board)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            // the computer does not check our board
+            break;
+        default:
+            ir_send_our_random_board(random_board);
+            break;
+    }
+}
+
+/**
+ * @brief Retrieves the fleet layout code of the opponent's edited board, revealed once the game ends.
+ *
+ * @param code Pointer to store the code.
+ * @return true if an edited board was received, false otherwise.
+ */
+bool opponent_get_their_edited_board(uint32_t* code)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            // the computer only chooses predefined boards
+            return false;
+        default:
+            return ir_get_their_edited_board(code);
+    }
+}
+
+/**
+ * @brief Reveals the fleet layout code of our edited board to the opponent.
+ *
+ * @param code The code to send.
+ */
+void opponent_send_our_edited_board(uint32_t code)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            // the computer does not check our board
+            break;
+        default:
+            ir_send_our_edited_board(code);
+            break;
+    }
+}
+
+/**
+ * @brief Retrieves the opponent's turn state.
+ *
+ * @param response Pointer to store the turn state.
+ * @return true if a turn state was received, false otherwise.
+ */
+bool opponent_get_their_turn_state(BoardResponse_t* response)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            return ai_get_their_turn_state(response);
+        default:
+            return ir_get_their_turn_state(response);
+    }
+}
+
+/**
+ * @brief Sends our turn state to the opponent.
+ *
+ * @param response The board response to send.
+ */
+void opponent_send_our_turn_state(BoardResponse_t response)
+{
+    switch (opponent)
+    {
+        case OPPONENT_COMPUTER:
+            ai_send_our_turn_state(response);
+            break;
+        default:
+            ir_send_our_turn_state(response);
+            break;
+    }
+}
@@ -0,0 +1,144 @@
+/**
+ * @file   opponent.h
+ * @brief  Header of the opponent the Battleship game plays against.
+ *
+ * The game exchanges board commitments, shots and their answers with its
+ * opponent through these functions, then reveals the boards once the game
+ * ends, see commit.h. They pass each message on to the IR link for a second
+ * UCFK4 or to the computer opponent in ai.h for a single player game.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef OPPONENT_H
+#define OPPONENT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+#include "random_board.h"
+#include "commit.h"
+
+/**
+ * @enum  Opponent_t
+ * @brief Who the game is played against.
+ */
+typedef enum
+{
+    OPPONENT_IR,       /**< A second player on another UCFK4, over IR. */
+    OPPONENT_COMPUTER, /**< The computer opponent. */
+} Opponent_t;
+
+/**
+ * @brief Selects who the game is played against and starts the computer afresh.
+ * @param opponent The opponent to play against.
+ */
+void opponent_select(Opponent_t opponent);
+
+/**
+ * @brief  Gets who the game is played against.
+ * @return The selected opponent.
+ */
+Opponent_t opponent_get(void);
+
+/**
+ * @brief  Checks if the opponent has stopped answering, so the game cannot go on.
+ * @return true once the IR link has given up on a frame, never for the computer.
+ */
+bool opponent_link_lost(void);
+
+/**
+ * @brief Retrieves the tag committing to the opponent's board.
+ * @param tag Pointer to store the tag.
+ * @return true if a tag was received, false otherwise.
+ */
+bool opponent_get_their_commitment(CommitTag_t* tag);
+
+/**
+ * @brief Sends the tag committing to our board to the opponent.
+ * @param tag The tag to send.
+ */
+void opponent_send_our_commitment(const CommitTag_t* tag);
+
+/**
+ * @brief Retrieves the salt of the opponent's board, revealed once the game ends.
+ * @param salt Pointer to store the salt.
+ * @return true if a salt was received, false otherwise.
+ */
+bool opponent_get_their_salt(CommitSalt_t* salt);
+
+/**
+ * @brief Reveals the salt of our board to the opponent.
+ * @param salt The salt to send.
+ */
+void opponent_send_our_salt(const CommitSalt_t* salt);
+
+/**
+ * @brief Retrieves the cell of the opponent's shot at our board.
+ * @param row Pointer to store the row index of the cell.
+ * @param col Pointer to store the column index of the cell.
+ * @return true if a shot was received, false otherwise.
+ */
+bool opponent_get_their_shot(uint8_t* row, uint8_t* col);
+
+/**
+ * @brief Sends the cell of our shot to the opponent, who answers with their turn state.
+ * @param row The row index of the cell.
+ * @param col The column index of the cell.
+ */
+void opponent_send_our_shot(uint8_t row, uint8_t col);
+
+/**
+ * @brief Retrieves the opponent's predefined board ID, revealed once the game ends.
+ * @param id Pointer to store the board ID.
+ * @return true if a board ID was received, false otherwise.
+ */
+bool opponent_get_their_predefined_board_id(uint8_t* id);
+
+/**
+ * @brief Reveals our predefined board ID to the opponent.
+ * @param id The predefined board ID to send.
+ */
+void opponent_send_our_predefined_board_id(uint8_t id);
+
+/**
+ * @brief Retrieves the seed and fleet of the opponent's random board, revealed once the game ends.
+ * @param random_board Pointer to store the seed and fleet.
+ * @return true if a random board was received, false otherwise, the computer never sends one.
+ */
+bool opponent_get_their_random_board(RandomBoard_t* random_board);
+
+/**
+ * @brief Reveals the seed and fleet of our random board to the opponent.
+ * @param random_board The seed and fleet to send.
+ */
+void opponent_send_our_random_board(const RandomBoard_t* random_board);
+
+/**
+ * @brief Retrieves the fleet layout code of the opponent's edited board, revealed once the game ends.
+ * @param code Pointer to store the code.
+ * @return true if an edited board was received, false otherwise, the computer never sends one.
+ */
+bool opponent_get_their_edited_board(uint32_t* code);
+
+/**
+ * @brief Reveals the fleet layout code of our edited board to the opponent.
+ * @param code The code to send.
+ */
+void opponent_send_our_edited_board(uint32_t code);
+
+/**
+ * @brief Retrieves the opponent's turn state, their answer to our shot.
+ * @param response Pointer to store the turn state.
+ * @return true if a turn state was received, false otherwise.
+ */
+bool opponent_get_their_turn_state(BoardResponse_t* response);
+
+/**
+ * @brief Sends our turn state to the opponent, our answer to their shot.
+ * @param response The board response to send.
+ */
+void opponent_send_our_turn_state(BoardResponse_t response);
+
+#endif /* OPPONENT_H */
@@ -0,0 +1,249 @@
+/** 
+ * @file   power.c
+ * @brief  Implementation of the sleep and power accounting functions for the Battleship game.
+ *
+ * The UCFK4 pacer busy-waits on timer1 for the next tick. Instead the timer1
+ * compare A interrupt is set for the next tick and the MCU sleeps in idle
+ * mode until then, waking early only to move received IR bytes into the
+ * receive buffer.
+ *
+ * Timer1 stops when the MCU powers down, so powering down is only done when
+ * nothing is shown and the IR link is idle, which happens while waiting for
+ * the opponent's turn and once the game has ended. The IR receive pin is
+ * INT2, a low level on it wakes the MCU as a frame starts, and the watchdog
+ * wakes it every POWER_DOWN_MS in case that is missed.
+ *
+ * The time spent running ticks and sleeping between them is counted in timer
+ * counts for each game state, along with the ticks which overran their slot.
+ * Host builds do not sleep and only count ticks.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "system.h"
+#include "pacer.h"
+#include "timer.h"
+#include "power.h"
+#include "game.h"
+#include "screen.h"
+#include "ir.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <avr/wdt.h>
+#endif
+
+/** @brief Where the time in each game state went. */
+static PowerStats_t power_state_stats[POWER_STATES_NUM];
+
+/** @brief Number of ticks in a row the game has had nothing to do. */
+static uint16_t power_idle_ticks;
+
+/** @brief Whether the tick about to run started late. */
+static bool power_late;
+
+#ifdef __AVR__
+/** @brief Timer counts between ticks. */
+#define POWER_TICK_PERIOD ((timer_tick_t) (TIMER_RATE / PACER_RATE))
+
+/** @brief Timer count the next tick starts at. */
+static timer_tick_t power_next_tick;
+
+/** @brief Timer count the current tick started at. */
+static timer_tick_t power_tick_start;
+
+/**
+ * @brief Timer1 compare A interrupt, only wakes the MCU for the next tick.
+ */
+EMPTY_INTERRUPT(TIMER1_COMPA_vect);
+
+/**
+ * @brief INT2 interrupt, the IR receive pin went low while powered down.
+ *
+ * The interrupt is level triggered, so it disables itself until the next power down.
+ */
+ISR(INT2_vect)
+{
+    EIMSK &= ~BIT(INT2);
+}
+
+/**
+ * @brief Watchdog interrupt, wakes the MCU after POWER_DOWN_MS.
+ */
+EMPTY_INTERRUPT(WDT_vect);
+
+/**
+ * @brief Sleeps in idle mode until the timer reaches the next tick.
+ *
+ * Any interrupt wakes the MCU, so it sleeps again until the tick is due.
+ * Interrupts are disabled between checking the timer and sleeping, so the
+ * compare interrupt cannot be missed.
+ */
+static void power_sleep_idle(void)
+{
+    OCR1A = power_next_tick;
+    TIFR1 = BIT(OCF1A);
+    TIMSK1 |= BIT(OCIE1A);
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    for (;;)
+    {
+        cli();
+        if ((int16_t) (timer_get() - power_next_tick) >= 0)
+        {
+            sei();
+            break;
+        }
+        sleep_enable();
+        sei();
+        sleep_cpu();
+        sleep_disable();
+    }
+
+    TIMSK1 &= ~BIT(OCIE1A);
+}
+
+/**
+ * @brief Powers down until the IR receive pin goes low or the watchdog fires.
+ */
+static void power_sleep_down(void)
+{
+    // interrupt only watchdog, so it wakes the MCU without resetting it
+    cli();
+    wdt_reset();
+    WDTCSR = BIT(WDCE) | BIT(WDE);
+    WDTCSR = BIT(WDIE) | BIT(WDP2) | BIT(WDP0);
+
+    // a low level on INT2 is the only trigger which wakes a powered down MCU
+    EICRA &= ~(BIT(ISC21) | BIT(ISC20));
+    EIFR = BIT(INTF2);
+    EIMSK |= BIT(INT2);
+
+    set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+
+    cli();
+    EIMSK &= ~BIT(INT2);
+    wdt_reset();
+    MCUSR &= ~BIT(WDRF);
+    WDTCSR = BIT(WDCE) | BIT(WDE);
+    WDTCSR = 0;
+    sei();
+}
+#endif /* __AVR__ */
+
+/**
+ * @brief Checks if the game has nothing to do until something arrives.
+ *
+ * @return true if nothing is shown, the IR link is idle and no message scrolls.
+ */
+static bool power_game_idle(void)
+{
+    return screen_blank() && ir_idle();
+}
+
+/**
+ * @brief Initializes power accounting, this must be called after pacer_init().
+ */
+void power_init(void)
+{
+    for (uint8_t state = 0; state < POWER_STATES_NUM; state++)
+    {
+        power_state_stats[state] = (PowerStats_t) {0, 0, 0, 0, 0};
+    }
+    power_idle_ticks = 0;
+    power_late = false;
+
+#ifdef __AVR__
+    power_tick_start = timer_get();
+    power_next_tick = power_tick_start + POWER_TICK_PERIOD;
+#endif
+}
+
+/**
+ * @brief Sleeps until the next tick, powering down if the game has nothing to do.
+ *
+ * The tick just run is counted against the current game state, along with
+ * the time slept before the next one.
+ */
+void power_wait(void)
+{
+    PowerStats_t* stats = &power_state_stats[game_get_state()];
+    stats->ticks++;
+
+    if (power_game_idle())
+    {
+        if (power_idle_ticks != UINT16_MAX)
+        {
+            power_idle_ticks++;
+        }
+    }
+    else
+    {
+        power_idle_ticks = 0;
+    }
+
+#ifdef __AVR__
+    timer_tick_t now = timer_get();
+    stats->active += (timer_tick_t) (now - power_tick_start);
+
+    if (power_idle_ticks >= POWER_IDLE_TICKS)
+    {
+        stats->power_downs++;
+        power_sleep_down();
+        // timer1 stopped while powered down, so count ticks from now
+        power_idle_ticks = 0;
+        power_late = false;
+        power_tick_start = timer_get();
+        power_next_tick = power_tick_start + POWER_TICK_PERIOD;
+        return;
+    }
+
+    power_late = (int16_t) (now - power_next_tick) >= 0;
+    if (power_late)
+    {
+        if (stats->overruns != UINT16_MAX)
+        {
+            stats->overruns++;
+        }
+    }
+    else
+    {
+        power_sleep_idle();
+        stats->sleep += (timer_tick_t) (timer_get() - now);
+    }
+    power_tick_start = timer_get();
+    power_next_tick += POWER_TICK_PERIOD;
+#else
+    pacer_wait();
+#endif
+}
+
+/**
+ * @brief Checks if the tick about to run started late because the last one overran.
+ *
+ * @return true if the tick started late, always false on the host.
+ */
+bool power_tick_late(void)
+{
+    return power_late;
+}
+
+/**
+ * @brief Gets where the time in a game state went.
+ *
+ * @param state The game state.
+ * @return The statistics of the state.
+ */
+const PowerStats_t* power_stats(GameState_t state)
+{
+    return &power_state_stats[state];
+}
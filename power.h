@@ -0,0 +1,79 @@
+/** 
+ * @file   power.h
+ * @brief  Header of the sleep and power accounting functions for the Battleship game.
+ *
+ * power_wait() replaces pacer_wait() in the game loop. Between ticks the MCU
+ * sleeps in idle mode, which keeps the timer and USART1 running, until the
+ * timer reaches the next tick. Once the game has had nothing to do for
+ * POWER_IDLE_TICKS it powers down instead, waking when the IR receive pin
+ * goes low or after POWER_DOWN_MS.
+ *
+ * A tick which is still running when the next should start has overrun, it
+ * is counted and the next tick is reported late so it can shed work.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef POWER_H
+#define POWER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "game_state.h"
+
+/**
+ * @brief Number of game states power is accounted for.
+ */
+#define POWER_STATES_NUM (GAME_STATE_END + 1)
+
+/**
+ * @brief Ticks the game must have nothing to do before the MCU powers down.
+ *
+ * The first IR byte after powering down is lost while the clock starts, this
+ * is longer than the opponent takes to send the frame again.
+ */
+#define POWER_IDLE_TICKS 250
+
+/**
+ * @brief Longest time the MCU stays powered down, in milliseconds.
+ */
+#define POWER_DOWN_MS 500
+
+/**
+ * @struct PowerStats_t
+ * @brief  Where the time in one game state went.
+ */
+typedef struct
+{
+    uint32_t ticks;       /**< Number of ticks run in the state. */
+    uint32_t active;      /**< Timer counts spent running ticks. */
+    uint32_t sleep;       /**< Timer counts spent in idle sleep between ticks. */
+    uint16_t power_downs; /**< Number of times the MCU powered down. */
+    uint16_t overruns;    /**< Number of ticks which ran past the start of the next. */
+} PowerStats_t;
+
+/**
+ * @brief Initializes power accounting, this must be called after pacer_init().
+ */
+void power_init(void);
+
+/**
+ * @brief Sleeps until the next tick, powering down if the game has nothing to do.
+ */
+void power_wait(void);
+
+/**
+ * @brief Checks if the tick about to run started late because the last one overran.
+ * @return true if the tick started late.
+ */
+bool power_tick_late(void);
+
+/**
+ * @brief Gets where the time in a game state went.
+ * @param state The game state.
+ * @return The statistics of the state.
+ */
+const PowerStats_t* power_stats(GameState_t state);
+
+#endif /* POWER_H */
@@ -3,107 +3,105 @@
  * @brief  Implementation of predefined board configurations for the Battleship game.
  *
  * This file contains the implementation of predefined board configurations used
- * in the Battleship game. Each board configuration is defined as a constant and
- * can be referenced throughout the game to set up different board layouts. The
- * file also includes an array of pointers to these board configurations and a
- * count of the total number of boards available.
+ * in the Battleship game. The board configurations are stored in program memory
+ * rather than being copied into SRAM at startup, so they can only be read through
+ * predefined_board_read() which copies a single board out of flash when needed.
  *
  * @date   17/10/2024
  * @author Corey Hines, Ethan Field
  */
 
+#include <avr/pgmspace.h>
 #include "predefined_boards.h"
 #include "board.h"
 
 /**
- * @brief Represents a predefined board configuration of ID 0.
- * @note This board contains 2 ship cells and should only be used for testing.
+ * @brief Array of predefined board configurations, indexed by board ID.
  */
-const PredefinedBoard_t BOARD_0 = {
-    0b00000,
-    0b00000,
-    0b00000,
-    0b01010,
-    0b00000,
-    0b00000,
-    0b00000};
+static const PredefinedBoard_t PREDEFINED_BOARDS[] PROGMEM = {
+    /* ID 0, contains 2 ship cells and should only be used for testing */
+    {0b00000,
+     0b00000,
+     0b00000,
+     0b01010,
+     0b00000,
+     0b00000,
+     0b00000},
+    /* ID 1 */
+    {0b00110,
+     0b11000,
+     0b00001,
+     0b00001,
+     0b11101,
+     0b00000,
+     0b01100},
+    /* ID 2 */
+    {0b10111,
+     0b10000,
+     0b00110,
+     0b01000,
+     0b01011,
+     0b01000,
+     0b00000},
+    /* ID 3 */
+    {0b00001,
+     0b10001,
+     0b10101,
+     0b10100,
+     0b00011,
+     0b00000,
+     0b11000},
+    /* ID 4 */
+    {0b01010,
+     0b01010,
+     0b00010,
+     0b11000,
+     0b00111,
+     0b00000,
+     0b11000},
+    /* ID 5 */
+    {0b10001,
+     0b10001,
+     0b00001,
+     0b00011,
+     0b01100,
+     0b00000,
+     0b00111}};
 
 /**
- * @brief Represents a predefined board configuration of ID 1.
- */
-const PredefinedBoard_t BOARD_1 = {
-    0b00110,
-    0b11000,
-    0b00001,
-    0b00001,
-    0b11101,
-    0b00000,
-    0b01100};
-
-/**
- * @brief Represents a predefined board configuration of ID 2.
- */
-const PredefinedBoard_t BOARD_2 = {
-    0b10111,
-    0b10000,
-    0b00110,
-    0b01000,
-    0b01011,
-    0b01000,
-    0b00000};
-
-/**
- * @brief Represents a predefined board configuration of ID 3.
- */
-const PredefinedBoard_t BOARD_3 = {
-    0b00001,
-    0b10001,
-    0b10101,
-    0b10100,
-    0b00011,
-    0b00000,
-    0b11000};
-
-/**
- * @brief Represents a predefined board configuration of ID 4.
- */
-const PredefinedBoard_t BOARD_4 = {
-    0b01010,
-    0b01010,
-    0b00010,
-    0b11000,
-    0b00111,
-    0b00000,
-    0b11000};
-
-/**
- * @brief Represents a predefined board configuration of ID 5.
+ * @brief Total number of predefined boards available.
+ * 
+ * This is calculated at compile time by dividing the size of the
+ * predefined boards array by the size of a single board.
  */
-const PredefinedBoard_t BOARD_5 = {
-    0b10001,
-    0b10001,
-    0b00001,
-    0b00011,
-    0b01100,
-    0b00000,
-    0b00111};
+#define NUM_BOARDS (sizeof(PREDEFINED_BOARDS) / sizeof(PredefinedBoard_t))
 
 /**
- * @brief Array of pointers to predefined board configurations.
+ * @brief Gets the total number of predefined boards available.
+ *
+ * @return The number of predefined boards.
  */
-const PredefinedBoard_t *PREDEFINED_BOARDS[] = {
-    &BOARD_0,
-    &BOARD_1,
-    &BOARD_2,
-    &BOARD_3,
-    &BOARD_4,
-    &BOARD_5};
+uint8_t predefined_board_count(void)
+{
+    return NUM_BOARDS;
+}
 
 /**
- * @brief Total number of predefined boards available.
- * 
- * This is calculated dynamically by dividing the size of the
- * predefined boards array (which is an array of pointers) by
- * the size of a pointer.
+ * @brief Copies a predefined board configuration out of program memory.
+ *
+ * This function checks the ID is in range before copying the board, so an
+ * ID received from the other player can be passed straight in.
+ *
+ * @param id The ID of the predefined board.
+ * @param board The board to copy the configuration into.
+ * @return true if the ID refers to a predefined board, false otherwise.
  */
-const uint8_t NUM_BOARDS = sizeof(PREDEFINED_BOARDS) / sizeof(PredefinedBoard_t *);
+bool predefined_board_read(uint8_t id, PredefinedBoard_t* board)
+{
+    if (id >= NUM_BOARDS)
+    {
+        return false;
+    }
+    memcpy_P(board, &PREDEFINED_BOARDS[id], sizeof(PredefinedBoard_t));
+    return true;
+}
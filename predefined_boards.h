@@ -9,47 +9,25 @@
 #define PREDEFINED_BOARDS_H
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "board.h"
 
-/**
- * @brief Represents a predefined board configuration of ID 0.
- * @note This board contains 2 ship cells and should only be used for testing.
- */
-extern const PredefinedBoard_t BOARD_0;
-
-/**
- * @brief Represents a predefined board configuration of ID 1.
- */
-extern const PredefinedBoard_t BOARD_1;
-
-/**
- * @brief Represents a predefined board configuration of ID 2.
- */
-extern const PredefinedBoard_t BOARD_2;
-
-/**
- * @brief Represents a predefined board configuration of ID 3.
- */
-extern const PredefinedBoard_t BOARD_3;
-
-/**
- * @brief Represents a predefined board configuration of ID 4.
- */
-extern const PredefinedBoard_t BOARD_4;
-
-/**
- * @brief Represents a predefined board configuration of ID 5.
- */
-extern const PredefinedBoard_t BOARD_5;
+/* the predefined boards are kept in program memory so they do not use any
+   SRAM, they can only be read through predefined_board_read() */
 
 /**
- * @brief Array of pointers to predefined board configurations.
+ * @brief  Gets the total number of predefined boards available.
+ * @return The number of predefined boards.
  */
-extern const PredefinedBoard_t* PREDEFINED_BOARDS[];
+uint8_t predefined_board_count(void);
 
 /**
- * @brief Total number of predefined boards available.
+ * @brief  Copies a predefined board configuration out of program memory.
+ * @param  id: The ID of the predefined board, board 0 contains 2 ship cells and
+ *         should only be used for testing.
+ * @param  board: The board to copy the configuration into.
+ * @return true if the ID refers to a predefined board, false otherwise.
  */
-extern const uint8_t NUM_BOARDS;
+bool predefined_board_read(uint8_t id, PredefinedBoard_t* board);
 
 #endif /* PREDEFINED_BOARDS_H */
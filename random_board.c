@@ -0,0 +1,212 @@
+/**
+ * @file   random_board.c
+ * @brief  Implementation of the random boards for the Battleship game.
+ *
+ * The placements are found in the packed row layout of board.h, as the
+ * computer opponent's search does. For a ship of length n, the cells a
+ * placement across a row can start on are the open cells of the row and'ed
+ * with the row shifted 1 to n - 1 columns, and the cells a placement down can
+ * start on are the open cells of n rows and'ed together. A board takes a few
+ * operations per row for each ship, well inside a tick.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "random_board.h"
+#include "board.h"
+#include "timer.h"
+#include "input_trace.h"
+
+/** @brief Longest ship a packed fleet holds. */
+#define RANDOM_SHIP_LENGTH_MAX 4
+
+/** @brief State of the generator choosing new seeds. */
+static uint16_t random_board_seed_state = 1;
+
+/**
+ * @brief Generates the next pseudo random number with xorshift.
+ *
+ * @param state The generator's state, never 0.
+ * @return The next number.
+ */
+static uint16_t random_board_next(uint16_t* state)
+{
+    *state ^= *state << 7;
+    *state ^= *state >> 9;
+    *state ^= *state << 8;
+    return *state;
+}
+
+/**
+ * @brief Counts the cells of a packed row.
+ *
+ * @param cells The packed row.
+ * @return The number of cells.
+ */
+static uint8_t random_board_cells_num(uint8_t cells)
+{
+    uint8_t count = 0;
+
+    for (; cells != 0; cells &= (uint8_t) (cells - 1))
+    {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * @brief Finds the cells of each row a placement of a ship can start on.
+ *
+ * @param open The cells of each row the ship may cover.
+ * @param length The length of the ship.
+ * @param across Set to the leftmost cells of the placements across each row.
+ * @param down Set to the top cells of the placements down from each row.
+ * @return The number of placements.
+ */
+static uint8_t random_board_starts(const PredefinedBoard_t* open, uint8_t length, PredefinedBoard_t* across,
+                                   PredefinedBoard_t* down)
+{
+    uint8_t count = 0;
+
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        uint8_t starts_across = (*open)[row];
+        uint8_t starts_down = row + length <= BOARD_ROWS_NUM ? (*open)[row] : 0;
+        for (uint8_t k = 1; k < length; k++)
+        {
+            starts_across &= (uint8_t) ((*open)[row] << k);
+            starts_down &= row + k < BOARD_ROWS_NUM ? (*open)[row + k] : 0;
+        }
+        (*across)[row] = starts_across & BOARD_ROW_MASK;
+        (*down)[row] = starts_down;
+        count += random_board_cells_num((*across)[row]) + random_board_cells_num(starts_down);
+    }
+    return count;
+}
+
+/**
+ * @brief Places a ship at one of its placements, chosen at random.
+ *
+ * @param ships The ships placed so far, the ship is added to them.
+ * @param length The length of the ship.
+ * @param apart true if ships may not be side by side or end to end.
+ * @param state The generator's state.
+ * @return true if the ship was placed, false if it had nowhere to go.
+ */
+static bool random_board_place(PredefinedBoard_t* ships, uint8_t length, bool apart, uint16_t* state)
+{
+    PredefinedBoard_t open;
+    PredefinedBoard_t across;
+    PredefinedBoard_t down;
+
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        open[row] = BOARD_ROW_MASK & ~board_blocked_cells(ships, row, apart);
+    }
+    uint8_t count = random_board_starts(&open, length, &across, &down);
+    if (count == 0)
+    {
+        return false;
+    }
+
+    // walk the placements across then down, row by row, to the one chosen
+    uint8_t chosen = random_board_next(state) % count;
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        {
+            if ((across[row] & BOARD_COL_MASK(col)) && chosen-- == 0)
+            {
+                (*ships)[row] |= (uint8_t) (((1 << length) - 1) << (BOARD_COLS_NUM - length - col));
+                return true;
+            }
+        }
+    }
+    for (uint8_t row = 0; row < BOARD_ROWS_NUM; row++)
+    {
+        for (uint8_t col = 0; col < BOARD_COLS_NUM; col++)
+        {
+            if ((down[row] & BOARD_COL_MASK(col)) && chosen-- == 0)
+            {
+                for (uint8_t k = 0; k < length; k++)
+                {
+                    (*ships)[row + k] |= BOARD_COL_MASK(col);
+                }
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Generates a board from its seed and fleet.
+ *
+ * The generator is seeded with the seed, or 1 for seed 0 which xorshift
+ * cannot start from, and carries on from one attempt to the next, so both
+ * players place the same ships in the same order.
+ *
+ * @param random_board The seed and fleet.
+ * @param board The board to fill with every ship's cells.
+ * @return true if every ship was placed, false if the fleet does not fit or the seed is given up on.
+ */
+bool random_board_generate(const RandomBoard_t* random_board, PredefinedBoard_t* board)
+{
+    uint8_t fleet = random_board->fleet;
+    uint8_t ships_of_length[RANDOM_SHIP_LENGTH_MAX + 1] = {
+        0, 0, RANDOM_FLEET_TWOS(fleet), RANDOM_FLEET_THREES(fleet), RANDOM_FLEET_FOURS(fleet),
+    };
+    uint16_t state = random_board->seed != 0 ? random_board->seed : 1;
+
+    if (ships_of_length[2] + ships_of_length[3] + ships_of_length[4] == 0)
+    {
+        return false;
+    }
+
+    for (uint8_t attempt = 0; attempt < RANDOM_BOARD_ATTEMPTS; attempt++)
+    {
+        bool placed = true;
+        memset(*board, 0, sizeof(*board));
+        for (uint8_t length = RANDOM_SHIP_LENGTH_MAX; placed && length >= 2; length--)
+        {
+            for (uint8_t ship = 0; placed && ship < ships_of_length[length]; ship++)
+            {
+                placed = random_board_place(board, length, RANDOM_FLEET_APART(fleet), &state);
+            }
+        }
+        if (placed)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Chooses a new random board of RANDOM_BOARD_FLEET, one which generates.
+ *
+ * The timer read depends on when the player asked for the board, so it is
+ * mixed into the generator choosing the seeds.
+ *
+ * @param random_board The seed and fleet to set.
+ * @param board The board to fill with every ship's cells.
+ */
+void random_board_choose(RandomBoard_t* random_board, PredefinedBoard_t* board)
+{
+    // replay needs the same timer read to choose the same seed
+    random_board_seed_state ^= input_trace_timer(timer_get());
+    if (random_board_seed_state == 0)
+    {
+        random_board_seed_state = 1;
+    }
+
+    random_board->fleet = RANDOM_BOARD_FLEET;
+    do
+    {
+        random_board->seed = random_board_next(&random_board_seed_state);
+    } while (!random_board_generate(random_board, board));
+}
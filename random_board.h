@@ -0,0 +1,85 @@
+/**
+ * @file   random_board.h
+ * @brief  Header of the random boards for the Battleship game, generated from a seed.
+ *
+ * A random board is given by a seed and a fleet. The same seed and fleet
+ * always generate the same board, so only those three bytes are sent to the
+ * opponent, which generates the board again rather than receiving it.
+ *
+ * The fleet packs the number of ships of each length and whether ships may
+ * touch into a byte, see RANDOM_FLEET(). The ships are placed longest first,
+ * each at one of the placements left open by the ships before it, chosen at
+ * random. When a ship has nowhere left to go the board is started again,
+ * at most RANDOM_BOARD_ATTEMPTS times.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef RANDOM_BOARD_H
+#define RANDOM_BOARD_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "board.h"
+
+/**
+ * @brief Packs a fleet into a byte.
+ *
+ * @param twos Ships of length 2, 0 to 7.
+ * @param threes Ships of length 3, 0 to 7.
+ * @param fours Ships of length 4, 0 or 1.
+ * @param apart true if no two ships may be side by side or end to end, they may still touch at a corner.
+ */
+#define RANDOM_FLEET(twos, threes, fours, apart) \
+    ((uint8_t) ((twos) | ((threes) << 3) | ((fours) << 6) | ((apart) ? 0x80 : 0)))
+
+#define RANDOM_FLEET_TWOS(fleet) ((fleet) & 0x07)           // Ships of length 2 in a packed fleet
+#define RANDOM_FLEET_THREES(fleet) (((fleet) >> 3) & 0x07)  // Ships of length 3 in a packed fleet
+#define RANDOM_FLEET_FOURS(fleet) (((fleet) >> 6) & 0x01)   // Ships of length 4 in a packed fleet
+#define RANDOM_FLEET_APART(fleet) (((fleet) & 0x80) != 0)   // Whether ships of a packed fleet are kept apart
+
+/**
+ * @brief The fleet of the random boards the player chooses, the ships of predefined boards 1 to 5 kept apart.
+ */
+#define RANDOM_BOARD_FLEET RANDOM_FLEET(3, 2, 0, true)
+
+/**
+ * @brief Times a board is started again before the seed is given up on.
+ *
+ * A ship of RANDOM_BOARD_FLEET has nowhere left to go in about 1 in 25
+ * boards, so 8 attempts all fail in fewer than 1 in 10^11 seeds.
+ */
+#define RANDOM_BOARD_ATTEMPTS 8
+
+/**
+ * @brief Board ID recorded for a random board, one no predefined board has.
+ */
+#define RANDOM_BOARD_ID 0xFF
+
+/**
+ * @struct RandomBoard_t
+ * @brief  The seed and fleet which generate a random board.
+ */
+typedef struct
+{
+    uint16_t seed; /**< Seed of the generator placing the ships. */
+    uint8_t fleet; /**< The fleet, packed with RANDOM_FLEET(). */
+} RandomBoard_t;
+
+/**
+ * @brief  Generates a board from its seed and fleet.
+ * @param  random_board: The seed and fleet.
+ * @param  board: The board to fill with every ship's cells.
+ * @return true if every ship was placed, false if the fleet does not fit or the seed is given up on.
+ */
+bool random_board_generate(const RandomBoard_t* random_board, PredefinedBoard_t* board);
+
+/**
+ * @brief  Chooses a new random board of RANDOM_BOARD_FLEET, one which generates.
+ * @param  random_board: The seed and fleet to set.
+ * @param  board: The board to fill with every ship's cells.
+ */
+void random_board_choose(RandomBoard_t* random_board, PredefinedBoard_t* board);
+
+#endif /* RANDOM_BOARD_H */
@@ -0,0 +1,254 @@
+/** 
+ * @file   scheduler.c
+ * @brief  Implementation of the cooperative task scheduler for the Battleship game.
+ *
+ * This file contains the implementation of the scheduler which runs the
+ * game's periodic tasks from a table. Each task records its period, phase
+ * and the tick it is next due, so a tick only calls the tasks which are due
+ * instead of every function counting ticks for itself. It also steps the
+ * running job after the tasks of each tick.
+ *
+ * @date   17/10/2024
+ * @author Corey Hines
+ */
+
+#include <stddef.h>
+#include "scheduler.h"
+
+/** @brief The table of tasks being scheduled. */
+static SchedulerTask_t* scheduler_tasks = NULL;
+
+/** @brief The number of tasks in the table. */
+static uint8_t scheduler_tasks_num = 0;
+
+/** @brief The number of ticks run since scheduler_init(). */
+static uint32_t scheduler_tick = 0;
+
+/** @brief The most tasks run in a single tick. */
+static uint8_t scheduler_run_max = 0;
+
+/** @brief The number of times a due task was put off because its tick started late. */
+static uint16_t scheduler_shed = 0;
+
+/** @brief The job being stepped each tick, NULL when there is none. */
+static SchedulerJob_t* scheduler_job = NULL;
+
+/**
+ * @brief Checks if a task is due this tick.
+ *
+ * The difference is taken as signed so the check keeps working when the
+ * tick count wraps.
+ *
+ * @param task The task to check.
+ * @return true if the task is enabled and due.
+ */
+static bool scheduler_task_due(const SchedulerTask_t* task)
+{
+    return task->enabled && (int32_t) (scheduler_tick - task->next_due) >= 0;
+}
+
+/**
+ * @brief Initializes the scheduler with a table of tasks.
+ *
+ * @param tasks The table of tasks, which must outlive the scheduler.
+ * @param tasks_num The number of tasks in the table.
+ */
+void scheduler_init(SchedulerTask_t* tasks, uint8_t tasks_num)
+{
+    scheduler_tasks = tasks;
+    scheduler_tasks_num = tasks_num;
+    scheduler_tick = 0;
+    scheduler_run_max = 0;
+    scheduler_shed = 0;
+    scheduler_job = NULL;
+
+    for (uint8_t i = 0; i < tasks_num; i++)
+    {
+        tasks[i].next_due = tasks[i].phase;
+    }
+}
+
+/**
+ * @brief Runs a slice of the running job.
+ *
+ * Steps are run until the job finishes or its budget of timer counts has
+ * passed since the slice started, always at least one so every job gets on.
+ */
+static void scheduler_job_slice(void)
+{
+    SchedulerJob_t* job = scheduler_job;
+    timer_tick_t start = timer_get();
+
+    BENCH_BEGIN(BENCH_JOB);
+    do
+    {
+        job->steps++;
+        if (job->step(job->state))
+        {
+            job->status = SCHEDULER_JOB_FINISHED;
+            scheduler_job = NULL;
+            break;
+        }
+    } while ((timer_tick_t) (timer_get() - start) < job->budget);
+    BENCH_END(BENCH_JOB);
+}
+
+/**
+ * @brief Runs the tasks which are due this tick and a slice of the running job, then advances the tick count.
+ *
+ * Tasks run in table order, a task enabled by an earlier task in the same
+ * tick is not run until its phase has passed. A sheddable task which is due
+ * in a late tick stays due, so it runs in the next tick which is on time.
+ * The job is shed in the same way, a late tick does not step it.
+ *
+ * @param late true if the tick started late, sheddable tasks are then put off.
+ * @return The number of tasks run.
+ */
+uint8_t scheduler_run(bool late)
+{
+    uint8_t run = 0;
+
+    for (uint8_t i = 0; i < scheduler_tasks_num; i++)
+    {
+        SchedulerTask_t* task = &scheduler_tasks[i];
+        if (scheduler_task_due(task))
+        {
+            if (late && task->sheddable)
+            {
+                if (scheduler_shed != UINT16_MAX)
+                {
+                    scheduler_shed++;
+                }
+                continue;
+            }
+            task->next_due += task->period;
+            if (scheduler_task_due(task))
+            {
+                // runs put off by late ticks are dropped rather than caught up
+                task->next_due = scheduler_tick + task->period;
+            }
+            BENCH_BEGIN(task->bench);
+            task->function();
+            BENCH_END(task->bench);
+            run++;
+        }
+    }
+
+    if (scheduler_job != NULL)
+    {
+        if (!late)
+        {
+            scheduler_job_slice();
+        }
+        else if (scheduler_shed != UINT16_MAX)
+        {
+            scheduler_shed++;
+        }
+    }
+
+    if (run > scheduler_run_max)
+    {
+        scheduler_run_max = run;
+    }
+    scheduler_tick++;
+    return run;
+}
+
+/**
+ * @brief Enables or disables a task.
+ *
+ * @param task The index of the task in the table.
+ * @param enabled true to run the task, false to stop running it.
+ */
+void scheduler_task_enable(uint8_t task, bool enabled)
+{
+    if (task >= scheduler_tasks_num)
+    {
+        return;
+    }
+
+    if (enabled && !scheduler_tasks[task].enabled)
+    {
+        // the current tick may be partway through being run, so the phase
+        // counts from the next one
+        scheduler_tasks[task].next_due = scheduler_tick + 1 + scheduler_tasks[task].phase;
+    }
+    scheduler_tasks[task].enabled = enabled;
+}
+
+/**
+ * @brief Starts a job from its first step.
+ *
+ * @param job The job, which must outlive its run.
+ */
+void scheduler_job_start(SchedulerJob_t* job)
+{
+    scheduler_job_cancel();
+    job->steps = 0;
+    job->status = SCHEDULER_JOB_RUNNING;
+    scheduler_job = job;
+}
+
+/**
+ * @brief Stops the running job before it finishes, leaving it idle.
+ */
+void scheduler_job_cancel(void)
+{
+    if (scheduler_job != NULL)
+    {
+        scheduler_job->status = SCHEDULER_JOB_IDLE;
+        scheduler_job = NULL;
+    }
+}
+
+/**
+ * @brief Gets how far through a job is.
+ *
+ * A job which does not know its steps_total, or runs over it, stays at 99
+ * until it finishes.
+ *
+ * @param job The job.
+ * @return The percentage of steps_total run, 100 once it has finished.
+ */
+uint8_t scheduler_job_progress(const SchedulerJob_t* job)
+{
+    if (job->status == SCHEDULER_JOB_FINISHED)
+    {
+        return 100;
+    }
+    if (job->steps >= job->steps_total)
+    {
+        return job->steps ? 99 : 0;
+    }
+    return (uint8_t) ((uint32_t) job->steps * 100 / job->steps_total);
+}
+
+/**
+ * @brief Gets the number of ticks run since scheduler_init().
+ *
+ * @return The tick count.
+ */
+uint32_t scheduler_ticks(void)
+{
+    return scheduler_tick;
+}
+
+/**
+ * @brief Gets the most tasks run in a single tick since scheduler_init().
+ *
+ * @return The largest number of tasks run in one tick.
+ */
+uint8_t scheduler_tasks_run_max(void)
+{
+    return scheduler_run_max;
+}
+
+/**
+ * @brief Gets the number of times a due task was put off because its tick started late.
+ *
+ * @return The number of tasks shed since scheduler_init().
+ */
+uint16_t scheduler_tasks_shed(void)
+{
+    return scheduler_shed;
+}
@@ -0,0 +1,150 @@
+/** 
+ * @file   scheduler.h
+ * @brief  Header of the cooperative task scheduler for the Battleship game.
+ *
+ * The game's periodic work is kept in a table of tasks, each run every
+ * period ticks starting phase ticks after it is enabled. scheduler_run() is
+ * called once per pacer tick and runs only the tasks which are due, in table
+ * order, so the table is the one place per-tick work is set and measured.
+ *
+ * When a tick starts late, because the one before it overran, tasks marked
+ * sheddable are put off until a tick which starts on time.
+ *
+ * Work too long for one tick is run as a job instead: its state is kept in a
+ * struct and a step function carries it on a small piece at a time. After the
+ * tasks of each tick, the running job is stepped until its budget of timer
+ * counts is spent, so the screen is still refreshed every tick while it runs.
+ *
+ * @author Corey Hines
+ * @date   17/10/2024
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "timer.h"
+#include "bench.h"
+
+/**
+ * @brief A function run by a scheduled task.
+ */
+typedef void (*SchedulerFunction_t)(void);
+
+/**
+ * @struct SchedulerTask_t
+ * @brief  A periodic task in the scheduler's table.
+ */
+typedef struct
+{
+    SchedulerFunction_t function; /**< The function to run. */
+    uint16_t period;              /**< Ticks between runs, 1 runs the task every tick. */
+    uint16_t phase;               /**< Ticks after being enabled before the first run. */
+    uint32_t next_due;            /**< Tick of the next run, set by the scheduler. */
+    bool enabled;                 /**< Whether the task runs. */
+    bool sheddable;               /**< Whether the task is put off when the tick starts late. */
+    BenchPoint_t bench;           /**< The benchmark point measuring the task. */
+} SchedulerTask_t;
+
+/**
+ * @brief Runs one step of a job, a piece of work short enough to leave the tick on time.
+ * @param state The job's state, which holds everything the next step needs.
+ * @return true once the job has finished.
+ */
+typedef bool (*SchedulerJobStep_t)(void* state);
+
+/**
+ * @enum  SchedulerJobStatus_t
+ * @brief Where a job is up to.
+ */
+typedef enum
+{
+    SCHEDULER_JOB_IDLE,     /**< Not started, or cancelled. */
+    SCHEDULER_JOB_RUNNING,  /**< Started and being stepped each tick. */
+    SCHEDULER_JOB_FINISHED, /**< Its last step has run. */
+} SchedulerJobStatus_t;
+
+/**
+ * @struct SchedulerJob_t
+ * @brief  A resumable job, stepped a slice at a time after each tick's tasks.
+ */
+typedef struct
+{
+    SchedulerJobStep_t step;     /**< Runs one step of the job. */
+    void* state;                 /**< The job's state, passed to every step. */
+    timer_tick_t budget;         /**< Timer counts each slice may take, at least one step is run per slice. */
+    uint16_t steps_total;        /**< Steps the job takes to finish, 0 if not known, for its progress. */
+    uint16_t steps;              /**< Steps run since it was started, set by the scheduler. */
+    SchedulerJobStatus_t status; /**< Where the job is up to, set by the scheduler. */
+} SchedulerJob_t;
+
+/**
+ * @brief Initializes the scheduler with a table of tasks.
+ *
+ * The tick count restarts at zero and every enabled task is first run after its phase.
+ *
+ * @param tasks The table of tasks, which must outlive the scheduler.
+ * @param tasks_num The number of tasks in the table.
+ */
+void scheduler_init(SchedulerTask_t* tasks, uint8_t tasks_num);
+
+/**
+ * @brief Runs the tasks which are due this tick, then advances the tick count.
+ * @param late true if the tick started late, sheddable tasks are then put off.
+ * @return The number of tasks run.
+ */
+uint8_t scheduler_run(bool late);
+
+/**
+ * @brief Enables or disables a task.
+ *
+ * An enabled task is first run after its phase, counted from this tick.
+ * Enabling a task which is already enabled does not move its next run.
+ *
+ * @param task The index of the task in the table.
+ * @param enabled true to run the task, false to stop running it.
+ */
+void scheduler_task_enable(uint8_t task, bool enabled);
+
+/**
+ * @brief Starts a job from its first step, it is first stepped after the tasks of this tick.
+ *
+ * Only one job runs at a time, a job which was already running is cancelled.
+ * The caller sets up the job's state before starting it.
+ *
+ * @param job The job, which must outlive its run.
+ */
+void scheduler_job_start(SchedulerJob_t* job);
+
+/**
+ * @brief Stops the running job before it finishes, leaving it idle.
+ */
+void scheduler_job_cancel(void);
+
+/**
+ * @brief  Gets how far through a job is.
+ * @param  job The job.
+ * @return The percentage of steps_total run, 100 once it has finished.
+ */
+uint8_t scheduler_job_progress(const SchedulerJob_t* job);
+
+/**
+ * @brief Gets the number of ticks run since scheduler_init().
+ * @return The tick count.
+ */
+uint32_t scheduler_ticks(void);
+
+/**
+ * @brief Gets the most tasks run in a single tick since scheduler_init().
+ * @return The largest number of tasks run in one tick.
+ */
+uint8_t scheduler_tasks_run_max(void);
+
+/**
+ * @brief Gets the number of times a due task was put off because its tick started late.
+ * @return The number of tasks shed since scheduler_init().
+ */
+uint16_t scheduler_tasks_shed(void);
+
+#endif /* SCHEDULER_H */
@@ -4,7 +4,23 @@
  * 
  * This file contains the function implementations for managing and updating the
  * LED matrix display, including displaying scrolling messages, single characters,
- * predefined boards, and individual pixels.
+ * predefined boards, and the layers drawn while selecting a shot.
+ * 
+ * The game draws into layers which are kept packed like a predefined board,
+ * from the board at the bottom to the text at the top. Every cell a layer
+ * changes is marked dirty, and screen_update() composites only the dirty
+ * cells into tinygl, so a tick which changes nothing costs almost nothing.
+ * A layer owns the cells it has set, when it is hidden those cells are off
+ * whatever the layers beneath hold, which is how the cursor blinks.
+ * 
+ * Each layer lights its cells at a fixed brightness. The brightness is split
+ * into two bit planes, and the LED matrix is refreshed here one column per
+ * tick with bit angle modulation within the column's slot: the high plane is
+ * shown for the first two thirds and the timer1 compare B interrupt switches
+ * to the low plane for the rest, giving four levels which all light once a
+ * frame, at 100 Hz. Host builds have no interrupts and show every lit cell
+ * for the whole slot. tinygl only refreshes the LED matrix while a scrolling
+ * message covers the layers.
  * 
  * @date   17/10/2024
  * @author Corey Hines
@@ -14,6 +30,28 @@
 #include <string.h>
 #include "screen.h"
 #include "game.h"   /* For PACER_RATE */
+#include "ledmat.h"
+
+#ifdef __AVR__
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include "timer.h"
+#endif
+
+/** @brief Every row of the LED matrix, as a mask of row bits. */
+#define SCREEN_ROWS_ALL ((uint8_t) ((1 << LEDMAT_ROWS_NUM) - 1))
+
+/** @brief Every layer, as a mask of layer bits. */
+#define SCREEN_LAYERS_ALL ((uint8_t) ((1 << SCREEN_LAYERS_NUM) - 1))
+
+/** @brief The brightness each layer lights its cells at, indexed by ScreenLayer_t. */
+static const uint8_t SCREEN_LAYER_LEVELS[SCREEN_LAYERS_NUM] = {
+    [SCREEN_LAYER_BOARD]  = SCREEN_LEVEL_FULL,
+    [SCREEN_LAYER_MISSES] = SCREEN_LEVEL_DIM,
+    [SCREEN_LAYER_HITS]   = SCREEN_LEVEL_FULL,
+    [SCREEN_LAYER_CURSOR] = SCREEN_LEVEL_MEDIUM,
+    [SCREEN_LAYER_TEXT]   = SCREEN_LEVEL_FULL,
+};
 
 /** @brief Number of ticks remaining for an active scrolling message. */
 static uint32_t scrolling_message_ticks = 0;
@@ -21,6 +59,62 @@ static uint32_t scrolling_message_ticks = 0;
 /** @brief Flag indicating if a scrolling message is active. */
 static bool scrolling_message_active = false;
 
+/** @brief Messages waiting for the active scrolling message to finish, oldest first. */
+static const char* scrolling_message_queue[SCREEN_MESSAGE_QUEUE_SIZE];
+
+/** @brief Number of messages waiting in the queue. */
+static uint8_t scrolling_message_queued = 0;
+
+/** @brief The cells set in each layer, packed like a predefined board. */
+static PredefinedBoard_t screen_layers[SCREEN_LAYERS_NUM];
+
+/** @brief The visible layers, bit n for layer n. */
+static uint8_t screen_layers_visible = SCREEN_LAYERS_ALL;
+
+/** @brief The composited brightness of each cell as two bit planes, packed like a predefined board. */
+static PredefinedBoard_t screen_shown[SCREEN_PLANES_NUM];
+
+/** @brief The composited bit planes by column for the LED matrix, bit n for row n. */
+static uint8_t screen_columns[SCREEN_PLANES_NUM][LEDMAT_COLS_NUM];
+
+/** @brief The column the next refresh drives. */
+static uint8_t screen_refresh_col = 0;
+
+#ifdef __AVR__
+/** @brief Timer counts the high plane is shown for, two thirds of a column's slot. */
+#define SCREEN_HIGH_PLANE_COUNTS ((timer_tick_t) (TIMER_RATE / PACER_RATE * 2 / 3))
+
+/** @brief The low plane of the column being refreshed, shown by the compare B interrupt. */
+static volatile uint8_t screen_low_pattern;
+
+/** @brief The column being refreshed. */
+static volatile uint8_t screen_low_col;
+
+/** @brief Flag indicating the low plane of the column is still to be shown. */
+static volatile bool screen_low_pending;
+
+/**
+ * @brief Timer1 compare B interrupt, switches the column being refreshed to its low plane.
+ */
+ISR(TIMER1_COMPB_vect)
+{
+    if (screen_low_pending)
+    {
+        screen_low_pending = false;
+        ledmat_display_column(screen_low_pattern, screen_low_col);
+    }
+}
+#endif
+
+/** @brief The cells which may need compositing again, packed like a predefined board. */
+static PredefinedBoard_t screen_dirty;
+
+/** @brief The rows holding dirty cells, bit n for row n. */
+static uint8_t screen_dirty_rows = 0;
+
+/** @brief The character to draw into the text layer once tinygl is free, '\0' for none. */
+static char screen_pending_char = '\0';
+
 /**
  * @brief Calculates the number of ticks required to scroll a message.
  * 
@@ -40,142 +134,423 @@ static uint32_t screen_calculate_scrolling_message_ticks(const char* text)
 }
 
 /**
- * @brief Calculates the number of ticks required to scroll a message.
+ * @brief Marks cells to be composited again by the next screen_update().
  * 
- * This function calculates the number of ticks required to scroll a message
- * based on the message length and the configured message rate.
+ * @param row The row of the cells.
+ * @param cells The cells of the row, packed like a predefined board row.
+ */
+static void screen_mark_dirty(uint8_t row, uint8_t cells)
+{
+    if (cells)
+    {
+        screen_dirty[row] |= cells;
+        screen_dirty_rows |= 1 << row;
+    }
+}
+
+/**
+ * @brief Marks every cell a layer has set to be composited again.
  * 
- * @param text The message text to be scrolled.
- * @return The calculated number of ticks for scrolling the message.
+ * @param layer The layer.
  */
-bool screen_scrolling_message_active(void)
+static void screen_mark_layer_dirty(ScreenLayer_t layer)
 {
-    return scrolling_message_active;
+    for (uint8_t row = 0; row < LEDMAT_ROWS_NUM; row++)
+    {
+        screen_mark_dirty(row, screen_layers[layer][row]);
+    }
 }
 
 /**
- * @brief Sets the scrolling message to be displayed on the screen.
+ * @brief Forgets what the LED matrix is showing, so every cell is composited again.
+ */
+static void screen_mark_all_dirty(void)
+{
+    memset(screen_shown, 0, sizeof(screen_shown));
+    memset(screen_columns, 0, sizeof(screen_columns));
+    memset(screen_dirty, BOARD_ROW_MASK, sizeof(screen_dirty));
+    screen_dirty_rows = SCREEN_ROWS_ALL;
+}
+
+/**
+ * @brief Draws the pending character into the text layer.
  * 
- * This function sets a new scrolling message to be displayed on the screen.
- * It clears the screen, calculates the required ticks, and initializes the
- * scrolling message display.
+ * tinygl owns the font, so the character is drawn into tinygl's display
+ * buffer and read back, then tinygl is cleared again.
+ */
+static void screen_draw_pending_char(void)
+{
+    tinygl_clear();
+    tinygl_draw_char(screen_pending_char, tinygl_point(0, 0));
+    for (tinygl_coord_t row = 0; row < LEDMAT_ROWS_NUM; row++)
+    {
+        uint8_t cells = 0;
+        for (tinygl_coord_t col = 0; col < LEDMAT_COLS_NUM; col++)
+        {
+            if (tinygl_pixel_get(tinygl_point(col, row)))
+            {
+                cells |= BOARD_COL_MASK(col);
+            }
+        }
+        screen_layers[SCREEN_LAYER_TEXT][row] = cells;
+    }
+    screen_pending_char = '\0';
+    tinygl_clear();
+    screen_mark_all_dirty();
+}
+
+/**
+ * @brief Composites a row of the layers, each layer owning the cells it has set.
  * 
- * @param text The message to be displayed.
+ * @param row The row to composite.
+ * @param planes Filled with the cells of each brightness bit plane which are on.
  */
-void screen_set_scrolling_text(const char* text)
+static void screen_composite_row(uint8_t row, uint8_t planes[SCREEN_PLANES_NUM])
+{
+    planes[0] = 0;
+    planes[1] = 0;
+    for (uint8_t layer = 0; layer < SCREEN_LAYERS_NUM; layer++)
+    {
+        uint8_t cells = screen_layers[layer][row];
+        uint8_t level = (screen_layers_visible & (1 << layer)) ? SCREEN_LAYER_LEVELS[layer] : SCREEN_LEVEL_OFF;
+        for (uint8_t plane = 0; plane < SCREEN_PLANES_NUM; plane++)
+        {
+            planes[plane] = (planes[plane] & ~cells) | ((level & (1 << plane)) ? cells : 0);
+        }
+    }
+}
+
+/**
+ * @brief Composites the dirty cells, updating only the column bits which changed.
+ */
+static void screen_composite(void)
+{
+    if (screen_pending_char != '\0')
+    {
+        screen_draw_pending_char();
+    }
+
+    for (uint8_t row = 0; screen_dirty_rows; row++)
+    {
+        if (!(screen_dirty_rows & (1 << row)))
+        {
+            continue;
+        }
+        screen_dirty_rows &= ~(1 << row);
+
+        uint8_t planes[SCREEN_PLANES_NUM];
+        screen_composite_row(row, planes);
+        for (uint8_t plane = 0; plane < SCREEN_PLANES_NUM; plane++)
+        {
+            uint8_t changed = (planes[plane] ^ screen_shown[plane][row]) & screen_dirty[row];
+            screen_shown[plane][row] ^= changed;
+
+            for (uint8_t col = 0; changed && col < LEDMAT_COLS_NUM; col++)
+            {
+                uint8_t mask = BOARD_COL_MASK(col);
+                if (changed & mask)
+                {
+                    screen_columns[plane][col] ^= 1 << row;
+                    changed &= ~mask;
+                }
+            }
+        }
+        screen_dirty[row] = 0;
+    }
+}
+
+/**
+ * @brief Drives the next column of the LED matrix with its high plane, then its low plane.
+ * 
+ * A cell at full brightness is lit for the whole of the column's slot,
+ * medium for two thirds of it and dim for the last third. The interrupt
+ * stays enabled between refreshes, it does nothing once the low plane has
+ * been shown, so only the game loop ever changes TIMSK1. The high plane is
+ * driven while the interrupt is held off, so the two never write the pins
+ * at once. The host stand-in is given both planes to count their thirds.
+ */
+static void screen_refresh(void)
+{
+    uint8_t col = screen_refresh_col;
+
+#ifdef __AVR__
+    screen_pins_hold();
+    ledmat_display_column(screen_columns[1][col], col);
+    screen_low_pattern = screen_columns[0][col];
+    screen_low_col = col;
+    screen_low_pending = true;
+    OCR1B = timer_get() + SCREEN_HIGH_PLANE_COUNTS;
+    TIFR1 = BIT(OCF1B);
+    screen_pins_release();
+#else
+    ledmat_host_display_planes(screen_columns[1][col], screen_columns[0][col], col);
+#endif
+
+    if (++screen_refresh_col == LEDMAT_COLS_NUM)
+    {
+        screen_refresh_col = 0;
+    }
+}
+
+/**
+ * @brief Starts scrolling a message over the layers.
+ * 
+ * @param text The message to be scrolled.
+ */
+static void screen_start_scrolling_message(const char* text)
 {
-    screen_clear();  // Clear the screen before setting a new message.
     scrolling_message_active = true;
     scrolling_message_ticks = screen_calculate_scrolling_message_ticks(text);
-    screen_init();  // Reinitialize to ensure clean state.
+    tinygl_clear();
     tinygl_text_mode_set(TINYGL_TEXT_MODE_SCROLL);
     tinygl_text(text);
 }
 
+/**
+ * @brief Checks if a scrolling message is currently active.
+ * 
+ * @return True if a scrolling message is active, false otherwise.
+ */
+bool screen_scrolling_message_active(void)
+{
+    return scrolling_message_active;
+}
+
+/**
+ * @brief Checks if the LED matrix is blank.
+ * 
+ * The LED matrix is blank when no scrolling message is active or queued and
+ * no layer has anything set.
+ * 
+ * @return True if the LED matrix is blank, false otherwise.
+ */
+bool screen_blank(void)
+{
+    if (scrolling_message_active || screen_pending_char != '\0')
+    {
+        return false;
+    }
+    for (uint8_t layer = 0; layer < SCREEN_LAYERS_NUM; layer++)
+    {
+        for (uint8_t row = 0; row < LEDMAT_ROWS_NUM; row++)
+        {
+            if (screen_layers[layer][row])
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Sets the scrolling message to be displayed on the screen.
+ * 
+ * This function clears the layers and scrolls the message over them. If a
+ * message is already scrolling the new one is queued and scrolls after it,
+ * leaving the layers as they are, since the game may have drawn on them
+ * since the message before was set. Messages arriving while the queue is
+ * full are dropped.
+ * 
+ * @param text The message to be displayed, it must stay valid until it has scrolled.
+ */
+void screen_set_scrolling_text(const char* text)
+{
+    if (!scrolling_message_active)
+    {
+        screen_clear();  // Clear the screen before setting a new message.
+        screen_start_scrolling_message(text);
+    }
+    else if (scrolling_message_queued < SCREEN_MESSAGE_QUEUE_SIZE)
+    {
+        scrolling_message_queue[scrolling_message_queued++] = text;
+    }
+}
+
 /**
  * @brief Displays a single character on the screen.
  * 
- * This function displays a single character on the screen in step mode.
+ * This function clears the layers and draws the character on the text layer
+ * the next time tinygl is free.
  * 
  * @param character The character to be displayed.
  */
 void screen_set_char(char character)
 {
-    char text[2] = {character, '\0'}; 
     screen_clear();
-    tinygl_text_mode_set(TINYGL_TEXT_MODE_STEP);
-    tinygl_text(text);
+    screen_pending_char = character;
 }
 
 /**
  * @brief Displays a predefined board layout on the LED matrix.
  * 
- * This function displays a predefined board layout on the LED matrix by iterating
- * through the rows and columns of the board and setting the corresponding pixels.
+ * This function clears the layers and copies the packed rows of the board
+ * into the board layer.
  * 
  * @param board A pointer to the predefined board structure.
  */
 void screen_set_predefined_board(const PredefinedBoard_t* board)
 {
     screen_clear();
-    for (tinygl_coord_t row = 0; row < LEDMAT_ROWS_NUM; row++)
+    screen_layer_set(SCREEN_LAYER_BOARD, board);
+}
+
+/**
+ * @brief Replaces every cell of a layer.
+ * 
+ * @param layer The layer to set.
+ * @param cells The cells to set, packed like a predefined board.
+ */
+void screen_layer_set(ScreenLayer_t layer, const PredefinedBoard_t* cells)
+{
+    for (uint8_t row = 0; row < LEDMAT_ROWS_NUM; row++)
     {
-        uint8_t row_data = (*board)[row];  // Get the packed row
-        for (tinygl_coord_t col = 0; col < LEDMAT_COLS_NUM; col++)
-        {
-            tinygl_point_t pos = {col, row};
-            // Extract each bit from the row (shift right and mask)
-            uint8_t pixel_on = (row_data >> (LEDMAT_COLS_NUM - 1 - col)) & 1;
-            tinygl_pixel_set(pos, pixel_on);
-        }
+        uint8_t row_cells = (*cells)[row] & BOARD_ROW_MASK;
+        screen_mark_dirty(row, screen_layers[layer][row] ^ row_cells);
+        screen_layers[layer][row] = row_cells;
     }
 }
 
 /**
- * @brief Sets a pixel on the LED matrix to the specified value.
+ * @brief Sets or clears a single cell of a layer.
+ * 
+ * @param layer The layer to change.
+ * @param col The column index of the cell.
+ * @param row The row index of the cell.
+ * @param value true to set the cell, false to clear it.
+ */
+void screen_layer_set_cell(ScreenLayer_t layer, uint8_t col, uint8_t row, bool value)
+{
+    uint8_t mask = BOARD_COL_MASK(col);
+    uint8_t cells = value ? screen_layers[layer][row] | mask : screen_layers[layer][row] & ~mask;
+
+    screen_mark_dirty(row, screen_layers[layer][row] ^ cells);
+    screen_layers[layer][row] = cells;
+}
+
+/**
+ * @brief Clears every cell of a layer.
  * 
- * This function sets a specific pixel on the LED matrix to the given value
- * (on or off).
+ * @param layer The layer to clear.
+ */
+void screen_layer_clear(ScreenLayer_t layer)
+{
+    screen_mark_layer_dirty(layer);
+    memset(screen_layers[layer], 0, sizeof(screen_layers[layer]));
+}
+
+/**
+ * @brief Shows or hides a layer, the cells a hidden layer has set are off.
  * 
- * @param col The column index of the pixel.
- * @param row The row index of the pixel.
- * @param value The pixel value (on or off).
+ * @param layer The layer to show or hide.
+ * @param visible true to show the layer, false to hide it.
  */
-void screen_set_pixel(uint8_t col, uint8_t row, tinygl_pixel_value_t value)
+void screen_layer_show(ScreenLayer_t layer, bool visible)
 {
-    tinygl_point_t pos = {col, row};
-    tinygl_pixel_set(pos, value);
+    uint8_t layers = visible ? screen_layers_visible | (1 << layer) : screen_layers_visible & ~(1 << layer);
+    if (layers != screen_layers_visible)
+    {
+        screen_layers_visible = layers;
+        screen_mark_layer_dirty(layer);
+    }
 }
 
 /**
  * @brief Updates the scrolling message display.
  * 
- * This function updates the state of the scrolling message display, decreasing
- * the tick count and checking if the message has finished scrolling.
+ * This function counts down the active scrolling message. Once it has
+ * finished the next queued message starts, or tinygl is cleared for the
+ * layers to be composited again. It must be called every tick.
  */
 void screen_scrolling_message_update(void)
 {
+    if (!scrolling_message_active)
+    {
+        return;
+    }
+
     if (scrolling_message_ticks > 0) {
         scrolling_message_ticks--;
+    } else if (scrolling_message_queued > 0) {
+        const char* text = scrolling_message_queue[0];
+        scrolling_message_queued--;
+        memmove(scrolling_message_queue, scrolling_message_queue + 1,
+                scrolling_message_queued * sizeof(scrolling_message_queue[0]));
+        screen_start_scrolling_message(text);
     } else {
-        scrolling_message_ticks = 0;
         scrolling_message_active = false;  // Ensure the message is no longer active once it finishes.
-        screen_clear();
+        tinygl_clear();
+        screen_mark_all_dirty();
     }
 }
 
+/**
+ * @brief Holds off the interrupt showing the low plane, call before the game loop writes a port pin.
+ */
+void screen_pins_hold(void)
+{
+#ifdef __AVR__
+    TIMSK1 &= ~BIT(OCIE1B);
+#endif
+}
+
+/**
+ * @brief Lets the interrupt showing the low plane run again, any compare missed while held runs now.
+ */
+void screen_pins_release(void)
+{
+#ifdef __AVR__
+    TIMSK1 |= BIT(OCIE1B);
+#endif
+}
+
 /**
  * @brief Updates the LED matrix display.
  * 
- * This function updates the LED matrix including the internal state of a scrolling
- * message which is handled in the tinygl module.
+ * This function composites any dirty cells of the layers and refreshes the
+ * next column of the LED matrix. While a scrolling message covers the
+ * layers, tinygl refreshes the LED matrix and scrolls the message instead.
  */
 void screen_update(void)
 {
-    tinygl_update();
+    if (scrolling_message_active)
+    {
+#ifdef __AVR__
+        screen_low_pending = false;
+#endif
+        tinygl_update();
+        return;
+    }
+    screen_composite();
+    screen_refresh();
 }
 
 /**
  * @brief Clears the LED matrix, removing all displayed content.
  * 
- * This function clears the LED matrix, removing any content that is currently
- * displayed.
+ * This function clears every layer and shows them all again, the LED matrix
+ * follows on the next screen_update().
  */
 void screen_clear(void)
 {
-    screen_init();
-    tinygl_clear();
+    for (uint8_t layer = 0; layer < SCREEN_LAYERS_NUM; layer++)
+    {
+        screen_layer_clear(layer);
+    }
+    screen_layers_visible = SCREEN_LAYERS_ALL;
+    screen_pending_char = '\0';
 }
 
 /**
- * @brief Clears the LED matrix, removing all displayed content.
+ * @brief Initializes the screen, setting up the tiny gl library and font settings.
  * 
- * This function clears the LED matrix, removing any content that is currently
- * displayed.
+ * This function is called once at start up, it clears the layers.
  */
 void screen_init(void)
 {
     tinygl_init(PACER_RATE);
     tinygl_font_set(&font5x7_1);
     tinygl_text_speed_set(MESSAGE_RATE);
+    screen_clear();
+    screen_mark_all_dirty();
 }
\ No newline at end of file
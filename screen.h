@@ -13,6 +13,7 @@
 #include "board.h"
 
 #define MESSAGE_RATE 20 // Characters to display every 10 seconds
+#define SCREEN_MESSAGE_QUEUE_SIZE 4 // Messages which can wait for the scrolling message to finish
 
 // LED states for the UCFK LED mat which is in an active low configuration
 #define PIXEL_ON 1  // Value representing a pixel that is turned on
@@ -22,6 +23,32 @@
 #define MESSAGE_MISS " MISS "       // Message displayed for a miss
 #define MESSAGE_WINNER " YOU WON! " // Message displayed when the player wins
 #define MESSAGE_LOSER " YOU LOST! " // Message displayed when the player loses
+#define MESSAGE_NO_ROOM " NO ROOM "   // Message displayed when the board editor has no room for the next ship
+#define MESSAGE_VERIFIED " BOARD OK "  // Message displayed when the opponent's revealed board matches
+#define MESSAGE_MISMATCH " BOARD MISMATCH "  // Message displayed when the opponent's revealed board does not match
+#define MESSAGE_LINK_LOST " LINK LOST "  // Message displayed when the opponent stops answering over IR
+
+#define SCREEN_LEVEL_OFF 0    // Brightness of an unlit cell
+#define SCREEN_LEVEL_DIM 1    // Brightness of a cell lit a third of the time
+#define SCREEN_LEVEL_MEDIUM 2 // Brightness of a cell lit two thirds of the time
+#define SCREEN_LEVEL_FULL 3   // Brightness of a cell lit all of the time
+#define SCREEN_PLANES_NUM 2   // Bit planes needed for the brightness levels
+
+/**
+ * @enum  ScreenLayer_t
+ * @brief The layers the screen is composited from, from the bottom to the top.
+ *
+ * Each layer lights its cells at a fixed brightness, so the state of a cell
+ * on their board is told apart by how bright it is.
+ */
+typedef enum {
+    SCREEN_LAYER_BOARD,  /**< Board previews, at full brightness. */
+    SCREEN_LAYER_MISSES, /**< The misses on their board, dim. */
+    SCREEN_LAYER_HITS,   /**< The hits on their board, at full brightness. */
+    SCREEN_LAYER_CURSOR, /**< The selected cell at medium brightness, hidden and shown to blink. */
+    SCREEN_LAYER_TEXT,   /**< A single character, at full brightness. */
+    SCREEN_LAYERS_NUM,   /**< Number of layers. */
+} ScreenLayer_t;
 
 /**
  * @brief Checks if a scrolling message is currently active.
@@ -30,10 +57,19 @@
 bool screen_scrolling_message_active(void);
 
 /**
- * @brief Updates the scrolling message display.
+ * @brief Updates the scrolling message display, this must be called every tick.
+ *
+ * The game keeps running while a message scrolls, what it draws is shown once
+ * the message and any queued after it have finished.
  */
 void screen_scrolling_message_update(void);
 
+/**
+ * @brief Checks if the LED matrix is blank, with no scrolling message and nothing drawn.
+ * @return True if the LED matrix is blank, false otherwise.
+ */
+bool screen_blank(void);
+
 /**
  * @brief Updates the LED matrix display. This should be called regularly to refresh the screen.
  */
@@ -50,8 +86,8 @@ void screen_clear(void);
 void screen_init(void);
 
 /**
- * @brief Sets the scrolling message to be displayed on the screen.
- * @param text The message to be displayed.
+ * @brief Sets the scrolling message to be displayed on the screen, queueing it if one is already scrolling.
+ * @param text The message to be displayed, it must stay valid until it has scrolled.
  */
 void screen_set_scrolling_text(const char* text);
 
@@ -68,11 +104,46 @@ void screen_set_char(char character);
 void screen_set_predefined_board(const PredefinedBoard_t* board);
 
 /**
- * @brief Sets a pixel on the LED matrix to the specified value.
- * @param col The column index of the pixel.
- * @param row The row index of the pixel.
- * @param value The pixel value (on or off).
+ * @brief Replaces every cell of a layer.
+ * @param layer The layer to set.
+ * @param cells The cells to set, packed like a predefined board.
+ */
+void screen_layer_set(ScreenLayer_t layer, const PredefinedBoard_t* cells);
+
+/**
+ * @brief Sets or clears a single cell of a layer.
+ * @param layer The layer to change.
+ * @param col The column index of the cell.
+ * @param row The row index of the cell.
+ * @param value true to set the cell, false to clear it.
+ */
+void screen_layer_set_cell(ScreenLayer_t layer, uint8_t col, uint8_t row, bool value);
+
+/**
+ * @brief Clears every cell of a layer.
+ * @param layer The layer to clear.
+ */
+void screen_layer_clear(ScreenLayer_t layer);
+
+/**
+ * @brief Shows or hides a layer, the cells a hidden layer has set are off.
+ * @param layer The layer to show or hide.
+ * @param visible true to show the layer, false to hide it.
+ */
+void screen_layer_show(ScreenLayer_t layer, bool visible);
+
+/**
+ * @brief Holds off the interrupt showing the low plane, call before the game loop writes a port pin.
+ *
+ * The interrupt drives the LED matrix pins with read-modify-writes of the
+ * ports, which would undo a write the game loop makes to another pin of the
+ * same port if it came between the read and the write.
+ */
+void screen_pins_hold(void);
+
+/**
+ * @brief Lets the interrupt showing the low plane run again, any compare missed while held runs now.
  */
-void screen_set_pixel(uint8_t col, uint8_t row, tinygl_pixel_value_t value);
+void screen_pins_release(void);
 
 #endif /* SCREEN_H */
\ No newline at end of file
@@ -6,6 +6,11 @@
  * of the Battleship game. It includes functions for selecting the player, receiving
  * the opponent's board, and choosing a board configuration during the game setup phase.
  *
+ * After the predefined boards, the player can choose a random board. Only its
+ * seed and fleet are revealed to the opponent, which generates the same board.
+ * The last choice opens the board editor, where the player places their own
+ * ships, see board_editor.h.
+ *
  * @date   17/10/2024
  * @author Corey Hines
  */
@@ -15,29 +20,48 @@
 #include "navigation_switch.h"
 #include "screen.h"
 #include "button.h"
-#include "ir.h"
+#include "opponent.h"
 #include "game_state.h"
 #include "board.h"
 #include "predefined_boards.h"
+#include "random_board.h"
+#include "board_editor.h"
+#include "commit.h"
 #include "game.h"
+#include "input_trace.h"
+#include "bench.h"
+
+/**
+ * @brief The characters shown for each choice of player, the last plays the computer.
+ */
+static const char PLAYER_CHOICES[] = {'1', '2', 'C'};
+
+#define PLAYER_CHOICES_NUM ((uint8_t) (sizeof(PLAYER_CHOICES) / sizeof(PLAYER_CHOICES[0])))
+#define PLAYER_CHOICE_COMPUTER (PLAYER_CHOICES_NUM - 1) // Index of the choice playing the computer
+
+/**
+ * @brief The character shown for the choice opening the board editor.
+ */
+#define BOARD_CHOICE_EDIT_CHAR 'E'
 
 /**
  * @brief Updates the player selection process.
  *
  * This function handles the logic for selecting the player (player 1 or player 2)
- * during the game setup phase. It updates the display to show the selected player
- * and changes the game state when a selection is made.
+ * or a game against the computer during the game setup phase. It updates the
+ * display to show the selected choice and changes the game state when a
+ * selection is made.
  */
 void update_select_player(void)
 {
     static bool initialised = false;
-    static bool player = 0;
+    static uint8_t choice = 0;
 
     if (!initialised)
     {
         initialised = true;
-        player = 0;
-        screen_set_char(player ? '2' : '1');
+        choice = 0;
+        screen_set_char(PLAYER_CHOICES[choice]);
     }
 
     button_update();
@@ -45,38 +69,50 @@ void update_select_player(void)
     switch (navigation_switch_get())
     {
         case DIR_EAST:
+            choice = choice == PLAYER_CHOICES_NUM - 1 ? 0 : choice + 1;
+            screen_set_char(PLAYER_CHOICES[choice]);
+            break;
         case DIR_WEST:
-            // there are only 2 players so we can just switch a boolean
-            // true is player 2, false is player 1
-            player = !player;
-            screen_set_char(player ? '2' : '1');
+            choice = choice == 0 ? PLAYER_CHOICES_NUM - 1 : choice - 1;
+            screen_set_char(PLAYER_CHOICES[choice]);
             break;
         default:
             break;
     }
-    if (button_push_event_p (0))
+    if (input_trace_button(button_push_event_p (0) || BENCH_INPUT_TAKE(BENCH_INPUT_BUTTON)))
     {
         set_game_state(GAME_STATE_CHOOSE_BOARD);
         initialised = false;
-        player_number = player ? 2 : 1;
+        // against the computer we always shoot first
+        player_number = choice == 1 ? 2 : 1;
+        if (choice == PLAYER_CHOICE_COMPUTER)
+        {
+            // forget a board another UCFK4 may have sent before the computer was chosen
+            board_release(their_board);
+            their_board = BOARD_HANDLE_NONE;
+            received_their_board = false;
+            opponent_select(OPPONENT_COMPUTER);
+        }
     }
 }
 
 /**
  * @brief Updates to check if the other player has sent their board.
  *
- * This function checks if the predefined board ID from the opponent has been received
- * via IR communication. If the board is received, it creates the opponent's board and
- * updates the game state accordingly.
+ * This function checks if the tag committing to the opponent's board has been received
+ * via IR communication or from the computer. Their board is not sent until the game
+ * ends, so once the tag is received their board starts empty and only fills in with
+ * the answers to our shots, see commit.h.
  */
 void update_receive_their_board(void)
 {
     if (!received_their_board)
     {
-        if (ir_get_their_predefined_board_id(&their_predefined_board_id))
+        if (commit_receive_their_board())
         {
+            PredefinedBoard_t empty = {0};
+            their_board = board_acquire(&empty);
             received_their_board = true;
-            their_board = create_board(PREDEFINED_BOARDS[their_predefined_board_id]);
         }
     } else if (sent_our_board) {
         // player 1 starts by sending a shot (selecting a shoot position initially)
@@ -85,50 +121,108 @@ void update_receive_their_board(void)
     }
 }
 
+/**
+ * @brief Shows a choice of board, a new random board each time the random choice is shown.
+ *
+ * @param board_num The choice, the predefined board ID, predefined_board_count() for a random
+ *                  board or one more for the board editor.
+ * @param random_board The random board to set when the random choice is shown.
+ */
+static void show_board_choice(uint8_t board_num, RandomBoard_t* random_board)
+{
+    PredefinedBoard_t layout;
+
+    if (board_num > predefined_board_count())
+    {
+        screen_set_char(BOARD_CHOICE_EDIT_CHAR);
+        return;
+    }
+    if (board_num == predefined_board_count())
+    {
+        random_board_choose(random_board, &layout);
+    }
+    else
+    {
+        predefined_board_read(board_num, &layout);
+    }
+    screen_set_predefined_board(&layout);
+}
+
 /**
  * @brief Updates the choose board process.
  *
  * This function handles the logic for the player selecting a board during the game setup phase.
  * It updates the display to show the selected predefined board and changes the game state when
- * a board is chosen.
+ * a board is chosen. After the predefined boards is a random board, pushing north or south
+ * on it shows another, and the last choice opens the board editor.
  */
 void update_choose_board(void)
 {
     static bool initialised = false;
     static uint8_t board_num = 0;
+    static RandomBoard_t random_board;
+    uint8_t num_boards = predefined_board_count();
+    PredefinedBoard_t layout;
 
     if (!initialised)
     {
-        screen_set_predefined_board(PREDEFINED_BOARDS[board_num]);
+        show_board_choice(board_num, &random_board);
         initialised = true;
     }
 
     button_update();
 
+    // the choices are the predefined boards, the random board then the board editor
     switch (navigation_switch_get())
     {
         case DIR_EAST:
-            board_num = board_num == 0 ? NUM_BOARDS - 1 : board_num - 1;
-            screen_set_predefined_board(PREDEFINED_BOARDS[board_num]);
+            board_num = board_num == 0 ? num_boards + 1 : board_num - 1;
+            show_board_choice(board_num, &random_board);
             break;
         case DIR_WEST:
-            board_num = board_num == NUM_BOARDS - 1 ? 0 : board_num + 1;
-            screen_set_predefined_board(PREDEFINED_BOARDS[board_num]);
+            board_num = board_num == num_boards + 1 ? 0 : board_num + 1;
+            show_board_choice(board_num, &random_board);
+            break;
+        case DIR_NORTH:
+        case DIR_SOUTH:
+            if (board_num == num_boards)
+            {
+                show_board_choice(board_num, &random_board);
+            }
             break;
         default:
             break;
     }
 
     // when the player pushes the button here, they confirm their board selection
-    if (button_push_event_p (0))
+    if (input_trace_button(button_push_event_p (0) || BENCH_INPUT_TAKE(BENCH_INPUT_BUTTON)))
     {
-        // setup our board and send the predefined board to the other board
-        our_board = create_board(PREDEFINED_BOARDS[board_num]);
-        our_predefined_board_id = board_num;
+        initialised = false;
+        if (board_num > num_boards)
+        {
+            // the editor sends our board once every ship is placed
+            set_game_state(GAME_STATE_EDIT_BOARD);
+            return;
+        }
+
+        // setup our board and commit to it, the predefined board or the random board's
+        // seed is only sent to the other board once the game ends
+        CommitReveal_t reveal = {.id = board_num};
         set_game_state(GAME_STATE_AWAIT_BOARD_EXCHANGE);
-        ir_send_our_predefined_board_id(our_predefined_board_id);
+        if (board_num == num_boards)
+        {
+            random_board_generate(&random_board, &layout);
+            reveal.id = RANDOM_BOARD_ID;
+            reveal.random_board = random_board;
+        }
+        else
+        {
+            predefined_board_read(board_num, &layout);
+        }
+        our_board = board_acquire(&layout);
+        our_predefined_board_id = reveal.id;
+        commit_send_our_board(&layout, &reveal);
         
         sent_our_board = true;
-        initialised = false;
     }
 }
\ No newline at end of file